@@ -14,6 +14,7 @@ struct AgentStateConfig;
 struct ModelConfig;
 class Visualiser;
 class LockHolder;
+class RateLimiter;
 
 /**
  * This class forms the interface between FLAMEGPU2 and FLAMEGPU2_Visualiser
@@ -47,6 +48,17 @@ class FLAMEGPU_Visualisation {
     void updateDynamicLine(const std::string &graph_name) {
         updateDynamicLine(graph_name.c_str());
     }
+    /**
+     * Appends points to the end of a line stream, only the new points are uploaded
+     * @param stream_name Name of the line stream, as found in ModelConfig::line_streams
+     * @param vertices 3 floats per point
+     * @param colors 4 floats per point
+     * @param count The number of points
+     * @note lockDynamicLinesMutex() should be called before this
+     */
+    void appendLineStream(const std::string &stream_name, const float *vertices, const float *colors, unsigned int count) {
+        appendLineStream(stream_name.c_str(), vertices, colors, count);
+    }
     /**
      * Provide an environment property, so it can be displayed
      */
@@ -60,6 +72,18 @@ class FLAMEGPU_Visualisation {
      * Provide the random seed, so it can be displayed in the debug menu
      */
     void setRandomSeed(uint64_t randomSeed);
+    /**
+     * Change the swap interval of the visualisation window at runtime
+     * @param interval 1 (vsync), 0 (off) or -1 (adaptive vsync)
+     * @see ModelConfig::swapInterval
+     */
+    void setSwapInterval(int interval);
+    /**
+     * Change the maximum number of frames rendered per second at runtime
+     * @param fps The frame rate limit, 0 is treated as unlimited
+     * @see ModelConfig::frameRateLimit
+     */
+    void setFrameRateLimit(unsigned int fps);
     /*
      * Start visualiser in background thread
      */
@@ -93,16 +117,16 @@ class FLAMEGPU_Visualisation {
     void updateAgentStateBuffer(const char *agent_name, const char *state_name, const unsigned int buffLen,
         const std::map<TexBufferConfig::Function, TexBufferConfig>& core_tex_buffers, const std::multimap<TexBufferConfig::Function, CustomTexBufferConfig>& tex_buffers);
     void updateDynamicLine(const char* graph_name);
+    void appendLineStream(const char *stream_name, const float *vertices, const float *colors, unsigned int count);
 
     Visualiser *vis = nullptr;
     LockHolder *lock = nullptr;
     LockHolder *dynamic_lines_lock = nullptr;
     /**
-     * If non-0, limits the number of simulation steps per second, by blocking the return of releaseMutex
+     * If set, limits the number of simulation steps per second, by blocking the return of releaseMutex
      * Blocking whilst the mutex was held, would block visualisation updates as that also uses the mutex
-     * The actual value is the number of ms per step
      */
-    unsigned int step_ms;
+    RateLimiter *step_limiter = nullptr;
 };
 
 
@@ -5,6 +5,7 @@
 #include <cstring>
 #include <cstdio>
 #include <map>
+#include <vector>
 
 #include "TexBufferConfig.h"
 
@@ -27,12 +28,34 @@ struct AgentStateConfig {
      * If set, model is treated as 2-frame animated
      */
     const char *model_pathB = nullptr;
+    /**
+     * If 2 or more paths are provided, model is treated as N-frame animated
+     * Each model provides one keyframe, they must share model_path's topology (the same faces, in the same order)
+     * Keyframes are selected per agent via TexBufferConfig::AnimationFrame, model_pathB is ignored
+     */
+    std::vector<std::string> model_keyframes;
     const char *model_texture = nullptr;
     float model_scale[3];
     /**
      * If provided, this code will be appended to the vertex shader to provide color customisation
      */
     std::string color_shader_src;
+    /**
+     * If non-0, each agent's last trail_length positions are drawn as a trail behind it
+     * Trails are captured each time the agent state's buffers are updated
+     * @note Defaults to 0 (disabled)
+     */
+    unsigned int trail_length = 0;
+    /**
+     * Color of the most recent end of each trail
+     * @note Defaults to white
+     */
+    float trail_color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    /**
+     * Exponent of the fall off of a trail's alpha towards its oldest end, 0 disables fading
+     * @note Defaults to 1 (linear)
+     */
+    float trail_fade = 1.0f;
 
     std::multimap<TexBufferConfig::Function, CustomTexBufferConfig> tex_buffers;
 
@@ -27,6 +27,17 @@ struct LineConfig {
      */
     std::vector<float> colors;
 };
+/**
+ * Represents a user defined polyline, which is extended a few points at a time (e.g. a plot of a per-step metric)
+ * Only the most recent capacity points are retained, older points are overwritten
+ */
+struct LineStreamConfig {
+    explicit LineStreamConfig(unsigned int capacity) : capacity(capacity) { }
+    /**
+     * The maximum number of points rendered, must be at least 2
+     */
+    const unsigned int capacity;
+};
 
 }  // namespace visualiser
 }  // namespace flamegpu
@@ -5,6 +5,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <vector>
 #include <cstdio>
 
 #include "LineConfig.h"
@@ -51,6 +52,33 @@ struct ModelConfig {
          * [3] Radians
          */
         float rotation[4];
+        /**
+         * Placement of a single instance of a static model
+         */
+        struct Instance {
+            Instance();
+            /**
+             * Translation to be applied to the instance
+             */
+            float location[3];
+            /**
+             * Rotation to be applied to the instance
+             * [0-2] Axis of rotation
+             * [3] Angle, in the same units as StaticModel::rotation
+             */
+            float rotation[4];
+            /**
+             * Multiplier applied to the model's scale
+             * @note Defaults to (1,1,1)
+             */
+            float scale[3];
+        };
+        /**
+         * Optional placements of the model
+         * If any are provided, the model is drawn once per instance with a single instanced draw call, rather than once
+         * Each instance's transform is applied after the model's own scale, rotation and location
+         */
+        std::vector<Instance> instances;
     };
     explicit ModelConfig(const char *windowTitle);
     ~ModelConfig();
@@ -134,6 +162,10 @@ struct ModelConfig {
      * Store of user defined graph renderings
      */
     std::map<std::string, std::shared_ptr<LineConfig>> dynamic_lines;
+    /**
+     * Store of user defined append-only line renderings
+     */
+    std::map<std::string, std::shared_ptr<LineStreamConfig>> line_streams;
     /**
      * Store of user defined UI panels
      */
@@ -153,6 +185,53 @@ struct ModelConfig {
      * This var tracks the level of zoom
      */
     float orthoZoom = 1.0f;
+    /**
+     * If true, loaded models have their triangles and vertices reordered to reduce vertex cache misses and overdraw
+     * The mean cache miss ratio (ACMR) of the optimised models, before and after optimisation, is shown in the debug menu (F1)
+     * @note Defaults to false
+     */
+    bool optimiseModels = false;
+    /**
+     * If true, model vertex attributes are uploaded in packed formats, roughly halving vertex fetch bandwidth
+     * Positions and texture coordinates are stored as half floats, so this may visibly reduce the precision of models
+     * whose vertices lie far from their origin
+     * @note Defaults to false
+     */
+    bool packModelVertices = false;
+    /**
+     * If true, the host copies of model geometry are freed once uploaded to the GPU
+     * They are restored on demand if required (e.g. to export a model), host memory use is shown in the debug menu
+     * @note Defaults to false
+     */
+    bool releaseModelGeometry = false;
+    /**
+     * If true, frames are only drawn when something has changed, rather than continuously at the display's refresh rate
+     * e.g. new agent data or lines, camera movement, window or UI input
+     * This greatly reduces CPU and GPU use whilst the simulation is paused or finished
+     * @note Defaults to false
+     */
+    bool idleRendering = false;
+    /**
+     * When idleRendering is enabled, the maximum time in milliseconds between frames, so that the HUD remains current
+     * A value of 0 disables the heartbeat
+     * @note Defaults to 1000
+     */
+    unsigned int idleHeartbeat = 1000;
+    /**
+     * The swap interval of the window
+     * 1 waits for vertical sync, 0 presents immediately (uncapped), -1 is adaptive (late frames are presented immediately)
+     * If adaptive vsync is not supported by the driver, 1 is used instead
+     * This can be cycled at runtime with F7
+     * @note Defaults to 1
+     */
+    int swapInterval = 1;
+    /**
+     * The maximum number of frames to render per second, independent of swapInterval
+     * This can be used to leave CPU and GPU time for the simulation, it can be cycled at runtime with F6
+     * A value of 0 is treated as unlimited
+     * @note Defaults to 0 (unlimited)
+     */
+    unsigned int frameRateLimit = 0;
 
  private:
      /**
@@ -7,6 +7,17 @@ namespace Stock {
 namespace Models {
 /**
  * Path to model file and optional texture within integrated resources
+ *
+ * Paths of the form "primitive:<shape>[:<detail>[:<detail>]]" are generated in memory at load, rather than read from file
+ *   - sphere[:slices[:stacks]] (default 32:16)
+ *   - icosphere[:subdivisions] (default 1)
+ *   - cube
+ *   - cylinder[:segments] (default 32)
+ *   - cone[:segments] (default 32)
+ *   - arrow[:segments] (default 16)
+ *   - quad
+ *   - disc[:segments] (default 32)
+ * Lower details produce cheaper models, e.g. "primitive:sphere:8:4" for large populations of small agents
  */
 struct Model {
     const char *modelPath;
@@ -15,15 +26,62 @@ struct Model {
 /**
  * Slices and segments sphere
  */
-const Model SPHERE{ "resources/sphere.obj", "" };
+const Model SPHERE{ "primitive:sphere:32:16", "" };
 /*
  * Sphere constructed from triangles
  */
-const Model ICOSPHERE{ "resources/icosphere.obj", "" };
+const Model ICOSPHERE{ "primitive:icosphere:1", "" };
+/**
+ * Icosahedron (20 poly, 12 vertices), the cheapest approximation of a sphere
+ */
+const Model ICOSAHEDRON{ "primitive:icosphere:0", "" };
 /**
  * Cube
+ *
+ * Each face has its own 4 vertices and normal (24 vertices), so faces are flat shaded
+ * @note Prior to primitive models this was resources/cube.obj, which shares 8 vertices between faces so is smooth shaded, see CUBE_SMOOTH
+ */
+const Model CUBE{ "primitive:cube", "" };
+/**
+ * Cube with 8 vertices shared between faces, each with a diagonal normal, so it appears smooth shaded
+ */
+const Model CUBE_SMOOTH{ "resources/cube.obj", "" };
+/**
+ * Cylinder
+ *
+ * Orientation:
+ *   - Axis: X
+ */
+const Model CYLINDER{ "primitive:cylinder:32", "" };
+/**
+ * Cone
+ *
+ * Orientation:
+ *   - Front (apex): +X
+ */
+const Model CONE{ "primitive:cone:32", "" };
+/**
+ * Arrow with a cylindrical shaft and conical head
+ * useful for visualising vectors
+ *
+ * Orientation:
+ *   - Front: +X
+ */
+const Model ARROW{ "primitive:arrow:16", "" };
+/**
+ * Flat square
+ *
+ * Orientation:
+ *   - Front: +Z
+ */
+const Model QUAD{ "primitive:quad", "" };
+/**
+ * Flat circle
+ *
+ * Orientation:
+ *   - Front: +Z
  */
-const Model CUBE{ "resources/cube.obj", "" };
+const Model DISC{ "primitive:disc:32", "" };
 /**
  * Traditional (sealed) Utah Teapot
  */
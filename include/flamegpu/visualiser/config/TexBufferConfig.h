@@ -52,6 +52,12 @@ struct TexBufferConfig {
          * Keyframe animation lerp variable
          */
         AnimationLerp,
+        /**
+         * Keyframe animation position, for models with more than 2 keyframes
+         * The integer part selects the keyframe, the fractional part blends towards the following keyframe
+         * Values wrap, so incrementing the value by a constant each step loops the animation
+         */
+        AnimationFrame,
         /**
          * Some other use, e.g. custom shaders in future
          */
@@ -85,6 +91,7 @@ struct TexBufferConfig {
         case Scale_xyz: return "_scale_xyz";
         case UniformScale: return "_scale";
         case AnimationLerp: return "_animation_lerp";
+        case AnimationFrame: return "_animation_frame";
         // These always get name from elsewhere so return empty string
         case Color:
         case Unknown:
@@ -121,6 +128,7 @@ struct TexBufferConfig {
         case Scale_z:
         case UniformScale:
         case AnimationLerp:
+        case AnimationFrame:
         case Color:
         case Unknown:
         default:
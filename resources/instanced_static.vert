@@ -0,0 +1,37 @@
+#version 430
+
+uniform mat4 _projectionMat;
+uniform mat4 _viewMat;
+uniform mat4 _modelMat;
+
+in vec3 _vertex;
+in vec3 _normal;
+in vec2 _texCoords;
+
+out vec3 eyeVertex;
+out vec3 eyeNormal;
+out vec2 texCoords;
+
+// World transform of each instance, uploaded once when the static model is created
+// The normal matrix is of the combined instance and model matrices, precomputed (and padded to mat4) to avoid an inverse per vertex
+struct _StaticInstance {
+  mat4 modelMat;
+  mat4 normalMat;
+};
+layout(std430) readonly buffer _staticInstances {
+  _StaticInstance _instances[];
+};
+
+void main()
+{
+  // Apply the model matrix, then the instance's transform
+  vec4 vert = _instances[gl_InstanceID].modelMat * (_modelMat * vec4(_vertex, 1.0f));
+  // Calculate eye vertex
+  eyeVertex = (_viewMat * vert).xyz;
+  // Calculate frag vertex
+  gl_Position = _projectionMat * vec4(eyeVertex, 1.0f);
+  // The view matrix is rigid, so it is its own normal matrix
+  eyeNormal = normalize(mat3(_viewMat) * mat3(_instances[gl_InstanceID].normalMat) * normalize(_normal));
+  // Calc tex coords
+  texCoords = _texCoords;
+}
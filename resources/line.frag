@@ -0,0 +1,16 @@
+#version 430
+
+in vec4 color;
+noperspective in float edgeDistance;
+noperspective in float halfWidth;
+
+out vec4 fragColor;
+
+void main()
+{
+  // Analytic anti-aliasing, coverage falls off over the pixel either side of the line's edge
+  const float coverage = clamp(halfWidth + 0.5f - abs(edgeDistance), 0.0f, 1.0f);
+  if (coverage <= 0.0f)
+    discard;
+  fragColor = vec4(color.rgb, color.a * coverage);
+}
@@ -0,0 +1,17 @@
+#version 430
+
+uniform mat4 _modelViewProjectionMat;
+
+in vec3 _vertex;
+in vec4 _color;
+in float _width;
+
+out vec4 vColor;
+out float vWidth;
+
+void main()
+{
+  gl_Position = _modelViewProjectionMat * vec4(_vertex, 1.0f);
+  vColor = _color;
+  vWidth = _width;
+}
@@ -0,0 +1,23 @@
+#version 430
+
+uniform mat4 _projectionMat;
+uniform mat4 _viewMat;
+uniform uint _trailLength;
+uniform uint _trailHead;
+uniform vec4 _trailColor;
+uniform float _trailFade;
+
+layout(std430) readonly buffer _trail {
+  vec4 _positions[];
+};
+
+out vec4 color;
+
+void main()
+{
+  // Each instance is an agent, vertices step back in time from its most recent position
+  const uint age = uint(gl_VertexID);
+  const uint slot = (_trailHead + _trailLength - age) % _trailLength;
+  gl_Position = _projectionMat * _viewMat * _positions[uint(gl_InstanceID) * _trailLength + slot];
+  color = vec4(_trailColor.rgb, _trailColor.a * pow(1.0f - float(age) / float(_trailLength), _trailFade));
+}
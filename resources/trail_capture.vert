@@ -0,0 +1,25 @@
+#version 430
+
+uniform uint _trailLength;
+uniform uint _trailHead;
+uniform uint _trailSeedFrom;
+
+// The last _trailLength positions of each agent, a ring indexed by _trailHead
+layout(std430) buffer _trail {
+  vec4 _positions[];
+};
+
+vec3 getPosition();
+void main()
+{
+  const vec4 pos = vec4(getPosition(), 1.0f);
+  const uint base = uint(gl_InstanceID) * _trailLength;
+  if (uint(gl_InstanceID) >= _trailSeedFrom) {
+    // New agent, so it has no history to draw from
+    for (uint i = 0; i < _trailLength; ++i)
+      _positions[base + i] = pos;
+  } else {
+    _positions[base + _trailHead] = pos;
+  }
+  gl_Position = vec4(0.0f);
+}
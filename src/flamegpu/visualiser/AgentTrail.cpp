@@ -0,0 +1,92 @@
+#include "flamegpu/visualiser/AgentTrail.h"
+
+#include <algorithm>
+#include <string>
+
+namespace flamegpu {
+namespace visualiser {
+
+AgentTrail::AgentTrail(const std::string &positionSrc, const unsigned int _length, const glm::vec4 &_color, const float _fade)
+    : captureShaders(std::make_shared<Shaders>("resources/trail_capture.vert", "", "", positionSrc))
+    , renderShaders(std::make_shared<Shaders>("resources/trail.vert", "resources/color_noshade.frag"))
+    , positions(nullptr)
+    , length(_length)
+    , head(0)
+    , seedFrom(0)
+    , agentCapacity(0)
+    , agentCount(0)
+    , color(_color)
+    , fade(_fade) {
+    if (length < 2) {
+        THROW VisAssert("AgentTrail::AgentTrail(): Trails require a length of at least 2 positions.\n");
+    }
+    for (auto &s : { captureShaders, renderShaders }) {
+        s->addDynamicUniform("_trailLength", &length);
+        s->addDynamicUniform("_trailHead", &head);
+    }
+    captureShaders->addDynamicUniform("_trailSeedFrom", &seedFrom);
+    renderShaders->addDynamicUniform("_trailColor", &color[0], 4);
+    renderShaders->addDynamicUniform("_trailFade", &fade);
+}
+void AgentTrail::resize(const unsigned int _agentCapacity) {
+    const size_t bytes = static_cast<size_t>(_agentCapacity) * length * sizeof(glm::vec4);
+    if (!positions) {
+        positions = std::make_shared<ShaderStorageBuffer>(bytes);
+        captureShaders->addBuffer("_trail", positions);
+        renderShaders->addBuffer("_trail", positions);
+    } else {
+        positions->setData(nullptr, bytes);
+    }
+    agentCapacity = _agentCapacity;
+    agentCount = 0;
+    seedFrom = 0;
+}
+void AgentTrail::addPositionTexture(const std::string &samplerName, const GLuint textureName, const GLuint textureUnit) {
+    captureShaders->addTexture(samplerName.c_str(), GL_TEXTURE_BUFFER, textureName, textureUnit);
+}
+void AgentTrail::removePositionTexture(const std::string &samplerName) {
+    captureShaders->removeTextureUniform(samplerName.c_str());
+}
+/*
+Draws a point per agent with rasterization disabled, the capture shader writes each agent's position to its ring
+*/
+void AgentTrail::capture(const unsigned int _agentCount) {
+    if (!positions || !_agentCount)
+        return;
+    agentCount = std::min(_agentCount, agentCapacity);
+    head = (head + 1) % length;
+    captureShaders->useProgram();
+    GL_CALL(glEnable(GL_RASTERIZER_DISCARD));
+    GL_CALL(glDrawArraysInstanced(GL_POINTS, 0, 1, agentCount));
+    GL_CALL(glDisable(GL_RASTERIZER_DISCARD));
+    captureShaders->clearProgram();
+    // Make the writes visible to the render shader
+    GL_CALL(glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT));
+    seedFrom = agentCount;
+}
+/*
+Draws a line strip of length vertices per agent, each vertex fetches its position from the agent's ring
+*/
+void AgentTrail::render() {
+    if (!positions || !agentCount)
+        return;
+    renderShaders->useProgram();
+    GL_CALL(glDrawArraysInstanced(GL_LINE_STRIP, 0, length, agentCount));
+    renderShaders->clearProgram();
+}
+void AgentTrail::reload() {
+    captureShaders->reload();
+    renderShaders->reload();
+}
+void AgentTrail::setViewMatPtr(glm::mat4 const *viewMat) {
+    renderShaders->setViewMatPtr(viewMat);
+}
+void AgentTrail::setProjectionMatPtr(glm::mat4 const *projectionMat) {
+    renderShaders->setProjectionMatPtr(projectionMat);
+}
+void AgentTrail::setLightsBuffer(const GLuint &/*bufferBindingPoint*/) {
+    // Trails are unlit
+}
+
+}  // namespace visualiser
+}  // namespace flamegpu
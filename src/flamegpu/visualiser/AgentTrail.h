@@ -0,0 +1,89 @@
+#ifndef SRC_FLAMEGPU_VISUALISER_AGENTTRAIL_H_
+#define SRC_FLAMEGPU_VISUALISER_AGENTTRAIL_H_
+
+#include <memory>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "flamegpu/visualiser/interface/Renderable.h"
+#include "flamegpu/visualiser/shader/Shaders.h"
+#include "flamegpu/visualiser/shader/buffer/ShaderStorageBuffer.h"
+
+namespace flamegpu {
+namespace visualiser {
+
+/**
+ * The recent positions of each agent of an agent state, drawn as a line strip per agent
+ * Positions are captured on the GPU from the agent state's position texture buffers into a ring buffer of the last N
+ * positions per agent, so trails never round trip through the host
+ * @note Trails follow an agent's index within the position buffers, if agents are reordered (e.g. by birth/death) the
+ * affected trails will jump
+ */
+class AgentTrail : public Renderable {
+ public:
+    /**
+     * Creates the capture and render shaders, buffers are not allocated until resize()
+     * @param positionSrc Shader source defining getPosition(), as generated by PositionFunction
+     * @param length The number of positions retained per agent, must be at least 2
+     * @param color Color of the most recent end of each trail
+     * @param fade Exponent applied to the fall off of alpha along each trail, 0 disables fading and 1 fades linearly
+     */
+    AgentTrail(const std::string &positionSrc, unsigned int length, const glm::vec4 &color, float fade);
+    /**
+     * Reallocates storage for the provided number of agents
+     * Existing trails are discarded, each agent's trail restarts from its next captured position
+     * @param agentCapacity The maximum number of agents which may be captured
+     */
+    void resize(unsigned int agentCapacity);
+    /**
+     * Binds a position texture buffer to the capture shader
+     * @param samplerName Name of the sampler, as returned by TexBufferConfig::SamplerName()
+     * @param textureName GL name of the texture buffer
+     * @param textureUnit Texture unit the texture buffer is bound to
+     */
+    void addPositionTexture(const std::string &samplerName, GLuint textureName, GLuint textureUnit);
+    /**
+     * Unbinds a position texture buffer from the capture shader, prior to it being replaced
+     */
+    void removePositionTexture(const std::string &samplerName);
+    /**
+     * Appends each agent's current position to its trail
+     * Agents which were not present in the previous capture have their whole trail set to their current position
+     * @param agentCount The number of agents in the position buffers
+     */
+    void capture(unsigned int agentCount);
+    /**
+     * Draws the trails of the most recently captured agents
+     */
+    void render();
+    void reload() override;
+    void setViewMatPtr(glm::mat4 const *viewMat) override;
+    using Renderable::setViewMatPtr;
+    void setProjectionMatPtr(glm::mat4 const *projectionMat) override;
+    using Renderable::setProjectionMatPtr;
+    void setLightsBuffer(const GLuint &bufferBindingPoint) override;
+    using Renderable::setLightsBuffer;
+
+ private:
+    std::shared_ptr<Shaders> captureShaders;
+    std::shared_ptr<Shaders> renderShaders;
+    /**
+     * length positions per agent, stored as vec4 to match std430 layout
+     */
+    std::shared_ptr<ShaderStorageBuffer> positions;
+    GLuint length;
+    // Slot within each agent's ring holding the most recent position
+    GLuint head;
+    // Agents at or beyond this index are seeded by the next capture
+    GLuint seedFrom;
+    unsigned int agentCapacity;
+    unsigned int agentCount;
+    glm::vec4 color;
+    float fade;
+};
+
+}  // namespace visualiser
+}  // namespace flamegpu
+
+#endif  // SRC_FLAMEGPU_VISUALISER_AGENTTRAIL_H_
@@ -1,8 +1,12 @@
 #include "Draw.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
 #include <stdexcept>
 #include <utility>
 #include <string>
+#include <vector>
 
 #include "flamegpu/visualiser/util/StringUtils.h"
 
@@ -11,43 +15,101 @@ namespace visualiser {
 
 const unsigned int Draw::DEFAULT_INITIAL_VBO_LENGTH = 1024;
 const float Draw::STORAGE_MUTLIPLIER = 2.0f;
+const unsigned int Draw::LOD_MIN_VERTICES = 1024;
+const float Draw::LOD_VERTICES_PER_PIXEL = 2.0f;
+namespace {
+/**
+ * Largest-Triangle-Three-Buckets downsampling of a polyline, generalised to 3D
+ * The first and last vertices are kept, the remainder are split into outCount - 2 buckets
+ * From each bucket, the vertex forming the largest triangle with the previously kept vertex and the mean of the next bucket is kept
+ */
+void downsampleLTTB(const glm::vec3 *inVertices, const glm::vec4 *inColors, const unsigned int inCount,
+    glm::vec3 *outVertices, glm::vec4 *outColors, const unsigned int outCount) {
+    const uint64_t buckets = outCount - 2;
+    const uint64_t span = inCount - 2;
+    outVertices[0] = inVertices[0];
+    outColors[0] = inColors[0];
+    unsigned int a = 0;
+    for (uint64_t i = 0; i < buckets; ++i) {
+        const unsigned int start = static_cast<unsigned int>(1 + i * span / buckets);
+        const unsigned int end = static_cast<unsigned int>(1 + (i + 1) * span / buckets);
+        // The final bucket is followed by the last vertex
+        const unsigned int nextEnd = static_cast<unsigned int>(std::min<uint64_t>(1 + (i + 2) * span / buckets, inCount));
+        glm::vec3 mean(0.0f);
+        for (unsigned int j = end; j < nextEnd; ++j)
+            mean += inVertices[j];
+        mean /= static_cast<float>(nextEnd - end);
+        float bestArea = -1.0f;
+        unsigned int best = start;
+        for (unsigned int j = start; j < end; ++j) {
+            const float area = glm::length(glm::cross(inVertices[j] - inVertices[a], mean - inVertices[a]));
+            if (area > bestArea) {
+                bestArea = area;
+                best = j;
+            }
+        }
+        outVertices[i + 1] = inVertices[best];
+        outColors[i + 1] = inColors[best];
+        a = best;
+    }
+    outVertices[outCount - 1] = inVertices[inCount - 1];
+    outColors[outCount - 1] = inColors[inCount - 1];
+}
+}  // namespace
 Draw::Draw(const unsigned int &bufferLength, const glm::vec4 &initialColor, const float &initialWidth)
     : tName()
     , tColor(initialColor)
     , tWidth(initialWidth)
     , tType()
     , shaders(std::make_shared<Shaders>(Stock::Shaders::COLOR_NOSHADE))
+    , lineShaders(std::make_shared<Shaders>(Stock::Shaders::LINE))
     , vertices(GL_FLOAT, 3, sizeof(float))
     , colors(GL_FLOAT, 4, sizeof(float))
-    , vboLen(bufferLength == 0 ? DEFAULT_INITIAL_VBO_LENGTH : bufferLength)
-    , vboOffset(0)
-    , requiredLength(0) {
+    , widths(GL_FLOAT, 1, sizeof(float))
+    , allocator(bufferLength == 0 ? DEFAULT_INITIAL_VBO_LENGTH : bufferLength)
+    , requiredLength(0)
+    , autoCompact(true) {
     visassert(STORAGE_MUTLIPLIER > 1.0f);
+    const unsigned int vboLen = allocator.getLength();
     // Vertices vbo
-    unsigned int vboSize = DEFAULT_INITIAL_VBO_LENGTH * sizeof(glm::vec3);
+    unsigned int vboSize = vboLen * sizeof(glm::vec3);
     GL_CALL(glGenBuffers(1, &vertices.vbo));
     GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vertices.vbo));
     GL_CALL(glBufferData(GL_ARRAY_BUFFER, vboSize, nullptr, GL_STATIC_DRAW));
     GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
     // Colors vbo
-    unsigned int cvboSize = DEFAULT_INITIAL_VBO_LENGTH * sizeof(glm::vec4);
+    unsigned int cvboSize = vboLen * sizeof(glm::vec4);
     GL_CALL(glGenBuffers(1, &colors.vbo));
     GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, colors.vbo));
     GL_CALL(glBufferData(GL_ARRAY_BUFFER, cvboSize, nullptr, GL_STATIC_DRAW));
     GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    // Widths vbo
+    unsigned int wvboSize = vboLen * sizeof(float);
+    GL_CALL(glGenBuffers(1, &widths.vbo));
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, widths.vbo));
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, wvboSize, nullptr, GL_STATIC_DRAW));
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
 
-    vertices.count = DEFAULT_INITIAL_VBO_LENGTH;
+    vertices.count = vboLen;
     vertices.data = nullptr;
 
-    colors.count = DEFAULT_INITIAL_VBO_LENGTH;
+    colors.count = vboLen;
     colors.data = nullptr;
 
+    widths.count = vboLen;
+    widths.data = nullptr;
+
     shaders->setPositionsAttributeDetail(vertices, false);
     shaders->setColorsAttributeDetail(colors);
+    lineShaders->setPositionsAttributeDetail(vertices, false);
+    lineShaders->setColorsAttributeDetail(colors, false);
+    lineShaders->addGenericAttributeDetail("_width", widths);
+    lineShaders->addDynamicUniform("_viewportSize", &viewportSize[0], 2);
 }
 Draw::~Draw() {
     GL_CALL(glDeleteBuffers(1, &vertices.vbo));
     GL_CALL(glDeleteBuffers(1, &colors.vbo));
+    GL_CALL(glDeleteBuffers(1, &widths.vbo));
 }
 void Draw::begin(Type type, const std::string &name) {
     if (isDrawing) {
@@ -85,13 +147,12 @@ void Draw::save(bool replaceExisting) {
         if (!replaceExisting) {
             THROW VisAssert("Draw::save(): Overwriting draw states must be an explicit action, use Draw::save(true).\n");
         } else {
-            vboGaps.push_back({ f->second.offset, f->second.count });
-            requiredLength -= f->second.count;
+            release(f->second);
             stateDirectory.erase(tName);
         }
     }
-    requiredLength += tState.count;
     stateDirectory.insert({ tName, std::move(tState) });
+    batchesDirty = true;
 }
 bool Draw::has(const std::string &name) {
     return stateDirectory.find(name) != stateDirectory.end();
@@ -101,54 +162,29 @@ Draw::State Draw::_save(bool isTemporary) {
         THROW VisAssert("Draw::_save(): Line drawings require an even number of vertices.\n");
     }
     visassert(tVertices.size() == tColors.size());
-    // Select the smallest gap which is big enough
-    unsigned int best = UINT_MAX;
-    unsigned int bestCt = UINT_MAX;
-    for (unsigned int i = 0; i < vboGaps.size(); ++i) {
-        unsigned int count = std::get<1>(vboGaps[i]);
-        if (count > tVertices.size()) {
-            if (bestCt < count)
-                continue;
-            best = i;
-            bestCt = count;
-        }
-    }
-    // If we found a suitable gap
-    unsigned int bufferPos;
-    if (best < vboGaps.size()) {  // We shall use a gap, so remove it from gap list
-        unsigned int offset = std::get<0>(vboGaps[best]);
-        bufferPos = offset;
-        if (!isTemporary) {
-            unsigned int count = std::get<1>(vboGaps[best]);
-            vboGaps.erase(vboGaps.begin() + best);
-            if (count >tVertices.size()) {  // Add remainder of gap back to gap list
-                vboGaps.push_back({ offset + static_cast<unsigned int>(tVertices.size()), count - static_cast<unsigned int>(tVertices.size()) });
-            }
-        }
-    } else {  // No suitable gap, resize buffer
-        if (vboOffset + tVertices.size() > vboLen) {
-            // Resize buffer
-            unsigned int newLen = vboLen;
-            while (requiredLength + tVertices.size() > newLen) {
-                newLen = static_cast<unsigned int>(newLen * STORAGE_MUTLIPLIER);
-            }
-            resize(newLen);
-        }
-        bufferPos = vboOffset;
-        vboOffset += static_cast<unsigned int>(tVertices.size());
-    }
+    const unsigned int count = static_cast<unsigned int>(tVertices.size());
     // Close and package draw state
     State rtn;
-    rtn.count = static_cast<unsigned int>(tVertices.size());
-    rtn.offset = bufferPos;
+    rtn.count = count;
     rtn.mType = tType;
     rtn.mWidth = tWidth;
+    std::vector<glm::vec3> lodVertices;
+    std::vector<glm::vec4> lodColors;
+    if (isTemporary) {
+        // Temporary states are rendered immediately, so their space can be reused by the next drawing
+        rtn.footprint = count;
+        rtn.offset = allocate(count);
+        allocator.release(rtn.offset, count);
+    } else {
+        buildLods(rtn, tVertices.data(), tColors.data(), lodVertices, lodColors);
+        rtn.offset = allocate(rtn.footprint);
+        requiredLength += rtn.footprint;
+    }
     // Fill VBO
-    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vertices.vbo));
-    GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, bufferPos*sizeof(glm::vec3), rtn.count*sizeof(glm::vec3), tVertices.data()));
-    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, colors.vbo));
-    GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, bufferPos*sizeof(glm::vec4), rtn.count*sizeof(glm::vec4), tColors.data()));
-    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    upload(rtn.offset, tVertices.data(), tColors.data(), count);
+    if (!lodVertices.empty())
+        upload(rtn.offset + count, lodVertices.data(), lodColors.data(), static_cast<unsigned int>(lodVertices.size()));
+    fillWidth(rtn.offset, rtn.footprint, rtn.mWidth);
     // Clear temporary structures
     tVertices.clear();
     tColors.clear();
@@ -156,6 +192,171 @@ Draw::State Draw::_save(bool isTemporary) {
     // Return
     return rtn;
 }
+void Draw::saveArrays(const std::string &name, const Type type, const float *_vertices, const float *_colors, const unsigned int count, const bool replaceExisting) {
+    if (isDrawing) {
+        THROW VisAssert("Draw::saveArrays() cannot be called whilst the draw state is open.\n");
+    }
+    if (name.empty()) {
+        THROW VisAssert("Draw::saveArrays() cannot be called to save anonymous draw states.\n");
+    }
+    if (type == Type::Lines && count % 2 != 0) {
+        THROW VisAssert("Draw::saveArrays(): Line drawings require an even number of vertices.\n");
+    }
+    auto f = stateDirectory.find(name);
+    if (f != stateDirectory.end() && !replaceExisting) {
+        THROW VisAssert("Draw::saveArrays(): Overwriting draw states must be an explicit action, use Draw::saveArrays(..., true).\n");
+    }
+    const glm::vec3 *v = reinterpret_cast<const glm::vec3*>(_vertices);
+    const glm::vec4 *c = reinterpret_cast<const glm::vec4*>(_colors);
+    State tState;
+    tState.count = count;
+    tState.mType = type;
+    tState.mWidth = tWidth;
+    std::vector<glm::vec3> lodVertices;
+    std::vector<glm::vec4> lodColors;
+    buildLods(tState, v, c, lodVertices, lodColors);
+    if (f != stateDirectory.end()) {
+        if (f->second.footprint == tState.footprint) {
+            // Same length, so overwrite the existing range in place
+            tState.offset = f->second.offset;
+        } else {
+            release(f->second);
+            stateDirectory.erase(f);
+            f = stateDirectory.end();
+        }
+    }
+    if (f == stateDirectory.end()) {
+        tState.offset = allocate(tState.footprint);
+        requiredLength += tState.footprint;
+    }
+    upload(tState.offset, v, c, count);
+    if (!lodVertices.empty())
+        upload(tState.offset + count, lodVertices.data(), lodColors.data(), static_cast<unsigned int>(lodVertices.size()));
+    fillWidth(tState.offset, tState.footprint, tState.mWidth);
+    if (f != stateDirectory.end())
+        f->second = std::move(tState);
+    else
+        stateDirectory.insert({ name, std::move(tState) });
+    batchesDirty = true;
+}
+/*
+Long polylines are given levels of detail, each downsampled to half the vertices of the previous
+The levels are stored after the full resolution vertices, within the same range of the vbo
+*/
+void Draw::buildLods(State &s, const glm::vec3 *_vertices, const glm::vec4 *_colors, std::vector<glm::vec3> &lodVertices, std::vector<glm::vec4> &lodColors) const {
+    s.footprint = s.count;
+    s.lods.clear();
+    lodVertices.clear();
+    lodColors.clear();
+    if (s.mType != Type::Polyline || s.count < 2 * LOD_MIN_VERTICES)
+        return;
+    s.boundsMin = glm::vec3(FLT_MAX);
+    s.boundsMax = glm::vec3(-FLT_MAX);
+    for (unsigned int i = 0; i < s.count; ++i) {
+        s.boundsMin = glm::min(s.boundsMin, _vertices[i]);
+        s.boundsMax = glm::max(s.boundsMax, _vertices[i]);
+    }
+    size_t total = 0;
+    for (unsigned int n = s.count / 2; n >= LOD_MIN_VERTICES; n /= 2)
+        total += n;
+    lodVertices.resize(total);
+    lodColors.resize(total);
+    const glm::vec3 *inVertices = _vertices;
+    const glm::vec4 *inColors = _colors;
+    unsigned int inCount = s.count;
+    unsigned int offset = 0;
+    for (unsigned int n = s.count / 2; n >= LOD_MIN_VERTICES; n /= 2) {
+        downsampleLTTB(inVertices, inColors, inCount, &lodVertices[offset], &lodColors[offset], n);
+        s.lods.push_back({ s.count + offset, n });
+        inVertices = &lodVertices[offset];
+        inColors = &lodColors[offset];
+        inCount = n;
+        offset += n;
+    }
+    s.footprint = s.count + static_cast<unsigned int>(total);
+}
+void Draw::release(const State &s) {
+    allocator.release(s.offset, s.footprint);
+    requiredLength -= s.footprint;
+}
+void Draw::createStream(const std::string &name, const unsigned int capacity) {
+    if (capacity < 2) {
+        THROW VisAssert("Draw::createStream(): Streams require a capacity of at least 2 points.\n");
+    }
+    if (streamDirectory.find(name) != streamDirectory.end()) {
+        THROW VisAssert("Draw::createStream(): Stream '%s' already exists.\n", name.c_str());
+    }
+    Stream s;
+    s.range.count = capacity + 1;
+    s.range.footprint = s.range.count;
+    s.range.offset = allocate(s.range.footprint);
+    s.range.mType = Type::Polyline;
+    s.range.mWidth = tWidth;
+    s.capacity = capacity;
+    s.size = 0;
+    s.head = 0;
+    requiredLength += s.range.footprint;
+    fillWidth(s.range.offset, s.range.footprint, s.range.mWidth);
+    streamDirectory.insert({ name, std::move(s) });
+}
+void Draw::appendStream(const std::string &name, const float *_vertices, const float *_colors, unsigned int count) {
+    auto f = streamDirectory.find(name);
+    if (f == streamDirectory.end()) {
+        THROW VisAssert("Draw::appendStream(): Stream '%s' was not found.\n", name.c_str());
+    }
+    Stream &s = f->second;
+    // Points which would be overwritten by this same append are skipped
+    if (count > s.capacity) {
+        _vertices += (count - s.capacity) * 3;
+        _colors += (count - s.capacity) * 4;
+        count = s.capacity;
+    }
+    for (unsigned int done = 0; done < count;) {
+        // Write up to the end of the ring
+        const unsigned int n = std::min(count - done, s.capacity - s.head);
+        upload(s.range.offset + s.head, _vertices + done * 3, _colors + done * 4, n);
+        if (s.head == 0)
+            upload(s.range.offset + s.capacity, _vertices + done * 3, _colors + done * 4, 1);
+        s.head = (s.head + n) % s.capacity;
+        done += n;
+    }
+    s.size = std::min(s.size + count, s.capacity);
+}
+unsigned int Draw::allocate(const unsigned int count) {
+    // Select the smallest gap which is big enough
+    unsigned int bufferPos = allocator.allocate(count);
+    if (bufferPos == RangeAllocator::INVALID) {
+        const unsigned int vboLen = allocator.getLength();
+        if (autoCompact && allocator.getFreeCount() >= count + vboLen / 4) {
+            // Enough space is free, but it is fragmented
+            resize(vboLen);
+        } else {
+            // Resize buffer
+            unsigned int newLen = vboLen;
+            do {
+                newLen = static_cast<unsigned int>(newLen * STORAGE_MUTLIPLIER);
+            } while (requiredLength + count > newLen);
+            resize(newLen);
+        }
+        bufferPos = allocator.allocate(count);
+        visassert(bufferPos != RangeAllocator::INVALID);
+    }
+    return bufferPos;
+}
+void Draw::upload(const unsigned int offset, const void *_vertices, const void *_colors, const unsigned int count) {
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vertices.vbo));
+    GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, offset*sizeof(glm::vec3), count*sizeof(glm::vec3), _vertices));
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, colors.vbo));
+    GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, offset*sizeof(glm::vec4), count*sizeof(glm::vec4), _colors));
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+void Draw::fillWidth(const unsigned int offset, const unsigned int count, const float width) {
+    if (!count)
+        return;
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, widths.vbo));
+    GL_CALL(glClearBufferSubData(GL_ARRAY_BUFFER, GL_R32F, offset*sizeof(float), count*sizeof(float), GL_RED, GL_FLOAT, &width));
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
 void Draw::render(const std::string &name) {
     auto f = stateDirectory.find(name);
     if (f == stateDirectory.end()) {
@@ -163,13 +364,154 @@ void Draw::render(const std::string &name) {
     }
     render(f->second);
 }
-void Draw::render(const State &state) const {
+void Draw::render(const State &state) {
+    GLint first = static_cast<GLint>(state.offset);
+    GLsizei count = static_cast<GLsizei>(state.count);
+    updateViewport();
+    glm::mat4 viewProjection;
+    if (!state.lods.empty() && getViewProjection(viewProjection))
+        selectLod(state, viewProjection, viewportSize * 0.5f, first, count);
+    const std::shared_ptr<Shaders> &s = getShaders(state.mType);
     setWidth(state.mType, state.mWidth);
-    shaders->useProgram();
-    GL_CALL(glDrawArrays(toGL(state.mType), state.offset, state.count));
-    shaders->clearProgram();
+    s->useProgram();
+    GL_CALL(glDrawArrays(toGL(state.mType), first, count));
+    s->clearProgram();
     clearWidth(state.mType);
 }
+void Draw::renderAll() {
+    if (batchesDirty)
+        buildBatches();
+    if (batches.empty() && streamDirectory.empty())
+        return;
+    updateViewport();
+    glm::mat4 viewProjection;
+    const glm::vec2 halfViewport = viewportSize * 0.5f;
+    const bool canSelectLod = hasLods && getViewProjection(viewProjection);
+    // Batches are sorted by type, so each program is bound once
+    Shaders *active = nullptr;
+    for (Batch &b : batches) {
+        // Refresh the range drawn of states with levels of detail, as the view may have changed
+        for (size_t i = 0; i < b.states.size(); ++i) {
+            const State &s = *b.states[i];
+            if (s.lods.empty())
+                continue;
+            b.first[i] = static_cast<GLint>(s.offset);
+            b.count[i] = static_cast<GLsizei>(s.count);
+            if (canSelectLod)
+                selectLod(s, viewProjection, halfViewport, b.first[i], b.count[i]);
+        }
+        Shaders *s = getShaders(b.mType).get();
+        if (s != active) {
+            if (active)
+                active->clearProgram();
+            s->useProgram();
+            active = s;
+        }
+        setWidth(b.mType, b.mWidth);
+        GL_CALL(glMultiDrawArrays(toGL(b.mType), b.first.data(), b.count.data(), static_cast<GLsizei>(b.first.size())));
+    }
+    for (const auto &[_, s] : streamDirectory) {
+        if (s.size < 2)
+            continue;
+        GLint first[2];
+        GLsizei count[2];
+        GLsizei draws = 1;
+        if (s.size < s.capacity || s.head == 0) {
+            // Oldest point is in slot 0
+            first[0] = static_cast<GLint>(s.range.offset);
+            count[0] = static_cast<GLsizei>(s.size);
+        } else {
+            // Oldest point is at head, the first strip ends with the mirror of slot 0 so it meets the second
+            first[0] = static_cast<GLint>(s.range.offset + s.head);
+            count[0] = static_cast<GLsizei>(s.capacity - s.head + 1);
+            first[1] = static_cast<GLint>(s.range.offset);
+            count[1] = static_cast<GLsizei>(s.head);
+            draws = 2;
+        }
+        if (active != lineShaders.get()) {
+            if (active)
+                active->clearProgram();
+            lineShaders->useProgram();
+            active = lineShaders.get();
+        }
+        GL_CALL(glMultiDrawArrays(toGL(s.range.mType), first, count, draws));
+    }
+    if (active)
+        active->clearProgram();
+    clearWidth(Type::Points);
+}
+/*
+Groups the saved draw states by type (and width, for points), so each group can be drawn with a single glMultiDrawArrays()
+Line widths are per vertex, so lines of all widths share a group
+Within a group, states are ordered by their offset into the vbo
+*/
+void Draw::buildBatches() {
+    std::vector<const State*> order;
+    order.reserve(stateDirectory.size());
+    for (const auto &a : stateDirectory)
+        if (a.second.count)
+            order.push_back(&a.second);
+    std::sort(order.begin(), order.end(), [](const State *a, const State *b) {
+        if (a->mType != b->mType)
+            return a->mType < b->mType;
+        if (a->mType == Type::Points && a->mWidth != b->mWidth)
+            return a->mWidth < b->mWidth;
+        return a->offset < b->offset;
+    });
+    batches.clear();
+    hasLods = false;
+    for (const State *s : order) {
+        if (batches.empty() || batches.back().mType != s->mType || (s->mType == Type::Points && batches.back().mWidth != s->mWidth))
+            batches.push_back(Batch{ s->mType, s->mWidth, {}, {}, {} });
+        batches.back().first.push_back(static_cast<GLint>(s->offset));
+        batches.back().count.push_back(static_cast<GLsizei>(s->count));
+        batches.back().states.push_back(s);
+        hasLods |= !s->lods.empty();
+    }
+    batchesDirty = false;
+}
+bool Draw::getViewProjection(glm::mat4 &viewProjection) const {
+    if (!viewMatPtr || !projectionMatPtr)
+        return false;
+    viewProjection = *projectionMatPtr * *viewMatPtr;
+    return true;
+}
+void Draw::updateViewport() {
+    GLint viewport[4];
+    GL_CALL(glGetIntegerv(GL_VIEWPORT, viewport));
+    viewportSize = glm::vec2(viewport[2], viewport[3]);
+}
+std::shared_ptr<Shaders> &Draw::getShaders(const Type &t) {
+    return t == Type::Points ? shaders : lineShaders;
+}
+/*
+Selects the coarsest level of detail with enough vertices for the screen space extent of the state's bounds
+The full resolution is used if the bounds cross the camera plane
+*/
+void Draw::selectLod(const State &s, const glm::mat4 &viewProjection, const glm::vec2 &halfViewport, GLint &first, GLsizei &count) {
+    glm::vec2 lo(FLT_MAX), hi(-FLT_MAX);
+    for (int i = 0; i < 8; ++i) {
+        const glm::vec3 corner((i & 1) ? s.boundsMax.x : s.boundsMin.x, (i & 2) ? s.boundsMax.y : s.boundsMin.y, (i & 4) ? s.boundsMax.z : s.boundsMin.z);
+        const glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+        if (clip.w <= 0.0f)
+            return;
+        const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+        lo = glm::min(lo, ndc);
+        hi = glm::max(hi, ndc);
+    }
+    // Only the visible portion of the bounds requires detail
+    lo = glm::clamp(lo, glm::vec2(-1.0f), glm::vec2(1.0f));
+    hi = glm::clamp(hi, glm::vec2(-1.0f), glm::vec2(1.0f));
+    const glm::vec2 pixels = (hi - lo) * halfViewport;
+    const float target = (pixels.x + pixels.y) * LOD_VERTICES_PER_PIXEL;
+    for (auto l = s.lods.rbegin(); l != s.lods.rend(); ++l) {
+        if (static_cast<float>(l->count) >= target) {
+            first = static_cast<GLint>(s.offset + l->offset);
+            count = static_cast<GLsizei>(l->count);
+            return;
+        }
+    }
+}
 GLenum Draw::toGL(const Type &t) {
     if (t == Type::Lines) {
         return GL_LINES;
@@ -181,10 +523,8 @@ GLenum Draw::toGL(const Type &t) {
     THROW VisAssert("Draw::toGL(): Unexpected Type pased to Draw::toGL()\n");
 }
 void Draw::setWidth(const Type &t, const float &w) {
-    if (t == Type::Lines) {
-        GL_CALL(glLineWidth(w));
-    } else if (t == Type::Polyline) {
-        GL_CALL(glLineWidth(w));
+    if (t == Type::Lines || t == Type::Polyline) {
+        // Line width is a vertex attribute, applied by the line geometry shader
     } else if (t == Type::Points) {
         GL_CALL(glPointSize(w));
     } else {
@@ -192,10 +532,8 @@ void Draw::setWidth(const Type &t, const float &w) {
     }
 }
 void Draw::clearWidth(const Type &t) {
-    if (t == Type::Lines) {
-        GL_CALL(glLineWidth(1.0f));
-    } else if (t == Type::Polyline) {
-        GL_CALL(glLineWidth(1.0f));
+    if (t == Type::Lines || t == Type::Polyline) {
+        // Line width is a vertex attribute, so there is nothing to reset
     } else if (t == Type::Points) {
         GL_CALL(glPointSize(1.0f));
     } else {
@@ -203,14 +541,14 @@ void Draw::clearWidth(const Type &t) {
     }
 }
 void Draw::resize(unsigned int newLength) {
-    if (newLength <= requiredLength) {
-        THROW VisAssert("Draw::resize(): New length (%u) must exceed the required length (%u)\n", newLength, requiredLength);
+    if (newLength < requiredLength) {
+        THROW VisAssert("Draw::resize(): New length (%u) must not be less than the required length (%u)\n", newLength, requiredLength);
     }
     /**
-    * Allocate new vbos of double size
+    * Allocate new vbos
     */
     // Vertices vbo
-    GLuint _vbo = 0, _cvbo = 0;
+    GLuint _vbo = 0, _cvbo = 0, _wvbo = 0;
     unsigned int vboSize = newLength * sizeof(glm::vec3);
     GL_CALL(glGenBuffers(1, &_vbo));
     GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, _vbo));
@@ -222,61 +560,88 @@ void Draw::resize(unsigned int newLength) {
     GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, _cvbo));
     GL_CALL(glBufferData(GL_ARRAY_BUFFER, cvboSize, nullptr, GL_STATIC_DRAW));
     GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-    /**
-    * Copy back data
-    */
-    unsigned int _vboSize = vboLen * sizeof(glm::vec3);
-    unsigned int _cvboSize = vboLen * sizeof(glm::vec4);
-    glm::vec3 *_vertices = reinterpret_cast<glm::vec3 *>(malloc(_vboSize));
-    glm::vec4 *_colors = reinterpret_cast<glm::vec4 *>(malloc(_cvboSize));
-    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vertices.vbo));
-    GL_CALL(glGetBufferSubData(GL_ARRAY_BUFFER, 0, _vboSize, _vertices));
-    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, colors.vbo));
-    GL_CALL(glGetBufferSubData(GL_ARRAY_BUFFER, 0, _cvboSize, _colors));
+    // Widths vbo
+    unsigned int wvboSize = newLength * sizeof(float);
+    GL_CALL(glGenBuffers(1, &_wvbo));
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, _wvbo));
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, wvboSize, nullptr, GL_STATIC_DRAW));
     GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-    unsigned int _offset = 0;
     /**
     * Defragment from old into new
+    * States are visited in vbo order, so that runs of adjacent states are copied with a single call
     */
-    for (auto &a : stateDirectory) {
-        // Copy back to vbo
-        GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, _vbo));
-        GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, _offset*sizeof(glm::vec3), a.second.count*sizeof(glm::vec3), &_vertices[a.second.offset]));
-        GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, _cvbo));
-        GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, _offset*sizeof(glm::vec4), a.second.count*sizeof(glm::vec4), &_colors[a.second.offset]));
-        a.second.offset = _offset;
-        _offset += a.second.count;
+    std::vector<State*> order;
+    order.reserve(stateDirectory.size() + streamDirectory.size());
+    for (auto &a : stateDirectory)
+        order.push_back(&a.second);
+    for (auto &a : streamDirectory)
+        order.push_back(&a.second.range);
+    std::sort(order.begin(), order.end(), [](const State *a, const State *b) { return a->offset < b->offset; });
+    unsigned int _offset = 0;
+    for (size_t i = 0; i < order.size();) {
+        const unsigned int srcOffset = order[i]->offset;
+        const unsigned int dstOffset = _offset;
+        unsigned int runEnd = srcOffset;
+        for (; i < order.size() && order[i]->offset == runEnd; ++i) {
+            runEnd += order[i]->footprint;
+            order[i]->offset = _offset;
+            _offset += order[i]->footprint;
+        }
+        const unsigned int runCount = runEnd - srcOffset;
+        if (!runCount)
+            continue;
+        GL_CALL(glBindBuffer(GL_COPY_READ_BUFFER, vertices.vbo));
+        GL_CALL(glBindBuffer(GL_COPY_WRITE_BUFFER, _vbo));
+        GL_CALL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset * sizeof(glm::vec3), dstOffset * sizeof(glm::vec3), runCount * sizeof(glm::vec3)));
+        GL_CALL(glBindBuffer(GL_COPY_READ_BUFFER, colors.vbo));
+        GL_CALL(glBindBuffer(GL_COPY_WRITE_BUFFER, _cvbo));
+        GL_CALL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset * sizeof(glm::vec4), dstOffset * sizeof(glm::vec4), runCount * sizeof(glm::vec4)));
+        GL_CALL(glBindBuffer(GL_COPY_READ_BUFFER, widths.vbo));
+        GL_CALL(glBindBuffer(GL_COPY_WRITE_BUFFER, _wvbo));
+        GL_CALL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset * sizeof(float), dstOffset * sizeof(float), runCount * sizeof(float)));
     }
+    GL_CALL(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+    GL_CALL(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
     if (_offset != requiredLength) {
         THROW VisAssert("Draw::resize(): _offset (%u) != requiredLength (%u)\n", _offset, requiredLength);
     }
-    vboOffset = _offset;
-    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-    free(_vertices);
-    free(_colors);
-    vboGaps.clear();
+    allocator.reset(newLength, _offset);
+    batchesDirty = true;
     /**
     * Delete and replace old vbos
     */
     GL_CALL(glDeleteBuffers(1, &vertices.vbo));
     GL_CALL(glDeleteBuffers(1, &colors.vbo));
+    GL_CALL(glDeleteBuffers(1, &widths.vbo));
     vertices.vbo = _vbo;
     colors.vbo = _cvbo;
+    widths.vbo = _wvbo;
+    vertices.count = newLength;
+    colors.count = newLength;
+    widths.count = newLength;
     shaders->setPositionsAttributeDetail(vertices, false);
     shaders->setColorsAttributeDetail(colors);
-    vboLen = newLength;
+    lineShaders->setPositionsAttributeDetail(vertices, false);
+    lineShaders->setColorsAttributeDetail(colors, false);
+    lineShaders->addGenericAttributeDetail("_width", widths);
 }
 void Draw::reload() {
     shaders->reload();
+    lineShaders->reload();
 }
 void Draw::setViewMatPtr(glm::mat4 const *viewMat) {
+    viewMatPtr = viewMat;
     shaders->setViewMatPtr(viewMat);
+    lineShaders->setViewMatPtr(viewMat);
 }
 void Draw::setProjectionMatPtr(glm::mat4 const *projectionMat) {
+    projectionMatPtr = projectionMat;
     shaders->setProjectionMatPtr(projectionMat);
+    lineShaders->setProjectionMatPtr(projectionMat);
 }
 void Draw::setLightsBuffer(const GLuint &bufferBindingPoint) {
     shaders->setLightsBuffer(bufferBindingPoint);
+    lineShaders->setLightsBuffer(bufferBindingPoint);
 }
 
 }  // namespace visualiser
@@ -9,6 +9,7 @@
 
 #include "flamegpu/visualiser/interface/Renderable.h"
 #include "flamegpu/visualiser/shader/Shaders.h"
+#include "flamegpu/visualiser/util/RangeAllocator.h"
 
 namespace flamegpu {
 namespace visualiser {
@@ -30,10 +31,20 @@ class Draw : Renderable {
      * Holds information required to draw primitive point/line structures
      */
     struct State {
+        /**
+         * A reduced level of detail of a polyline
+         */
+        struct Level {
+            unsigned int offset;  // Offset from the state's offset (in vertices)
+            unsigned int count;   // Number of vertices
+        };
         Type mType;    // Drawing type (point, line, polyline)
         unsigned int count;    // Number of vertices
         unsigned int offset;  // Offset into the vbo (in vertices)
         float mWidth;        // Pen width
+        unsigned int footprint;  // Number of vertices reserved in the vbo, count plus those of any levels of detail
+        std::vector<Level> lods;  // Levels of detail, from finest to coarsest, empty if the state has none
+        glm::vec3 boundsMin, boundsMax;  // Bounds of the vertices, only set if the state has levels of detail
     };
 
  public:
@@ -68,15 +79,55 @@ class Draw : Renderable {
      * @throw Throws a runtime exception if called whilst the draw state is not open
      */
     void save(bool replaceExisting = false);
+    /**
+     * Saves a named draw state directly from arrays, rather than via begin(), vertex() and save()
+     * The arrays are uploaded straight into the draw state's range of the vbo, without intermediate copies
+     * The current width is used, colors set by color() are ignored
+     * @param name Name of the draw state
+     * @param type Type of drawing
+     * @param vertices 3 floats per vertex
+     * @param colors 4 floats per vertex
+     * @param count The number of vertices
+     * @param replaceExisting Explicitly confirms intention to overwrite existing draw state
+     * If the existing draw state has the same number of vertices, its range of the vbo is overwritten in place
+     * @throw Throws a runtime exception if called whilst the draw state is open
+     */
+    void saveArrays(const std::string &name, Type type, const float *vertices, const float *colors, unsigned int count, bool replaceExisting = false);
+    /**
+     * Creates a named polyline stream, a ring buffer within the vbo which points are appended to
+     * Once full, each appended point overwrites the oldest point, so updates cost only the points appended
+     * The current width is used
+     * @param name Name of the stream
+     * @param capacity The maximum number of points retained
+     * @throw Throws a runtime exception if a stream with the name already exists, or capacity is less than 2
+     */
+    void createStream(const std::string &name, unsigned int capacity);
+    /**
+     * Appends points to the end of a stream
+     * @param name Name of the stream
+     * @param vertices 3 floats per point
+     * @param colors 4 floats per point
+     * @param count The number of points, if this exceeds the stream's capacity only the last points are kept
+     * @throw Throws a runtime exception if the stream does not exist
+     */
+    void appendStream(const std::string &name, const float *vertices, const float *colors, unsigned int count);
     /**
      * Check whether a drawing with the name exists.
      **/
     bool has(const std::string &name);
     /**
      * Renders a saved drawstate
+     * Polylines of at least 2 * LOD_MIN_VERTICES vertices are drawn at the coarsest level of detail adequate for their size on screen
      * @param name The name of the draw state to render
      */
     void render(const std::string &name);
+    /**
+     * Renders every saved draw state and stream
+     * States sharing a type (and width, for points) are drawn together with a single glMultiDrawArrays()
+     * Lines are drawn as anti-aliased screen space quads, so lines of any width are drawn together
+     * @note The order in which states are drawn is not defined
+     */
+    void renderAll();
     /**
      * Reloads the shader
      */
@@ -96,6 +147,16 @@ class Draw : Renderable {
      * @param bufferBindingPoint Set the buffer binding point to be used for rendering
      */
     void setLightsBuffer(const GLuint &bufferBindingPoint) override;
+    /**
+     * Enables compacting the vbo in place when it is too fragmented to fit a new drawing, rather than growing it
+     * Compaction is only performed if it would leave at least a quarter of the vbo free, otherwise the vbo grows
+     * @note Defaults to true
+     */
+    void setAutoCompact(const bool compact) { autoCompact = compact; }
+    /**
+     * Moves all saved draw states to the start of the vbo, removing gaps between them
+     */
+    void defragment() { resize(allocator.getLength()); }
     /**
      * Sets the width to use for the current drawing
      * The last value set before end() or save() will be taken
@@ -158,31 +219,115 @@ class Draw : Renderable {
  private:
     /**
      * Resizes the vbo to newLength and defragments the old data
+     * Draw states are copied on the device with glCopyBufferSubData(), contiguous states are copied together
      * @param newLength The number of vertices the vbo can support
      */
     void resize(unsigned int newLength);
-    /*
-     * Unused, defragments vbo to remove gaps
+    /**
+     * Reserves a range of the vbo, compacting or resizing the vbo if no gap is large enough
+     * @param count The number of vertices required
+     * @return The offset of the range (in vertices)
      */
-    void defragment() { resize(vboLen); }
-    /*
-     * Unused, compacts vbo to remove all gaps and additional space
+    unsigned int allocate(unsigned int count);
+    /**
+     * Copies vertices and colors into the vbos
+     * @param offset Offset into the vbos (in vertices)
+     * @param vertices 3 floats per vertex
+     * @param colors 4 floats per vertex
+     * @param count The number of vertices
+     */
+    void upload(unsigned int offset, const void *vertices, const void *colors, unsigned int count);
+    /**
+     * Sets the line width of a range of the vbo
+     * @param offset Offset into the vbo (in vertices)
+     * @param count The number of vertices
+     * @param width The width (in pixels)
+     */
+    void fillWidth(unsigned int offset, unsigned int count, float width);
+    /**
+     * Generates levels of detail for long polylines, and sets the state's footprint
+     * @param s The state, its count, mType and mWidth must be set
+     * @param vertices The state's vertices
+     * @param colors The state's colors
+     * @param lodVertices Returns the vertices of all levels, to be stored after the state's vertices
+     * @param lodColors Returns the colors of all levels, to be stored after the state's colors
+     */
+    void buildLods(State &s, const glm::vec3 *vertices, const glm::vec4 *colors, std::vector<glm::vec3> &lodVertices, std::vector<glm::vec4> &lodColors) const;
+    /**
+     * Frees the state's range of the vbo
      */
-    void compact() { resize(requiredLength); }
+    void release(const State &s);
+    /**
+     * Returns the combined view and projection matrix
+     * @return False if the view or projection matrix has not been provided
+     */
+    bool getViewProjection(glm::mat4 &viewProjection) const;
+    /**
+     * Updates viewportSize from the current GL viewport
+     */
+    void updateViewport();
+    /**
+     * @return The program which draws Type t
+     */
+    std::shared_ptr<Shaders> &getShaders(const Type &t);
+    /**
+     * Updates first and count to the level of detail of the state to be drawn
+     * first and count are left unchanged if the full resolution is required
+     */
+    static void selectLod(const State &s, const glm::mat4 &viewProjection, const glm::vec2 &halfViewport, GLint &first, GLsizei &count);
     /**
      * Renders the provided draw state
      * @param state The draw state to be rendered
      */
-    void render(const State &state) const;
+    void render(const State &state);
+    /**
+     * Saved draw states which share a type (and width, for points), in the form taken by glMultiDrawArrays()
+     */
+    struct Batch {
+        Type mType;
+        float mWidth;
+        std::vector<GLint> first;
+        std::vector<GLsizei> count;
+        // The state drawn by each element of first and count
+        std::vector<const State*> states;
+    };
+    /**
+     * Rebuilds batches from stateDirectory
+     */
+    void buildBatches();
+    /**
+     * Draw states grouped for renderAll(), rebuilt when batchesDirty is set
+     */
+    std::vector<Batch> batches;
+    /**
+     * Set whenever a draw state is saved or moved, so that batches no longer match stateDirectory
+     */
+    bool batchesDirty = false;
+    /**
+     * Set if any state within batches has levels of detail
+     */
+    bool hasLods = false;
     /**
      * Holds all created draw states
      */
     std::unordered_map<std::string, State> stateDirectory;
     /**
-     * Holds a list of pairs stating where gaps can be found in the current vbo
-     * @note Pair structure is {offset, count}
+     * A polyline ring buffer, within range of the vbo
+     * The range holds capacity + 1 vertices, the final vertex mirrors the first
+     * So that once wrapped, the oldest to newest points can be drawn as two strips which meet
+     */
+    struct Stream {
+        State range;
+        unsigned int capacity;
+        // Number of points written, up to capacity
+        unsigned int size;
+        // Slot the next point will be written to
+        unsigned int head;
+    };
+    /**
+     * Holds all created streams
      */
-    std::vector<std::pair<unsigned int, unsigned int>> vboGaps;
+    std::unordered_map<std::string, Stream> streamDirectory;
     /*
      * Saves the current in progress draw state returning the create draw state struct
      * @param isTemporary Specifies whether the create state is temporary (passing false will cause gapList to be updated)
@@ -202,24 +347,54 @@ class Draw : Renderable {
      * Data required for rendering
      */
     std::shared_ptr<Shaders> shaders;
+    /**
+     * Lines and polylines are expanded to screen space quads by a geometry shader
+     * So that their width is not limited by glLineWidth(), and their edges are anti-aliased
+     */
+    std::shared_ptr<Shaders> lineShaders;
     Shaders::VertexAttributeDetail vertices, colors;
+    /**
+     * Line width (in pixels) of each vertex
+     */
+    Shaders::VertexAttributeDetail widths;
+    /**
+     * Size of the viewport in pixels, required by lineShaders
+     */
+    glm::vec2 viewportSize = glm::vec2(1.0f);
     /**
      * Data required for managing storage
      */
-    unsigned int vboLen, vboOffset;
     static const unsigned int DEFAULT_INITIAL_VBO_LENGTH;
     static const float STORAGE_MUTLIPLIER;
+    /**
+     * The coarsest level of detail has at least this many vertices
+     */
+    static const unsigned int LOD_MIN_VERTICES;
+    /**
+     * Levels of detail are selected to have at least this many vertices per pixel of their on screen extent
+     */
+    static const float LOD_VERTICES_PER_PIXEL;
+    /**
+     * Tracks which ranges of the vbo are free, adjacent free ranges are coalesced
+     */
+    RangeAllocator allocator;
     unsigned int requiredLength;
+    bool autoCompact;
+    /**
+     * Required to select levels of detail
+     */
+    const glm::mat4 *viewMatPtr = nullptr;
+    const glm::mat4 *projectionMatPtr = nullptr;
     /**
      * @return The GLenum which matches Type t
      */
     static GLenum toGL(const Type &t);
     /**
-     * @return calls glPointSize(w) or glLineWidth(w) correpsonding to Type t
+     * @return calls glPointSize(w) if Type t is points, line widths are held in the widths vbo
      */
     static void setWidth(const Type &t, const float &w);
     /**
-     * @return calls glPointSize(1) or glLineWidth(1) correpsonding to Type t
+     * @return calls glPointSize(1) if Type t is points
      */
     static void clearWidth(const Type &t);
 };
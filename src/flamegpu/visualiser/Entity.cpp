@@ -1,12 +1,19 @@
 #include "Entity.h"
 
-#include <sparsehash/dense_hash_map>
 #include <unordered_map>
 #include <functional>
+#include <future>
+#include <atomic>
+#include <mutex>
 #include <thread>
+#include <climits>
+#include <limits>
 #include <algorithm>
+#include <filesystem>
 #include <locale>
 #include <string>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <cstdio>
 #include <vector>
@@ -14,9 +21,16 @@
 
 #include <glm/gtx/component_wise.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
 
 #include "flamegpu/visualiser/util/StringUtils.h"
+#include "flamegpu/visualiser/util/MappedFile.h"
 #include "flamegpu/visualiser/util/Resources.h"
+#include "flamegpu/visualiser/util/ThreadPool.h"
+#include "flamegpu/visualiser/model/MeshOptimiser.h"
+#include "flamegpu/visualiser/model/GLBFile.h"
+#include "flamegpu/visualiser/model/PrimitiveMesh.h"
+#include "flamegpu/visualiser/shader/buffer/ShaderStorageBuffer.h"
 
 namespace flamegpu {
 namespace visualiser {
@@ -25,8 +39,67 @@ namespace visualiser {
 #define FACES_SIZE 3
 
 const char *Entity::OBJ_TYPE = ".obj";
+const char *Entity::GLB_TYPE = ".glb";
 const char *Entity::EXPORT_TYPE = ".obj.sdl_export";
 
+namespace {
+/**
+ * Model data which has been (or is being) parsed on a worker thread by Entity::preload()
+ * Entries are retained until Entity::clearPreloaded(), as several entities may share the same model file
+ */
+std::mutex preloadedModelsMutex;
+std::unordered_map<std::string, std::shared_future<std::shared_ptr<Entity::ModelData>>> preloadedModels;
+/**
+ * Whether models loaded from .obj should be passed through MeshOptimiser
+ */
+std::atomic<bool> optimiseModels(false);
+/**
+ * Whether model vertex attributes should be uploaded in packed (half float, 10:10:10:2) formats
+ */
+std::atomic<bool> packModelVertices(false);
+/**
+ * Whether the host copies of model geometry should be freed once uploaded
+ */
+std::atomic<bool> releaseModelGeometry(false);
+/**
+ * Bytes of model geometry held by all live meshes
+ * Released bytes are host copies which have been freed, as they were only required prior to upload
+ */
+std::atomic<size_t> hostGeometryBytes(0);
+std::atomic<size_t> deviceGeometryBytes(0);
+std::atomic<size_t> releasedGeometryBytes(0);
+/**
+ * Sums of the ACMR of all optimised models, models may be optimised by worker threads
+ */
+std::mutex optimisationStatsMutex;
+Entity::OptimisationStats optimisationTotals = { 0, 0.0f, 0.0f };
+/**
+ * Meshes of all live entities, keyed by Entity::meshKey()
+ * Entries expire when the last entity using the mesh is destroyed
+ */
+std::mutex meshesMutex;
+std::unordered_map<std::string, std::weak_ptr<Entity::Mesh>> meshes;
+/**
+ * Keyframe atlases of all live entities, keyed by their joined model paths
+ * Also guarded by meshesMutex
+ */
+std::unordered_map<std::string, std::weak_ptr<ShaderStorageBuffer>> keyframeAtlases;
+/**
+ * Returns the preloaded data for the named model, else parses it on the calling thread
+ */
+std::shared_ptr<Entity::ModelData> getModelData(const std::string &modelPath) {
+    std::shared_future<std::shared_ptr<Entity::ModelData>> pending;
+    {
+        std::lock_guard<std::mutex> lock(preloadedModelsMutex);
+        auto it = preloadedModels.find(modelPath);
+        if (it != preloadedModels.end())
+            pending = it->second;
+    }
+    // Block until the worker has finished, this rethrows any exception raised during parsing
+    return pending.valid() ? pending.get() : std::make_shared<Entity::ModelData>(modelPath);
+}
+}  // namespace
+
 /*
 Convenience constructor.
 */
@@ -88,9 +161,19 @@ Entity::Entity(
     , colors(GL_FLOAT, 3, sizeof(float))
     , texcoords(GL_FLOAT, 2, sizeof(float))
     , faces(GL_UNSIGNED_INT, FACES_SIZE, sizeof(unsigned int))
+    , devicePositions(GL_FLOAT, 3, sizeof(float))
+    , deviceNormals(GL_FLOAT, NORMALS_SIZE, sizeof(float))
+    , deviceColors(GL_FLOAT, 3, sizeof(float))
+    , deviceTexcoords(GL_FLOAT, 2, sizeof(float))
+    , indexType(GL_UNSIGNED_INT)
     , materialBuffer(std::make_shared<UniformBuffer>(sizeof(MaterialProperties) * MAX_OBJ_MATERIALS))
     , location(0.0f)
     , rotation(0.0f, 0.0f, 1.0f, 0.0f)
+    , boundingRadius(0.0f)
+    , sourceSize(0)
+    , sourceHash(0)
+    , optimised(false)
+    , needsExport(false)
     , cullFace(true) {
     GL_CHECK();
     loadModelFromFile();
@@ -101,12 +184,12 @@ Entity::Entity(
         // Override material
         for (unsigned int i = 0; i < matSize; ++i) {
             this->materials.push_back(Material(materialBuffer, static_cast<unsigned int>(materials.size()), material));
-            if (positions.data) {
+            if (positions.count) {
                 auto it = materials[i].getShaders();
-                it->setPositionsAttributeDetail(positions);
-                it->setNormalsAttributeDetail(normals);
-                it->setColorsAttributeDetail(colors);
-                it->setTexCoordsAttributeDetail(texcoords);
+                it->setPositionsAttributeDetail(devicePositions);
+                it->setNormalsAttributeDetail(deviceNormals);
+                it->setColorsAttributeDetail(deviceColors);
+                it->setTexCoordsAttributeDetail(deviceTexcoords);
                 it->setMaterialBuffer(materialBuffer);
                 it->setFaceVBO(faces.vbo);
             }
@@ -116,6 +199,7 @@ Entity::Entity(
     if (needsExport) {
         exportModel();
     }
+    releaseHostGeometry();
 }
 /*
 Constructs an entity from the provided .obj model
@@ -143,9 +227,18 @@ Entity::Entity(
     , colors(GL_FLOAT, 3, sizeof(float))
     , texcoords(GL_FLOAT, 2, sizeof(float))
     , faces(GL_UNSIGNED_INT, FACES_SIZE, sizeof(unsigned int))
+    , devicePositions(GL_FLOAT, 3, sizeof(float))
+    , deviceNormals(GL_FLOAT, NORMALS_SIZE, sizeof(float))
+    , deviceColors(GL_FLOAT, 3, sizeof(float))
+    , deviceTexcoords(GL_FLOAT, 2, sizeof(float))
+    , indexType(GL_UNSIGNED_INT)
     , materialBuffer(std::make_shared<UniformBuffer>(sizeof(MaterialProperties) * MAX_OBJ_MATERIALS))
     , location(0.0f)
     , rotation(0.0f, 0.0f, 1.0f, 0.0f)
+    , boundingRadius(0.0f)
+    , sourceSize(0)
+    , sourceHash(0)
+    , optimised(false)
     , needsExport(false)
     , cullFace(true) {
     GL_CHECK();
@@ -162,11 +255,11 @@ Entity::Entity(
     }
     // If shaders have been provided, set them up
     for (auto &&it : this->shaders) {
-        if (positions.data&&it) {
-            it->setPositionsAttributeDetail(positions);
-            it->setNormalsAttributeDetail(normals);
-            it->setColorsAttributeDetail(colors);
-            it->setTexCoordsAttributeDetail(texcoords);
+        if (positions.count&&it) {
+            it->setPositionsAttributeDetail(devicePositions);
+            it->setNormalsAttributeDetail(deviceNormals);
+            it->setColorsAttributeDetail(deviceColors);
+            it->setTexCoordsAttributeDetail(deviceTexcoords);
             it->setMaterialBuffer(materialBuffer);
             it->setFaceVBO(faces.vbo);
             if (texture)
@@ -174,13 +267,13 @@ Entity::Entity(
         }
     }
     for (auto &&m : materials) {
-        if (positions.data) {
+        if (positions.count) {
             auto it = m.getShaders();
             if (it) {
-                it->setPositionsAttributeDetail(positions);
-                it->setNormalsAttributeDetail(normals);
-                it->setColorsAttributeDetail(colors);
-                it->setTexCoordsAttributeDetail(texcoords);
+                it->setPositionsAttributeDetail(devicePositions);
+                it->setNormalsAttributeDetail(deviceNormals);
+                it->setColorsAttributeDetail(deviceColors);
+                it->setTexCoordsAttributeDetail(deviceTexcoords);
                 it->setMaterialBuffer(materialBuffer);
                 it->setFaceVBO(faces.vbo);
             } else if (this->shaders.empty()) {
@@ -192,34 +285,35 @@ Entity::Entity(
     if (needsExport) {
         exportModel();
     }
+    releaseHostGeometry();
 }
 
 /*
 Destructor, free's memory allocated to store the model and its material
 */
 Entity::~Entity() {
-    // All attribs (except faces) share the same vbo, so delete once
-    deleteVertexBufferObject(&positions.vbo);
-    deleteVertexBufferObject(&faces.vbo);
-    // All attribs (except faces) share the same malloc, so delete once
-    free(positions.data);
-    free(faces.data);
+    // Buffer objects and host copies are owned by the (possibly shared) mesh
+    mesh.reset();
     materialBuffer.reset();
     materials.clear();
     texture.reset();
     keyframe_model.reset();
+    keyframeAtlas.reset();
 }
 glm::mat4 Entity::getModelMat() const {
+    return getModelMat(this->location, this->rotation, glm::vec3(this->scaleFactor));
+}
+glm::mat4 Entity::getModelMat(const glm::vec3 &location, const glm::vec4 &rotation, const glm::vec3 &scaleFactor) {
     // Apply world transforms (in reverse order that we wish for them to be applied)
-    glm::mat4 modelMat = glm::translate(glm::mat4(1), this->location);
+    glm::mat4 modelMat = glm::translate(glm::mat4(1), location);
 
     // Check we actually have a rotation (providing no axis == error)
-    if ((this->rotation.x != 0 || this->rotation.y != 0 || this->rotation.z != 0) && this->rotation.w != 0)
-        modelMat = glm::rotate(modelMat, glm::radians(this->rotation.w), glm::vec3(this->rotation));
+    if ((rotation.x != 0 || rotation.y != 0 || rotation.z != 0) && rotation.w != 0)
+        modelMat = glm::rotate(modelMat, glm::radians(rotation.w), glm::vec3(rotation));
 
     // Only bother scaling if we were asked to
-    if (this->scaleFactor != glm::vec4(1.0f))
-        modelMat = glm::scale(modelMat, glm::vec3(this->scaleFactor));
+    if (scaleFactor != glm::vec3(1.0f))
+        modelMat = glm::scale(modelMat, scaleFactor);
     return modelMat;
 }
 void Entity::loadKeyFrameModel(const std::string& modelpathB) {
@@ -233,20 +327,92 @@ void Entity::loadKeyFrameModel(const std::string& modelpathB) {
     visassert(normals.componentType == keyframe_model->normals.componentType);
     visassert(normals.components == keyframe_model->normals.components);
     visassert(normals.count == keyframe_model->normals.count);
+    visassert(devicePositions.componentType == keyframe_model->devicePositions.componentType);
+    visassert(deviceNormals.componentType == keyframe_model->deviceNormals.componentType);
     // If shaders have been provided, set them up
     for (auto&& it : this->shaders) {
-        if (keyframe_model->positions.data && it) {
-            it->addGenericAttributeDetail("_vertex2", keyframe_model->positions, false);
-            it->addGenericAttributeDetail("_normal2", keyframe_model->normals, true);
+        if (keyframe_model->positions.count && it) {
+            it->addGenericAttributeDetail("_vertex2", keyframe_model->devicePositions, false);
+            it->addGenericAttributeDetail("_normal2", keyframe_model->deviceNormals, true);
         }
     }
     for (auto& m : materials) {
         for (unsigned int i = 0; i < m.getShaderCount(); ++i) {
             auto sh = m.getShaders(i);
-            sh->addGenericAttributeDetail("_vertex2", keyframe_model->positions, false);
-            sh->addGenericAttributeDetail("_normal2", keyframe_model->normals, true);
+            sh->addGenericAttributeDetail("_vertex2", keyframe_model->devicePositions, false);
+            sh->addGenericAttributeDetail("_normal2", keyframe_model->deviceNormals, true);
+        }
+    }
+}
+/*
+Packs the vertices of each keyframe model, frame by frame, into a single shader storage buffer
+Each vertex is stored as a vec3 position and a 10:10:10:2 normal, matching _KeyframeVertex within VertexFunction
+Models are parsed via the preload cache, so are not uploaded as separate vertex buffers
+@param modelPaths Paths to the keyframe models, each must share this entity's topology
+*/
+void Entity::loadKeyFrameModels(const std::vector<std::string> &modelPaths) {
+    if (modelPaths.size() < 2) {
+        THROW EntityError("Entity::loadKeyFrameModels() requires atleast 2 keyframes, %u were provided.\n", static_cast<unsigned int>(modelPaths.size()));
+    }
+    // Vertex order depends on whether models were optimised
+    std::string key = optimiseModels ? "optimised" : "";
+    for (const auto &path : modelPaths)
+        key += "|" + path;
+    std::shared_ptr<ShaderStorageBuffer> atlas;
+    {
+        std::lock_guard<std::mutex> lock(meshesMutex);
+        auto it = keyframeAtlases.find(key);
+        if (it != keyframeAtlases.end()) {
+            atlas = it->second.lock();
+            if (!atlas)
+                keyframeAtlases.erase(it);
         }
     }
+    if (!atlas) {
+        struct KeyframeVertex {
+            float position[3];
+            uint32_t normal;
+        };
+        static_assert(sizeof(KeyframeVertex) == 16, "KeyframeVertex must match the std430 layout of _KeyframeVertex");
+        std::vector<KeyframeVertex> vertices(modelPaths.size() * vn_count);
+        for (size_t f = 0; f < modelPaths.size(); ++f) {
+            std::shared_ptr<ModelData> data = getModelData(modelPaths[f]);
+            if (data->vn_count != vn_count || data->faces.count != faces.count) {
+                THROW ResourceError("Keyframe model '%s' has %u vertices and %u faces, expected %u and %u, "
+                    "in Entity::loadKeyFrameModels()\n", modelPaths[f].c_str(), data->vn_count, data->faces.count, vn_count, faces.count);
+            }
+            if (!data->normals.count != !normals.count) {
+                THROW ResourceError("Keyframe model '%s' %s vertex normals, unlike '%s', in Entity::loadKeyFrameModels()\n",
+                    modelPaths[f].c_str(), data->normals.count ? "has" : "does not have", modelPath);
+            }
+            const float *p = static_cast<const float*>(data->positions.data);
+            const float *n = static_cast<const float*>(data->normals.data);
+            KeyframeVertex *v = vertices.data() + f * vn_count;
+            for (unsigned int i = 0; i < vn_count; ++i) {
+                memcpy(v[i].position, p + i * data->positions.components, sizeof(float) * 3);
+                v[i].normal = n ? glm::packSnorm3x10_1x2(glm::vec4(n[i * 3], n[i * 3 + 1], n[i * 3 + 2], 0.0f)) : 0;
+            }
+        }
+        atlas = std::make_shared<ShaderStorageBuffer>(vertices.size() * sizeof(KeyframeVertex), vertices.data());
+        std::lock_guard<std::mutex> lock(meshesMutex);
+        keyframeAtlases[key] = atlas;
+    }
+    keyframeAtlas = atlas;
+    keyframeCount = static_cast<unsigned int>(modelPaths.size());
+    // If shaders have been provided, set them up
+    for (auto&& it : this->shaders) {
+        if (it)
+            bindKeyFrames(it);
+    }
+    for (auto& m : materials) {
+        for (unsigned int i = 0; i < m.getShaderCount(); ++i)
+            bindKeyFrames(m.getShaders(i));
+    }
+}
+void Entity::bindKeyFrames(const std::shared_ptr<Shaders> &s) const {
+    s->addBuffer("_keyframes", keyframeAtlas);
+    s->addStaticUniform("_keyframe_count", &keyframeCount);
+    s->addStaticUniform("_keyframe_vertex_count", &vn_count);
 }
 /*
 Calls the necessary code to render a single instance of the entity
@@ -255,15 +421,18 @@ Calls the necessary code to render a single instance of the entity
 */
 void Entity::render(unsigned int shaderIndex) {
     glm::mat4 m = getModelMat();
-    this->materials[0].use(m, shaderIndex, true);
+    const size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    for (const SubMesh &sm : subMeshes) {
+        this->materials[sm.material].use(m, shaderIndex, true);
 
-    if (!cullFace)
-        GL_CALL(glDisable(GL_CULL_FACE));
-    GL_CALL(glDrawElements(GL_TRIANGLES, faces.count * faces.components, GL_UNSIGNED_INT, 0));
-    if (!cullFace)
-        GL_CALL(glEnable(GL_CULL_FACE));
+        if (!cullFace)
+            GL_CALL(glDisable(GL_CULL_FACE));
+        GL_CALL(glDrawElements(GL_TRIANGLES, sm.faceCount * faces.components, indexType, reinterpret_cast<const void*>(static_cast<size_t>(sm.firstFace) * faces.components * indexSize)));
+        if (!cullFace)
+            GL_CALL(glEnable(GL_CULL_FACE));
 
-    this->materials[0].clear();
+        this->materials[sm.material].clear();
+    }
 }
 /*
 Calls the necessary code to render count instances of the entity
@@ -274,15 +443,18 @@ The index of the instance being rendered can be identified within the vertex sha
 */
 void Entity::renderInstances(int count, unsigned int shaderIndex) {
     glm::mat4 m = getModelMat();
-    this->materials[0].use(m, shaderIndex, true);
+    const size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    for (const SubMesh &sm : subMeshes) {
+        this->materials[sm.material].use(m, shaderIndex, true);
 
-    if (!cullFace)
-        GL_CALL(glEnable(GL_CULL_FACE));
-    GL_CALL(glDrawElementsInstanced(GL_TRIANGLES, faces.count * faces.components, GL_UNSIGNED_INT, 0, count));
-    if (!cullFace)
-        GL_CALL(glDisable(GL_CULL_FACE));
+        if (!cullFace)
+            GL_CALL(glEnable(GL_CULL_FACE));
+        GL_CALL(glDrawElementsInstanced(GL_TRIANGLES, sm.faceCount * faces.components, indexType, reinterpret_cast<const void*>(static_cast<size_t>(sm.firstFace) * faces.components * indexSize), count));
+        if (!cullFace)
+            GL_CALL(glDisable(GL_CULL_FACE));
 
-    this->materials[0].clear();
+        this->materials[sm.material].clear();
+    }
 }
 /*
 Creates a vertex buffer object of the specified size
@@ -304,219 +476,973 @@ void Entity::deleteVertexBufferObject(GLuint *vbo) {
     GL_CALL(glDeleteBuffers(1, vbo));
 }
 
+Entity::ModelData::ModelData(const std::string &modelPath)
+    : modelPath(modelPath)
+    , vn_count(0)
+    , positions(GL_FLOAT, 3, sizeof(float))
+    , normals(GL_FLOAT, NORMALS_SIZE, sizeof(float))
+    , colors(GL_FLOAT, 3, sizeof(float))
+    , texcoords(GL_FLOAT, 2, sizeof(float))
+    , faces(GL_UNSIGNED_INT, FACES_SIZE, sizeof(unsigned int))
+    , modelMin(FLT_MAX)
+    , modelMax(-FLT_MAX)
+    , boundingRadius(0.0f)
+    , sourceSize(0)
+    , sourceHash(0)
+    , optimised(false)
+    , needsExport(false) {
+    loadModelFromFile();
+}
+Entity::ModelData::~ModelData() {
+    // All attribs (except faces) share the same malloc, so delete once
+    if (!mapping) {
+        free(positions.data);
+        free(faces.data);
+    }
+}
+size_t Entity::ModelData::vertexBufferSize() const {
+    size_t bufferSize = 0;
+    bufferSize += positions.count * positions.components * positions.componentSize;
+    bufferSize += normals.count * normals.components * normals.componentSize;
+    bufferSize += colors.count * colors.components * colors.componentSize;
+    bufferSize += texcoords.count * texcoords.components * texcoords.componentSize;
+    return bufferSize;
+}
+std::shared_ptr<const Entity::ModelData> Entity::loadModelData(const std::string &modelPath) {
+    return getModelData(modelPath);
+}
+void Entity::preload(const std::string &modelPath) {
+    std::lock_guard<std::mutex> lock(preloadedModelsMutex);
+    if (preloadedModels.find(modelPath) == preloadedModels.end()) {
+        preloadedModels.emplace(modelPath, ThreadPool::get().submit([modelPath]() {
+            return std::make_shared<ModelData>(modelPath);
+        }).share());
+    }
+}
+void Entity::clearPreloaded() {
+    std::lock_guard<std::mutex> lock(preloadedModelsMutex);
+    preloadedModels.clear();
+}
+void Entity::setOptimiseModels(const bool optimise) {
+    optimiseModels = optimise;
+}
+bool Entity::getOptimiseModels() {
+    return optimiseModels;
+}
+void Entity::setPackModelVertices(const bool pack) {
+    packModelVertices = pack;
+}
+bool Entity::getPackModelVertices() {
+    return packModelVertices;
+}
+void Entity::setReleaseHostGeometry(const bool release) {
+    releaseModelGeometry = release;
+}
+bool Entity::getReleaseHostGeometry() {
+    return releaseModelGeometry;
+}
+Entity::GeometryMemory Entity::getGeometryMemory() {
+    return { hostGeometryBytes, deviceGeometryBytes, releasedGeometryBytes };
+}
+Entity::OptimisationStats Entity::getOptimisationStats() {
+    std::lock_guard<std::mutex> lock(optimisationStatsMutex);
+    OptimisationStats rtn = optimisationTotals;
+    if (rtn.models) {
+        rtn.acmrBefore /= rtn.models;
+        rtn.acmrAfter /= rtn.models;
+    }
+    return rtn;
+}
 /*
-Used by loadModelFromFile() in a hashmap of vertex-normal pairs
+Loads the model's geometry into this classes primitive storage, and uploads it to the GPU
+If the model has been preloaded, the data decoded by the worker thread is used
 */
-struct VN_PAIR {
-    unsigned int v, n, t;
-};
-
-}  // namespace visualiser
-}  // namespace flamegpu
-// Need to dropout of flamegpu::visualiser for this to end up in std::
-
+void Entity::loadModelFromFile() {
+    // Reuse the geometry and buffer objects of an existing entity with the same model
+    const std::string key = meshKey();
+    std::shared_ptr<Mesh> shared;
+    {
+        std::lock_guard<std::mutex> lock(meshesMutex);
+        auto it = meshes.find(key);
+        if (it != meshes.end()) {
+            shared = it->second.lock();
+            if (!shared)
+                meshes.erase(it);
+        }
+    }
+    if (shared) {
+        useMesh(shared);
+    } else {
+        std::shared_ptr<ModelData> data = getModelData(modelPath);
+        // Take a copy of the host buffers, unless we are the only user of the data
+        // Memory mapped exports are read-only, so can be shared without copying
+        vn_count = data->vn_count;
+        positions = data->positions;
+        normals = data->normals;
+        colors = data->colors;
+        texcoords = data->texcoords;
+        faces = data->faces;
+        if (data->mapping) {
+            // The mesh retains the mapping
+        } else if (data.use_count() == 1) {
+            data->positions.data = nullptr;
+            data->faces.data = nullptr;
+        } else {
+            const size_t vertexBytes = data->vertexBufferSize();
+            const size_t faceBytes = faces.count * faces.components * faces.componentSize;
+            positions.data = malloc(vertexBytes);
+            memcpy(positions.data, data->positions.data, vertexBytes);
+            faces.data = malloc(faceBytes);
+            memcpy(faces.data, data->faces.data, faceBytes);
+        }
+        // Attributes are sub-allocations of the positions buffer
+        normals.data = normals.count ? reinterpret_cast<char*>(positions.data) + normals.offset : nullptr;
+        colors.data = colors.count ? reinterpret_cast<char*>(positions.data) + colors.offset : nullptr;
+        texcoords.data = texcoords.count ? reinterpret_cast<char*>(positions.data) + texcoords.offset : nullptr;
+        this->modelMin = data->modelMin;
+        this->modelMax = data->modelMax;
+        this->boundingRadius = data->boundingRadius;
+        this->mtllib = data->mtllib;
+        this->usemtl = data->usemtl;
+        this->sourceSize = data->sourceSize;
+        this->sourceHash = data->sourceHash;
+        this->optimised = data->optimised;
+        this->modelMaterials = data->modelMaterials;
+        this->subMeshes = data->subMeshes;
+        // Models without sub-meshes are drawn as a single range, with the first material
+        if (subMeshes.empty())
+            subMeshes.push_back({ 0, faces.count, 0 });
+        // Load VBOs
+        generateVertexBufferObjects();
+        // Can the host copies be freed after a bind?
+        // No, we want to keep faces around as a minimum for easier vertex order switching
+        mesh = createMesh(data->mapping);
+        std::lock_guard<std::mutex> lock(meshesMutex);
+        meshes[key] = mesh;
+    }
+    // Calculate scale factor
+    this->modelDims = modelMax - modelMin;
+    this->scaleFactor = glm::vec4(getScaleFactor(SCALE, modelDims), 1.0f);
+    if (!mtllib.empty() && !usemtl.empty()) {
+        loadMaterialFromFile(modelPath, mtllib.c_str(), usemtl.c_str());
+    } else if (!modelMaterials.empty()) {
+        loadModelMaterials();
+    }
+}
+glm::vec3 Entity::getScaleFactor(const glm::vec3 &scale, const glm::vec3 &modelDims) {
+    glm::vec3 rtn(1.0f);
+    if (scale.x < 0) {
+        // Special case, negative scale means scale uniformly according to longest edge
+        rtn = glm::vec3(-scale.x / glm::compMax(modelDims));
+    } else {
+        if (scale.x > 0) rtn.x = scale.x / modelDims.x;
+        if (scale.y > 0) rtn.y = scale.y / modelDims.y;
+        if (scale.z > 0) rtn.z = scale.z / modelDims.z;
+    }
+    return rtn;
+}
+std::string Entity::meshKey() const {
+    // The upload settings change the contents of the buffer objects, so meshes are only shared between matching settings
+    std::string key = modelPath;
+    if (optimiseModels)
+        key.append("|optimised");
+    if (packModelVertices)
+        key.append("|packed");
+    return key;
+}
+Entity::Mesh::Mesh()
+    : vn_count(0)
+    , positions(GL_FLOAT, 3, sizeof(float))
+    , normals(GL_FLOAT, NORMALS_SIZE, sizeof(float))
+    , colors(GL_FLOAT, 3, sizeof(float))
+    , texcoords(GL_FLOAT, 2, sizeof(float))
+    , faces(GL_UNSIGNED_INT, FACES_SIZE, sizeof(unsigned int))
+    , devicePositions(GL_FLOAT, 3, sizeof(float))
+    , deviceNormals(GL_FLOAT, NORMALS_SIZE, sizeof(float))
+    , deviceColors(GL_FLOAT, 3, sizeof(float))
+    , deviceTexcoords(GL_FLOAT, 2, sizeof(float))
+    , indexType(GL_UNSIGNED_INT)
+    , modelMin(FLT_MAX)
+    , modelMax(-FLT_MAX)
+    , boundingRadius(0.0f)
+    , sourceSize(0)
+    , sourceHash(0)
+    , optimised(false)
+    , hostBytes(0)
+    , deviceBytes(0)
+    , hostResident(false) { }
+Entity::Mesh::~Mesh() {
+    (hostResident ? hostGeometryBytes : releasedGeometryBytes) -= hostBytes;
+    deviceGeometryBytes -= deviceBytes;
+    // All attribs (except faces) share the same vbo, so delete once
+    deleteVertexBufferObject(&positions.vbo);
+    deleteVertexBufferObject(&faces.vbo);
+    // All attribs (except faces) share the same malloc, so delete once
+    if (!mapping) {
+        free(positions.data);
+        free(faces.data);
+    }
+}
+std::shared_ptr<Entity::Mesh> Entity::createMesh(std::shared_ptr<const MappedFile> mapping) const {
+    std::shared_ptr<Mesh> rtn = std::make_shared<Mesh>();
+    rtn->vn_count = vn_count;
+    rtn->positions = positions;
+    rtn->normals = normals;
+    rtn->colors = colors;
+    rtn->texcoords = texcoords;
+    rtn->faces = faces;
+    rtn->devicePositions = devicePositions;
+    rtn->deviceNormals = deviceNormals;
+    rtn->deviceColors = deviceColors;
+    rtn->deviceTexcoords = deviceTexcoords;
+    rtn->indexType = indexType;
+    rtn->modelMin = modelMin;
+    rtn->modelMax = modelMax;
+    rtn->boundingRadius = boundingRadius;
+    rtn->mtllib = mtllib;
+    rtn->usemtl = usemtl;
+    rtn->sourceSize = sourceSize;
+    rtn->sourceHash = sourceHash;
+    rtn->optimised = optimised;
+    rtn->subMeshes = subMeshes;
+    rtn->modelMaterials = modelMaterials;
+    rtn->mapping = mapping;
+    // Account for the geometry now owned by the mesh
+    rtn->hostBytes = hostVertexBytes() + faces.count * faces.components * faces.componentSize;
+    rtn->deviceBytes = faces.count * faces.components * (indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t));
+    for (const Shaders::VertexAttributeDetail *d : { &devicePositions, &deviceNormals, &deviceColors, &deviceTexcoords })
+        rtn->deviceBytes += d->count * d->elementSize();
+    rtn->hostResident = positions.data != nullptr;
+    (rtn->hostResident ? hostGeometryBytes : releasedGeometryBytes) += rtn->hostBytes;
+    deviceGeometryBytes += rtn->deviceBytes;
+    return rtn;
+}
+size_t Entity::hostVertexBytes() const {
+    return positions.count * positions.components * positions.componentSize
+        + normals.count * normals.components * normals.componentSize
+        + colors.count * colors.components * colors.componentSize
+        + texcoords.count * texcoords.components * texcoords.componentSize;
+}
 /*
-Used by loadModelFromFile() in a hashmap of vertex-normal pairs
+If enabled by setReleaseHostGeometry(), frees the host copies of the mesh's geometry
+These are only required to modify or export the model, mapped exports are unmapped rather than freed
 */
-namespace std {
-template<> struct hash<flamegpu::visualiser::VN_PAIR> {
-    size_t operator()(const flamegpu::visualiser::VN_PAIR & x) const {
-        static int offset = sizeof(uint64_t) / 3;
-        return (x.t << offset * 2) & (x.n << offset) & x.v;
+void Entity::releaseHostGeometry() {
+    // Other entities sharing the mesh hold their own views of the host copies
+    if (!releaseModelGeometry || !mesh || !mesh->hostResident || mesh.use_count() > 1)
+        return;
+    if (!mesh->mapping) {
+        free(mesh->positions.data);
+        free(mesh->faces.data);
+    }
+    mesh->mapping.reset();
+    for (Shaders::VertexAttributeDetail *d : { &mesh->positions, &mesh->normals, &mesh->colors, &mesh->texcoords, &mesh->faces,
+        &positions, &normals, &colors, &texcoords, &faces }) {
+        d->data = nullptr;
+    }
+    mesh->hostResident = false;
+    hostGeometryBytes -= mesh->hostBytes;
+    releasedGeometryBytes += mesh->hostBytes;
+}
+/*
+Restores host copies freed by releaseHostGeometry()
+Unpacked buffer objects match the host layout, so are read back directly
+Packed attributes are lossy, so the model is instead reloaded (from its binary export, if one exists)
+*/
+void Entity::restoreHostGeometry() {
+    if (!mesh || positions.data)
+        return;
+    if (!mesh->hostResident) {
+        const size_t vertexBytes = hostVertexBytes();
+        const size_t faceBytes = faces.count * faces.components * faces.componentSize;
+        void *vertexData = malloc(vertexBytes);
+        void *faceData = malloc(faceBytes);
+        const bool packed = devicePositions.componentType != positions.componentType
+            || deviceNormals.componentType != normals.componentType
+            || deviceTexcoords.componentType != texcoords.componentType;
+        if (!packed) {
+            // GL_COPY_READ_BUFFER is used, as binding GL_ELEMENT_ARRAY_BUFFER would modify the bound vertex array
+            GL_CALL(glBindBuffer(GL_COPY_READ_BUFFER, positions.vbo));
+            GL_CALL(glGetBufferSubData(GL_COPY_READ_BUFFER, 0, vertexBytes, vertexData));
+            GL_CALL(glBindBuffer(GL_COPY_READ_BUFFER, faces.vbo));
+            if (indexType == GL_UNSIGNED_SHORT) {
+                std::vector<uint16_t> shortFaces(faces.count * faces.components);
+                GL_CALL(glGetBufferSubData(GL_COPY_READ_BUFFER, 0, shortFaces.size() * sizeof(uint16_t), shortFaces.data()));
+                std::copy(shortFaces.begin(), shortFaces.end(), reinterpret_cast<unsigned int*>(faceData));
+            } else {
+                GL_CALL(glGetBufferSubData(GL_COPY_READ_BUFFER, 0, faceBytes, faceData));
+            }
+            GL_CALL(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+        } else {
+            std::shared_ptr<ModelData> data = getModelData(modelPath);
+            if (data->vn_count != vn_count || data->faces.count != faces.count || data->optimised != optimised || data->vertexBufferSize() != vertexBytes) {
+                free(vertexData);
+                free(faceData);
+                THROW ResourceError("Model '%s' no longer matches its uploaded geometry, unable to restore host copy, in Entity::restoreHostGeometry()\n", modelPath);
+            }
+            memcpy(vertexData, data->positions.data, vertexBytes);
+            memcpy(faceData, data->faces.data, faceBytes);
+        }
+        mesh->positions.data = vertexData;
+        mesh->normals.data = normals.count ? reinterpret_cast<char*>(vertexData) + normals.offset : nullptr;
+        mesh->colors.data = colors.count ? reinterpret_cast<char*>(vertexData) + colors.offset : nullptr;
+        mesh->texcoords.data = texcoords.count ? reinterpret_cast<char*>(vertexData) + texcoords.offset : nullptr;
+        mesh->faces.data = faceData;
+        mesh->hostResident = true;
+        releasedGeometryBytes -= mesh->hostBytes;
+        hostGeometryBytes += mesh->hostBytes;
+    }
+    // Another entity sharing the mesh may have already restored it
+    positions.data = mesh->positions.data;
+    normals.data = mesh->normals.data;
+    colors.data = mesh->colors.data;
+    texcoords.data = mesh->texcoords.data;
+    faces.data = mesh->faces.data;
+}
+void Entity::useMesh(const std::shared_ptr<Mesh> &_mesh) {
+    mesh = _mesh;
+    vn_count = mesh->vn_count;
+    positions = mesh->positions;
+    normals = mesh->normals;
+    colors = mesh->colors;
+    texcoords = mesh->texcoords;
+    faces = mesh->faces;
+    devicePositions = mesh->devicePositions;
+    deviceNormals = mesh->deviceNormals;
+    deviceColors = mesh->deviceColors;
+    deviceTexcoords = mesh->deviceTexcoords;
+    indexType = mesh->indexType;
+    modelMin = mesh->modelMin;
+    modelMax = mesh->modelMax;
+    boundingRadius = mesh->boundingRadius;
+    mtllib = mesh->mtllib;
+    usemtl = mesh->usemtl;
+    sourceSize = mesh->sourceSize;
+    sourceHash = mesh->sourceHash;
+    optimised = mesh->optimised;
+    subMeshes = mesh->subMeshes;
+    modelMaterials = mesh->modelMaterials;
+}
+void Entity::detachMesh() {
+    restoreHostGeometry();
+    bool registered = false;
+    {
+        std::lock_guard<std::mutex> lock(meshesMutex);
+        auto it = meshes.find(meshKey());
+        registered = it != meshes.end() && it->second.lock() == mesh;
+    }
+    if (!registered && !mesh->mapping)
+        return;
+    // Take a private copy of the host buffers, and upload them to new buffer objects
+    const size_t vertexBytes = hostVertexBytes();
+    const size_t faceBytes = faces.count * faces.components * faces.componentSize;
+    void *vertexCopy = malloc(vertexBytes);
+    memcpy(vertexCopy, positions.data, vertexBytes);
+    void *faceCopy = malloc(faceBytes);
+    memcpy(faceCopy, faces.data, faceBytes);
+    positions.data = vertexCopy;
+    normals.data = normals.count ? reinterpret_cast<char*>(positions.data) + normals.offset : nullptr;
+    colors.data = colors.count ? reinterpret_cast<char*>(positions.data) + colors.offset : nullptr;
+    texcoords.data = texcoords.count ? reinterpret_cast<char*>(positions.data) + texcoords.offset : nullptr;
+    faces.data = faceCopy;
+    positions.vbo = 0;
+    faces.vbo = 0;
+    generateVertexBufferObjects();
+    mesh = createMesh(nullptr);
+    // Point shaders at the new buffer objects
+    for (auto &&it : this->shaders) {
+        if (it) {
+            it->setPositionsAttributeDetail(devicePositions);
+            it->setNormalsAttributeDetail(deviceNormals);
+            it->setColorsAttributeDetail(deviceColors);
+            it->setTexCoordsAttributeDetail(deviceTexcoords);
+            it->setFaceVBO(faces.vbo);
+        }
+    }
+    for (auto &&m : materials) {
+        if (auto it = m.getShaders()) {
+            it->setPositionsAttributeDetail(devicePositions);
+            it->setNormalsAttributeDetail(deviceNormals);
+            it->setColorsAttributeDetail(deviceColors);
+            it->setTexCoordsAttributeDetail(deviceTexcoords);
+            it->setFaceVBO(faces.vbo);
+        }
+    }
+}
+
+namespace {
+/**
+ * Content hash of a source model file, stored in binary exports to detect when the source has changed
+ * Consumes 8 bytes per step, so hashing is cheap relative to parsing
+ */
+uint64_t hashModelSource(const char *data, const size_t length) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ length;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t k;
+        memcpy(&k, data + i, sizeof(uint64_t));
+        k *= 0xFF51AFD7ED558CCDull;
+        k ^= k >> 32;
+        h = (h ^ k) * 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 29;
+    }
+    for (; i < length; ++i) {
+        h = (h ^ static_cast<unsigned char>(data[i])) * 0x100000001B3ull;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h;
+}
+/**
+ * Powers of 10 which are exactly representable as double
+ */
+const double POW10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+/**
+ * Returns true if c is whitespace which may separate the tokens of an .obj line
+ */
+inline bool isObjSpace(const char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+inline void skipObjSpace(const char *&s, const char *end) {
+    while (s < end && isObjSpace(*s))
+        ++s;
+}
+/**
+ * Moves s to the first char of the next line
+ */
+inline void skipObjLine(const char *&s, const char *end) {
+    const char *nl = static_cast<const char *>(memchr(s, '\n', end - s));
+    s = nl ? nl + 1 : end;
+}
+/**
+ * Locale independent float parser, atof() obeys the C locale's decimal separator
+ * Accepts [+-]digits[.digits][(e|E)[+-]digits], as well as the forms without integer or fraction digits
+ * @param s Pointer to the first char of the number, on success this is moved to the char following the number
+ * @param end End of the buffer being parsed
+ * @param out Variable to store the parsed value in
+ * @return False if s does not point to a number
+ */
+bool parseObjFloat(const char *&s, const char *end, float &out) {
+    const char *p = s;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    // Accumulate up to 19 significant digits, which always fit in uint64_t
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool anyDigits = false;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        anyDigits = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa)
+                ++digits;
+        } else {
+            ++exponent;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+            anyDigits = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa)
+                    ++digits;
+                --exponent;
+            }
+        }
+    }
+    if (!anyDigits)
+        return false;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *e = p + 1;
+        bool negativeExp = false;
+        if (e < end && (*e == '-' || *e == '+')) {
+            negativeExp = *e == '-';
+            ++e;
+        }
+        if (e < end && *e >= '0' && *e <= '9') {
+            int exp = 0;
+            for (; e < end && *e >= '0' && *e <= '9'; ++e) {
+                if (exp < 10000)
+                    exp = exp * 10 + (*e - '0');
+            }
+            exponent += negativeExp ? -exp : exp;
+            p = e;
+        }
+    }
+    double value = static_cast<double>(mantissa);
+    if (value != 0.0) {
+        if (exponent < 0) {
+            value = exponent >= -22 ? value / POW10[-exponent] : value * std::pow(10.0, exponent);
+        } else if (exponent > 0) {
+            value = exponent <= 22 ? value * POW10[exponent] : value * std::pow(10.0, exponent);
+        }
     }
+    out = static_cast<float>(negative ? -value : value);
+    s = p;
+    return true;
+}
+/**
+ * Parses a (1-indexed, optionally negative) .obj element index
+ * @param s Pointer to the first char of the index, on success this is moved to the char following the index
+ * @param end End of the buffer being parsed
+ * @param out Variable to store the parsed value in
+ * @return False if s does not point to an integer
+ */
+bool parseObjIndex(const char *&s, const char *end, int64_t &out) {
+    const char *p = s;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    if (p >= end || *p < '0' || *p > '9')
+        return false;
+    int64_t value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        if (value < INT32_MAX)
+            value = value * 10 + (*p - '0');
+    }
+    out = negative ? -value : value;
+    s = p;
+    return true;
+}
+/**
+ * Returns true if the line at s begins with the keyword tag, followed by whitespace
+ * On success s is moved to the char following the keyword
+ */
+inline bool matchObjKeyword(const char *&s, const char *end, const char *tag) {
+    const size_t len = strlen(tag);
+    if (static_cast<size_t>(end - s) > len && memcmp(s, tag, len) == 0 && isObjSpace(s[len])) {
+        s += len;
+        return true;
+    }
+    return false;
+}
+/**
+ * Returns the remainder of the line at s, with surrounding whitespace trimmed
+ */
+std::string readObjName(const char *s, const char *end) {
+    skipObjSpace(s, end);
+    const char *e = s;
+    while (e < end && *e != '\n')
+        ++e;
+    while (e > s && isObjSpace(*(e - 1)))
+        --e;
+    return std::string(s, e);
+}
+/**
+ * Minimum size of the chunks which an .obj file is split into for parallel parsing
+ */
+const size_t OBJ_CHUNK_SIZE = 4 * 1024 * 1024;
+/**
+ * Elements parsed from a range of whole lines of an .obj file
+ * Negative (relative) face indices are resolved against the chunk's own elements, so may be negative until the chunk
+ * is merged and the number of elements in preceding chunks is known
+ */
+struct ObjChunk {
+    // Flags of each face corner, shifted left by the index's component (0: vertex, 1: normal, 2: texcoord)
+    static const uint8_t RELATIVE = 1 << 0;
+    static const uint8_t PRESENT = 1 << 3;
+    // Positions and colors are stored with 4 components, normals with 3 and texcoords with 3
+    std::vector<float> vertices, colors, normals, texcoords;
+    // Vertex, normal and texcoord index of each corner of each triangle
+    std::vector<int32_t> corners;
+    std::vector<uint8_t> flags;
+    unsigned int positionComponents = 3, colorComponents = 0, texcoordComponents = 2;
+    unsigned int colorsRead = 0, parametersRead = 0;
+    bool hasNormals = false, hasTexcoords = false;
+    // First material library and material name found within the chunk
+    std::string mtllib, usemtl;
 };
-}  // namespace std
+/**
+ * Parses the lines of an .obj file between s and end
+ * @param s Pointer to the first char of a line
+ * @param end Pointer to the char following the last line
+ * @param out Chunk to store the parsed elements in
+ * @param modelPath Path to the model, used in error messages
+ */
+void parseObjChunk(const char *s, const char *const end, ObjChunk &out, const std::string &modelPath) {
+    // Reserve an estimate of the required storage, a line of an .obj is rarely shorter than 24 bytes
+    out.vertices.reserve((end - s) / 24);
+    out.corners.reserve((end - s) / 24);
+    // Single pass over the chunk, by line
+    while (s < end) {
+        skipObjSpace(s, end);
+        if (s >= end)
+            break;
+        switch (*s) {
+        case 'v':
+            ++s;
+            if (s < end && isObjSpace(*s)) {
+                // Vertex, 3-4 position components, optionally followed by 3-4 color components
+                float v[8];
+                unsigned int componentsRead = 0;
+                while (componentsRead < 8) {
+                    skipObjSpace(s, end);
+                    if (!parseObjFloat(s, end, v[componentsRead]))
+                        break;
+                    ++componentsRead;
+                }
+                if (componentsRead < 3) {
+                    THROW ResourceError("Model '%s' contains a vertex with %u components, 3-4 are expected.", modelPath.c_str(), componentsRead);
+                }
+                // Workout vertex and colour sizes
+                unsigned int posComponents = 3, colComponents = 0;
+                switch (componentsRead) {
+                case 8:
+                    colComponents = 4;
+                    posComponents = 4;
+                    break;
+                case 7:
+                    posComponents = 4;
+                    colComponents = 3;
+                    break;
+                case 6:
+                    colComponents = 3;
+                    break;
+                case 4:
+                case 5:
+                    posComponents = 4;
+                    break;
+                }
+                out.positionComponents = std::max(out.positionComponents, posComponents);
+                out.colorComponents = std::max(out.colorComponents, colComponents);
+                out.vertices.insert(out.vertices.end(), { v[0], v[1], v[2], posComponents == 4 ? v[3] : 1.0f });
+                if (colComponents) {
+                    const float *c = v + posComponents;
+                    out.colors.insert(out.colors.end(), { c[0], c[1], c[2], colComponents == 4 ? c[3] : 1.0f });
+                    ++out.colorsRead;
+                }
+            } else if (s < end && *s == 'n') {
+                // Normal, 3 components
+                ++s;
+                float n[NORMALS_SIZE] = { 0.0f };
+                for (unsigned int k = 0; k < NORMALS_SIZE; ++k) {
+                    skipObjSpace(s, end);
+                    if (!parseObjFloat(s, end, n[k]))
+                        break;
+                }
+                out.normals.insert(out.normals.end(), n, n + NORMALS_SIZE);
+            } else if (s < end && *s == 't') {
+                // Texture coordinate, 2-3 components (the optional 3rd component may be wrapped in [])
+                ++s;
+                float t[3] = { 0.0f };
+                unsigned int componentsRead = 0;
+                while (componentsRead < 3) {
+                    while (s < end && (isObjSpace(*s) || *s == '[' || *s == ']'))
+                        ++s;
+                    if (!parseObjFloat(s, end, t[componentsRead]))
+                        break;
+                    ++componentsRead;
+                }
+                out.texcoordComponents = std::max(out.texcoordComponents, componentsRead);
+                out.texcoords.insert(out.texcoords.end(), t, t + 3);
+            } else if (s < end && *s == 'p') {
+                // Parameter found, we don't support this but count anyway
+                out.parametersRead++;
+            }
+            break;
+        case 'f': {
+            ++s;
+            // Face, each vertex is of the form 'v', 'v/t', 'v//n' or 'v/t/n'
+            // Polygons with more than 3 vertices are triangulated as a fan
+            unsigned int cornersRead = 0;
+            int32_t first[3] = { 0, 0, 0 }, prev[3] = { 0, 0, 0 };
+            uint8_t firstFlags = 0, prevFlags = 0;
+            while (true) {
+                skipObjSpace(s, end);
+                int64_t index[3] = { 0, 0, 0 };
+                if (!parseObjIndex(s, end, index[0]))
+                    break;
+                bool present[3] = { true, false, false };
+                if (s < end && *s == '/') {
+                    ++s;
+                    present[2] = parseObjIndex(s, end, index[2]);
+                    if (s < end && *s == '/') {
+                        ++s;
+                        present[1] = parseObjIndex(s, end, index[1]);
+                    }
+                }
+                out.hasTexcoords |= present[2];
+                out.hasNormals |= present[1];
+                // Convert to 0-index, negative indices are relative to the end of the elements read so far
+                const int64_t counts[3] = {
+                    static_cast<int64_t>(out.vertices.size() / 4),
+                    static_cast<int64_t>(out.normals.size() / NORMALS_SIZE),
+                    static_cast<int64_t>(out.texcoords.size() / 3) };
+                int32_t corner[3];
+                uint8_t cornerFlags = 0;
+                for (unsigned int k = 0; k < 3; ++k) {
+                    if (!present[k]) {
+                        corner[k] = 0;
+                        continue;
+                    }
+                    cornerFlags |= ObjChunk::PRESENT << k;
+                    if (index[k] < 0) {
+                        cornerFlags |= ObjChunk::RELATIVE << k;
+                        corner[k] = static_cast<int32_t>(counts[k] + index[k]);
+                    } else if (index[k] == 0) {
+                        THROW ResourceError("Model '%s' contains a face which references an element that does not exist.", modelPath.c_str());
+                    } else {
+                        corner[k] = static_cast<int32_t>(index[k] - 1);
+                    }
+                }
+                if (cornersRead == 0) {
+                    std::copy(corner, corner + 3, first);
+                    firstFlags = cornerFlags;
+                } else if (cornersRead >= 2) {
+                    out.corners.insert(out.corners.end(), { first[0], first[1], first[2], prev[0], prev[1], prev[2], corner[0], corner[1], corner[2] });
+                    out.flags.insert(out.flags.end(), { firstFlags, prevFlags, cornerFlags });
+                }
+                std::copy(corner, corner + 3, prev);
+                prevFlags = cornerFlags;
+                ++cornersRead;
+            }
+            break;
+        }
+        case 'm':
+            if (out.mtllib.empty() && matchObjKeyword(s, end, "mtllib"))
+                out.mtllib = readObjName(s, end);
+            break;
+        case 'u':
+            if (out.usemtl.empty() && matchObjKeyword(s, end, "usemtl"))
+                out.usemtl = readObjName(s, end);
+            break;
+        }
+        // Speed to the end of the line and begin next iteration
+        skipObjLine(s, end);
+    }
+}
+}  // namespace
 
-namespace flamegpu {
-namespace visualiser {
 /*
-Used by loadModelFromFile() in a hashmap of vertex-normal pairs
+Used by loadModelFromFile() to deduplicate the vertex/normal/texcoord index triples referenced by faces
+Open addressing (linear probing) hash table, with capacity fixed at construction from the number of face vertices
 */
-struct eqVN_PAIR {
-    bool operator()(const VN_PAIR &t1, const VN_PAIR &t2) const {
-        return t1.v == t2.v &&
-            t1.n == t2.n &&
-            t1.t == t2.t;
+class VertexDedupTable {
+ public:
+    static constexpr unsigned int EMPTY = UINT_MAX;
+    /**
+     * @param maxEntries The maximum number of unique triples which will be inserted (e.g. the number of face vertices)
+     */
+    explicit VertexDedupTable(const size_t maxEntries) {
+        // Keep the load factor at or below 0.5, so probe sequences stay short
+        size_t capacity = 16;
+        while (capacity < maxEntries * 2)
+            capacity <<= 1;
+        mask = capacity - 1;
+        slots.resize(capacity, Slot{0, 0, 0, EMPTY});
     }
+    /**
+     * Returns the id assigned to the triple (v, n, t), assigning it nextId if it has not been seen before
+     * @param inserted Set true if the triple was not previously present
+     */
+    unsigned int findOrInsert(const unsigned int v, const unsigned int n, const unsigned int t, const unsigned int nextId, bool &inserted) {
+        size_t i = static_cast<size_t>(hash(v, n, t)) & mask;
+        while (true) {
+            Slot &s = slots[i];
+            if (s.id == EMPTY) {
+                s = Slot{v, n, t, nextId};
+                inserted = true;
+                return nextId;
+            }
+            if (s.v == v && s.n == n && s.t == t) {
+                inserted = false;
+                return s.id;
+            }
+            i = (i + 1) & mask;
+        }
+    }
+
+ private:
+    struct Slot {
+        unsigned int v, n, t, id;
+    };
+    /**
+     * Combines the triple into a single 64-bit key, and finalises it with the splitmix64/murmur3 mixer
+     * so that all bits of each index influence the low bits used to select a slot
+     */
+    static uint64_t hash(const unsigned int v, const unsigned int n, const unsigned int t) {
+        uint64_t k = (static_cast<uint64_t>(v) << 32 | n) ^ (static_cast<uint64_t>(t) * 0x9E3779B97F4A7C15ull);
+        k ^= k >> 30;
+        k *= 0xBF58476D1CE4E5B9ull;
+        k ^= k >> 27;
+        k *= 0x94D049BB133111EBull;
+        k ^= k >> 31;
+        return k;
+    }
+    std::vector<Slot> slots;
+    size_t mask;
 };
 /*
-Loads and scales the specified model into this classes primitive storage
+Loads the specified model into this classes primitive storage
+This does not require a GL context, so may be called from a worker thread
 
 This method support most mutations of .obj files;
 Vertices: 3-4 components
 Colors: 3-4 components
 Normals: 3 components
 Textures: 2-3 components (the optional 3rd component is wrapped in [], and is expected to be 1.0)
-Faces: 3 components per, each indexing a vertex, and optionally a normal, or a normal and a texture.
-The attributes that support variable length chars are designed according to the wikipedia spec
+Faces: 3 or more vertices per, each indexing a vertex, and optionally a texture and/or normal (faces with more than 3 vertices are triangulated)
+Indices may be negative, in which case they are relative to the most recently read element
+The file is memory mapped and split at line boundaries into chunks, which are parsed in parallel by the thread pool then merged
+Numbers are parsed independent of the C locale
 */
-void Entity::loadModelFromFile() {
-    // Redirect pre-exported models, and cancel if not .obj
-    if (su::endsWith(modelPath, OBJ_TYPE, false)) {
-        std::string exportPath(modelPath);
-        std::string objPath(OBJ_TYPE);
-        exportPath = exportPath.substr(0, exportPath.length() - objPath.length()).append(EXPORT_TYPE);
-        {  // Attempt export path
-            FILE* file = fopen(exportPath.c_str(), "r");
-            if (file) {
-                fclose(file);
-                importModel(exportPath.c_str());
-                return;
-            }
+void Entity::ModelData::loadModelFromFile() {
+    // Primitives are generated in memory, so have no file to locate
+    if (PrimitiveMesh::isPrimitivePath(modelPath)) {
+        loadModelFromPrimitive();
+        return;
+    }
+    // Binary exports may be loaded directly, there is no source model to validate them against
+    if (su::endsWith(modelPath, EXPORT_TYPE, false)) {
+        if (!importModel(Resources::locateFile(modelPath), false)) {
+            THROW ResourceError("Model file '%s' is not a valid binary export, aborting load.\n", modelPath.c_str());
         }
-        {  // Attempt resource export (fails if provided path is absolute)
-            std::string exportModulePath = Resources::toTempDir(exportPath);
-            FILE* file = fopen(exportModulePath.c_str(), "r");
-            if (file) {
-                fclose(file);
-                importModel(exportModulePath.c_str());
-                return;
-            }
+        return;
+    }
+    if (su::endsWith(modelPath, GLB_TYPE, false)) {
+        loadModelFromGLB(Resources::locateFile(modelPath));
+        return;
+    }
+    if (!su::endsWith(modelPath, OBJ_TYPE, false)) {
+        THROW ResourceError("Model file '%s' is of an unsupported format, aborting load.\n Support types: %s, %s, %s\n", modelPath.c_str(), OBJ_TYPE, GLB_TYPE, EXPORT_TYPE);
+    }
+    // Map the file, rather than reading it through stdio a char at a time
+    // The source is always hashed, so that stale exports are never used
+    const MappedFile file(Resources::locateFile(modelPath));
+    sourceSize = file.size();
+    sourceHash = hashModelSource(file.data(), file.size());
+    // Redirect to a pre-exported model if a valid one exists
+    // Exports written by a previous load live in the temp dir, exports alongside the model may be distributed with it
+    const std::string objPath(OBJ_TYPE);
+    const std::string exportPath = modelPath.substr(0, modelPath.length() - objPath.length()).append(EXPORT_TYPE);
+    const std::string tempExportPath = Resources::toTempDir(exportPath);
+    for (const std::string &path : { tempExportPath, exportPath }) {
+        std::error_code ec;
+        if (std::filesystem::exists(path, ec) && importModel(path, true)) {
+            return;
         }
-    } else {
-        THROW ResourceError("Model file '%s' is of an unsupported format, aborting load.\n Support types: %s, %s\n", modelPath, OBJ_TYPE, EXPORT_TYPE);
     }
 
-    // Open file
-    FILE *file = Resources::fopen(modelPath, "r");
-    if (!file) {
-        THROW ResourceError("Could not open model '%s'!\n", modelPath);
+    // Split the file into chunks at line boundaries, so that they can be parsed in parallel
+    // Small files are parsed as a single chunk, on the calling thread
+    ThreadPool &pool = ThreadPool::get();
+    const char *const begin = file.data();
+    const char *const end = begin + file.size();
+    const size_t chunkCount = std::clamp<size_t>(file.size() / OBJ_CHUNK_SIZE, 1, (pool.size() + 1) * 4);
+    std::vector<const char*> bounds(chunkCount + 1, end);
+    bounds[0] = begin;
+    for (size_t i = 1; i < chunkCount; ++i) {
+        const char *b = std::max(bounds[i - 1], begin + file.size() / chunkCount * i);
+        if (b > begin && *(b - 1) != '\n')
+            skipObjLine(b, end);
+        bounds[i] = b;
     }
+    std::vector<ObjChunk> chunks(chunkCount);
+    pool.parallelFor(chunkCount, [&](const size_t i) {
+        parseObjChunk(bounds[i], bounds[i + 1], chunks[i], modelPath);
+    });
 
-    // Counters
-    unsigned int positions_read = 0;
-    unsigned int normals_read = 0;
-    unsigned int colors_read = 0;
-    unsigned int texcoords_read = 0;
-    unsigned int faces_read = 0;
-    unsigned int parameters_read = 0;
+    // Temporary buffers, positions and colors are stored with 4 components and texcoords with 3
+    // These are compacted to the number of components actually found in the file once the whole file has been read
+    std::vector<float> t_vertices, t_colors, t_normals, t_texcoords;
+    // 3 parts to each face, store the relevant vertex, norm and tex indexes
+    std::vector<unsigned int> t_vert_pos, t_norm_pos, t_tex_pos;
 
     unsigned int position_components_count = 3;
     unsigned int color_components_count = 0;
     unsigned int texcoords_components_count = 2;
+    unsigned int colors_read = 0;
+    unsigned int parameters_read = 0;
 
     bool face_hasNormals = false;
     bool face_hasTexcoords = false;
 
-    // MTL details
-    char mtllib_tag[7] = "mtllib";
-    char usemtl_tag[7] = "usemtl";
-    char *mtllib = 0;
-    char *usemtl = 0;
-    // Count vertices/faces, attributes
-    char c;
-    int dotCtr;
-    unsigned int lnLen = 0, lnLenMax = 0;  // Used to find the longest line of the file
-    // For each line of the file (the end of the loop finds the end of the line before continuing)
-    while ((c = static_cast<char>(fgetc(file))) != EOF) {
-        lnLenMax = lnLenMax < lnLen ? lnLen : lnLenMax;
-        lnLen = 1;
-        // If the first char == 'v'
-        switch (c) {
-        case 'v':
-            if ((c = static_cast<char>(fgetc(file))) == EOF)
-                goto exit_loop;
-            // If the second char == 't', 'n', 'p' or ' '
-            switch (c) {
-                // Vertex found, increment count and check whether it also contains a colour value many elements it contains
-            case ' ':
-                positions_read++;
-                dotCtr = 0;
-                // Count the number of '.', if >4 we assume there are colours
-                while ((c = static_cast<char>(fgetc(file))) != '\n') {
-                    lnLen++;
-                    if (c == EOF)
-                        goto exit_loop;
-                    else if (c == '.')
-                        dotCtr++;
-                }
-                // Workout vertex and colour sizes
-                switch (dotCtr) {
-                case 8:
-                    colors_read++;
-                    color_components_count = 4;
-                case 4:
-                    position_components_count = 4;
-                    break;
-                case 7:
-                    position_components_count = 4;
-                case 6:
-                    color_components_count = 3;
-                    colors_read++;
-                    break;
-                }
-                continue;  // Skip to next iteration, otherwise we will miss a line
-                // Normal found, increment count
-            case 'n':
-                normals_read++;
-                break;
-                // Parameter found, we don't support this but count anyway
-            case 'p':
-                parameters_read++;
-                break;
-                // Texture found, increment count and check how many components it contains
-            case 't':
-                texcoords_read++;
-                dotCtr = 0;
-                // Count the number of '.' before the next newline
-                while ((c = static_cast<char>(fgetc(file))) != '\n') {
-                    lnLen++;
-                    if (c == EOF)
-                        goto exit_loop;
-                    else if (c == '.')
-                        dotCtr++;
-                }
-                texcoords_components_count = dotCtr;
-                continue;  // Skip to next iteration, otherwise we will miss a line
-            }
-            break;
-            // If the first char is 'f', increment face count
-        case 'f':
-            faces_read++;
-            dotCtr = 0;
-            // Workout whether the format is 'v' 'v// n' or 'v/t/n'
-            while ((c = static_cast<char>(fgetc(file))) != '\n') {
-                lnLen++;
-                if (c == EOF) {
-                    goto exit_loop;
-                } else if (c == '/') {  // If we find 1 slash, check whether we find 2 in a row
-                    face_hasNormals = true;
-                    // If not two / in a row, then we have textures
-                    if ((c = static_cast<char>(fgetc(file))) != '/') {
-                        face_hasTexcoords = true;
-                        if (c == EOF)
-                            goto exit_loop;
-                    }
-                    break;
+    // Merge the chunks, each chunk's elements follow those of the preceding chunks
+    struct ChunkBase {
+        size_t vertices, colors, normals, texcoords, corners;
+    };
+    std::vector<ChunkBase> bases(chunkCount + 1, ChunkBase{ 0, 0, 0, 0, 0 });
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const ObjChunk &c = chunks[i];
+        bases[i + 1].vertices = bases[i].vertices + c.vertices.size() / 4;
+        bases[i + 1].colors = bases[i].colors + c.colors.size() / 4;
+        bases[i + 1].normals = bases[i].normals + c.normals.size() / NORMALS_SIZE;
+        bases[i + 1].texcoords = bases[i].texcoords + c.texcoords.size() / 3;
+        bases[i + 1].corners = bases[i].corners + c.flags.size();
+        position_components_count = std::max(position_components_count, c.positionComponents);
+        color_components_count = std::max(color_components_count, c.colorComponents);
+        texcoords_components_count = std::max(texcoords_components_count, c.texcoordComponents);
+        colors_read += c.colorsRead;
+        parameters_read += c.parametersRead;
+        face_hasNormals |= c.hasNormals;
+        face_hasTexcoords |= c.hasTexcoords;
+        // Only do first material found
+        if (mtllib.empty())
+            mtllib = c.mtllib;
+        if (usemtl.empty())
+            usemtl = c.usemtl;
+    }
+    const ChunkBase &totals = bases[chunkCount];
+    if (totals.vertices > INT32_MAX || totals.normals > INT32_MAX || totals.texcoords > INT32_MAX || totals.corners > UINT_MAX) {
+        THROW ResourceError("Model '%s' contains too many elements to be loaded.", modelPath.c_str());
+    }
+    t_vertices.resize(totals.vertices * 4);
+    t_colors.resize(totals.colors * 4);
+    t_normals.resize(totals.normals * NORMALS_SIZE);
+    t_texcoords.resize(totals.texcoords * 3);
+    t_vert_pos.resize(totals.corners);
+    t_norm_pos.resize(totals.corners);
+    t_tex_pos.resize(totals.corners);
+    pool.parallelFor(chunkCount, [&](const size_t i) {
+        ObjChunk &c = chunks[i];
+        const ChunkBase &base = bases[i];
+        std::copy(c.vertices.begin(), c.vertices.end(), t_vertices.begin() + base.vertices * 4);
+        std::copy(c.colors.begin(), c.colors.end(), t_colors.begin() + base.colors * 4);
+        std::copy(c.normals.begin(), c.normals.end(), t_normals.begin() + base.normals * NORMALS_SIZE);
+        std::copy(c.texcoords.begin(), c.texcoords.end(), t_texcoords.begin() + base.texcoords * 3);
+        // Rebase relative indices onto the elements of preceding chunks, and validate all indices
+        // As elements are only counted once every chunk has been parsed, forward references are not rejected
+        const int64_t elementBase[3] = { static_cast<int64_t>(base.vertices), static_cast<int64_t>(base.normals), static_cast<int64_t>(base.texcoords) };
+        const int64_t elementCount[3] = { static_cast<int64_t>(totals.vertices), static_cast<int64_t>(totals.normals), static_cast<int64_t>(totals.texcoords) };
+        unsigned int *const out[3] = { t_vert_pos.data() + base.corners, t_norm_pos.data() + base.corners, t_tex_pos.data() + base.corners };
+        for (size_t j = 0; j < c.flags.size(); ++j) {
+            for (unsigned int k = 0; k < 3; ++k) {
+                int64_t index = c.corners[j * 3 + k];
+                if (c.flags[j] & (ObjChunk::RELATIVE << k))
+                    index += elementBase[k];
+                if ((c.flags[j] & (ObjChunk::PRESENT << k)) && (index < 0 || index >= elementCount[k])) {
+                    THROW ResourceError("Model '%s' contains a face which references an element that does not exist.", modelPath.c_str());
                 }
+                out[k][j] = static_cast<unsigned int>(index);
             }
-            break;
         }
-        // Speed to the end of the line and begin next iteration
-        while (c != '\n') {
-            lnLen++;
-            if (c == EOF)
-                goto exit_loop;
-            c = static_cast<char>(fgetc(file));
-        }
-        // printf("\rVert: %i:%i, Normal: %i, Face: %i, Tex: %i:%i, Color: %i:%i, Ln:%i", vertices_read, vertices_size, normals_read, faces_read, textures_read, textures_size, colors_read, colors_size, lnLenMax);
-    }
-exit_loop: {}
-    lnLenMax = lnLenMax < lnLen ? lnLen : lnLenMax;
+        // Release the chunk's storage as soon as it has been merged
+        c = ObjChunk();
+    });
+    chunks.clear();
 
     if (parameters_read > 0) {
-        THROW ResourceError("Model '%s' contains parameter space vertices, these are unsupported at this time.", modelPath);
+        THROW ResourceError("Model '%s' contains parameter space vertices, these are unsupported at this time.", modelPath.c_str());
     }
 
     // Set instance var counts
-    positions.count = positions_read;
+    positions.count = static_cast<unsigned int>(t_vertices.size() / 4);
     colors.count = colors_read;
-    normals.count = normals_read;
-    texcoords.count = texcoords_read;
-    faces.count = faces_read;
+    normals.count = face_hasNormals ? static_cast<unsigned int>(t_normals.size() / NORMALS_SIZE) : 0;
+    texcoords.count = face_hasTexcoords ? static_cast<unsigned int>(t_texcoords.size() / 3) : 0;
+    faces.count = static_cast<unsigned int>(t_vert_pos.size() / FACES_SIZE);
     if (positions.count == 0 || faces.count == 0) {
-        fclose(file);
-        THROW ResourceError("Vertex or face data missing.\nAre you sure that '%s' is a wavefront (.obj) format model?\n", modelPath);
+        THROW ResourceError("Vertex or face data missing.\nAre you sure that '%s' is a wavefront (.obj) format model?\n", modelPath.c_str());
     }
     if ((colors.count != 0 && positions.count != colors.count)) {
         fprintf(stderr, "Vertex color count does not match vertex count, vertex colors will be ignored.\n");
@@ -527,330 +1453,35 @@ exit_loop: {}
     faces.components = FACES_SIZE;
     positions.components = position_components_count;  // 3-4
     texcoords.components = texcoords_components_count;  // 2-3
-    colors.components = color_components_count;  // 3-4
+    colors.components = colors.count ? color_components_count : 0;  // 3-4
     // Allocate faces
     faces.data = malloc(faces.count*faces.components*faces.componentSize);
-    // Reset file pointer
-    clearerr(file);
-    fseek(file, 0, SEEK_SET);
-    // Allocate temporary buffers for components that may require aligning with relevant vertices
-    float *t_vertices = reinterpret_cast<float *>(malloc(positions.count * positions.components * positions.componentSize));
-    float *t_colors = reinterpret_cast<float *>(malloc(colors.count * colors.components * colors.componentSize));
-    float *t_normals = reinterpret_cast<float *>(malloc(normals.count * normals.components * normals.componentSize));
-    float *t_texcoords = reinterpret_cast<float *>(malloc(texcoords.count * texcoords.components * texcoords.componentSize));
-    // 3 parts to each face, store the relevant norm and tex indexes
-    unsigned int *t_norm_pos = 0;
-    if (face_hasNormals)
-        t_norm_pos = reinterpret_cast<unsigned int *>(malloc(faces.count * faces.components * faces.componentSize));
-    else
-        normals.count = 0;
-    unsigned int *t_tex_pos = 0;
-    if (face_hasTexcoords)
-        t_tex_pos = reinterpret_cast<unsigned int *>(malloc(faces.count * faces.components * faces.componentSize));
-    else
-        texcoords.count = 0;
-    // Reset local counters
-    positions_read = 0;
-    colors_read = 0;
-    normals_read = 0;
-    texcoords_read = 0;
-    faces_read = 0;
-    unsigned int componentsRead = 0;
-    unsigned int componentLength = 0;
-    // Create buffer to read lines of the file into
-    unsigned int bufferLen = lnLenMax + 2;
-    char *buffer = new char[bufferLen];
-
-    modelMin = glm::vec3(FLT_MAX);
-    modelMax = glm::vec3(-FLT_MAX);
-    // Read file by line, again.
-    while ((c = static_cast<char>(fgetc(file))) != EOF) {
-        // If the first char == 'v'
-        switch (c) {
-        case 'v':
-            if ((c = static_cast<char>(fgetc(file))) == EOF)
-                goto exit_loop;
-            // If the second char == 't', 'n', 'p' or ' '
-            switch (c) {
-            case ' ':
-                // Read vertex line of file
-                componentsRead = 0;
-                // Read all vertex components
-                do {
-                    // Find the first char
-                    while ((c = static_cast<char>(fgetc(file))) != EOF) {
-                        if (c != ' ')
-                            break;
-                    }
-                    // Fill buffer with the vertex components
-                    componentLength = 0;
-                    do {
-                        if (c == EOF)
-                            goto exit_loop2;
-                        buffer[componentLength] = c;
-                        componentLength++;
-                    } while (((c = static_cast<char>(fgetc(file))) >= '0' && c <= '9') || c == '.');
-                    // End component string
-                    buffer[componentLength] = '\0';
-                    // Load it into the vert array
-                    t_vertices[(positions_read * positions.components) + componentsRead] = static_cast<float>(atof(buffer));
-                    // Check for model min/max
-                    if (t_vertices[(positions_read * positions.components) + componentsRead] > modelMax[componentsRead])
-                        modelMax[componentsRead] = t_vertices[(positions_read * positions.components) + componentsRead];
-                    if (t_vertices[(positions_read * positions.components) + componentsRead] < modelMin[componentsRead])
-                        modelMin[componentsRead] = t_vertices[(positions_read * positions.components) + componentsRead];
-                    componentsRead++;
-                } while (componentsRead < positions.components);
-                positions_read++;
-                if (c == '\n')
-                    continue;
-                componentsRead = 0;
-                // Read all color components (if required)
-                while (componentsRead < colors.components) {
-                    // Find the first char
-                    while ((c = static_cast<char>(fgetc(file))) != EOF) {
-                        if (c != ' ')
-                            break;
-                    }
-                    // Fill buffer with the color components
-                    componentLength = 0;
-                    do {
-                        if (c == EOF)
-                            goto exit_loop2;
-                        buffer[componentLength] = c;
-                        componentLength++;
-                    } while (((c = static_cast<char>(fgetc(file))) >= '0' && c <= '9') || c == '.');
-                    // End component string
-                    buffer[componentLength] = '\0';
-                    // Load it into the color array
-                    t_colors[(colors_read * colors.components) + componentsRead] = static_cast<float>(atof(buffer));  // t_colors
-                    componentsRead++;
-                }
-                // If we read a color, increment count
-                if (componentsRead > 0)
-                    colors_read++;
-                if (c == '\n')
-                    continue;
-                // Speed to the end of the vertex line
-                while ((c = static_cast<char>(fgetc(file))) != '\n') {
-                    if (c == EOF)
-                        goto exit_loop2;
-                }
-                continue;  // Skip to next iteration, otherwise we will miss a line
-            case 'n':
-                // Read normal line of file
-                componentsRead = 0;
-                // Read all components
-                do {
-                    // Find the first char
-                    while ((c = static_cast<char>(fgetc(file))) != EOF) {
-                        if (c != ' ')
-                            break;
-                    }
-                    // Fill buffer with the normal components
-                    componentLength = 0;
-                    do {
-                        if (c == EOF)
-                            goto exit_loop2;
-                        buffer[componentLength] = c;
-                        componentLength++;
-                    } while (((c = static_cast<char>(fgetc(file))) >= '0' && c <= '9') || c == '.');
-                    // End component string
-                    buffer[componentLength] = '\0';
-                    // Load it into the temporary normal array
-                    t_normals[(normals_read * normals.components) + componentsRead] = static_cast<float>(atof(buffer));
-                    componentsRead++;
-                } while (componentsRead < normals.components);
-                normals_read++;
-                if (c == '\n')
-                    continue;
-                // Speed to the end of the normal line
-                while ((c = static_cast<char>(fgetc(file))) != '\n') {
-                    if (c == EOF)
-                        goto exit_loop2;
-                }
-                continue;  // Skip to next iteration, otherwise we will miss a line
-            case 't':
-                // Read texture line of file
-                componentsRead = 0;
-                // Read all components
-                do {
-                    // Find the first char
-                    while ((c = static_cast<char>(fgetc(file))) != EOF) {
-                        if (c >= '0'&&c <= '9')
-                            break;
-                    }
-                    // Fill buffer with the vert/tex/norm index components
-                    componentLength = 0;
-                    do {
-                        if (c == EOF)
-                            goto exit_loop2;
-                        buffer[componentLength] = c;
-                        componentLength++;
-                    } while (((c = static_cast<char>(fgetc(file))) >= '0' && c <= '9') || c == '.');
-                    // End component string
-                    buffer[componentLength] = '\0';
-                    // Load it into the temporary textures array
-                    t_texcoords[(texcoords_read * texcoords.components) + componentsRead] = static_cast<float>(atof(buffer));
-                    componentsRead++;
-                } while (componentsRead < texcoords.components);
-                texcoords_read++;
-                if (c == '\n') {
-                    continue;
-                }
-                // Speed to the end of the texture line
-                while ((c = static_cast<char>(fgetc(file))) != '\n') {
-                    if (c == EOF)
-                        goto exit_loop2;
-                }
-                continue;  // Skip to next iteration, otherwise we will miss a line
-            }
-            break;
-            // If the first char is 'f', increment face count
-        case 'f':
-            // Read face line of file
-            componentsRead = 0;
-            // Read all components
-            do {
-                // Find the first char
-                while ((c = static_cast<char>(fgetc(file))) != EOF) {
-                    if (c >= '0' && c <= '9')
-                        break;
-                }
-                // Fill buffer with the components
-                componentLength = 0;
-                do {
-                    if (c == EOF)
-                        goto exit_loop2;
-                    buffer[componentLength] = c;
-                    componentLength++;
-                } while ((c = static_cast<char>(fgetc(file))) >= '0' && c <= '9');
-                // End component string
-                buffer[componentLength] = '\0';
-                // Decide which array to load it into (faces, tex pos, norm pos)
-                switch (componentsRead % (1 + static_cast<int>(face_hasNormals) + static_cast<int>(face_hasTexcoords))) {
-                    // This is a vertex index
-                case 0:  // Decrease value by 1, obj is 1-index, our arrays are 0-index
-                    reinterpret_cast<unsigned int *>(faces.data)[(faces_read*faces.components) + (componentsRead / (1 + static_cast<int>(face_hasNormals) + static_cast<int>(face_hasTexcoords)))]
-                    = static_cast<unsigned int>(std::strtoul(buffer, nullptr, 0)) - 1;
-                    break;
-                    // This is a normal index
-                case 1:
-                    if (face_hasTexcoords) {  // Drop #2nd item onto texture if we have no normals
-                        t_tex_pos[(faces_read*faces.components) + (componentsRead / (1 + static_cast<int>(face_hasNormals) + static_cast<int>(face_hasTexcoords)))] = static_cast<unsigned int>(std::strtoul(buffer, nullptr, 0)) - 1;
-                        break;
-                    }
-                case 2:
-                    t_norm_pos[(faces_read*faces.components) + (componentsRead / (1 + static_cast<int>(face_hasNormals) + static_cast<int>(face_hasTexcoords)))] = static_cast<unsigned int>(std::strtoul(buffer, nullptr, 0)) - 1;
-                    break;
-                    // This is a texture index
-                }
-                componentsRead++;
-            } while (componentsRead < static_cast<unsigned int>((1 + static_cast<int>(face_hasNormals) + static_cast<int>(face_hasTexcoords))) * FACES_SIZE);
-            faces_read++;
-            if (c == '\n') {
-                continue;
-            }
-        case 'm':
-            // Only do first material found
-            if (mtllib)
-                break;
-            // Check for mtllib tag
-            for (unsigned int i = 1; i < (sizeof(mtllib_tag) / sizeof(c)) - 1; i++) {
-                if ((c = static_cast<char>(fgetc(file))) != mtllib_tag[i]) {
-                    // Break if tag ends early
-                    break;
-                }
-                if (c == EOF)
-                    goto exit_loop;
-                if (c == mtllib_tag[(sizeof(mtllib_tag) / sizeof(c)) - 2]) {
-                    // Find the first char
-                    while ((c = static_cast<char>(fgetc(file))) != EOF) {
-                        if (c != ' ')
-                            break;
-                    }
-                    // Fill buffer with the vert/tex/norm index components
-                    componentLength = 0;
-                    do {
-                        if (c == EOF)
-                            goto exit_loop2;
-                        buffer[componentLength] = c;
-                        componentLength++;
-                    } while ((c = static_cast<char>(fgetc(file))) != ' ' && c != '\r' && c != '\n');
-                    buffer[componentLength] = '\0';
-                    componentLength++;
-                    // Memcpy buffer to local storage
-                    mtllib = reinterpret_cast<char*>(malloc(componentLength * sizeof(char)));
-                    memcpy(mtllib, buffer, componentLength*sizeof(char));
-                }
-            }
-            break;
-        case 'u':
-            // Only do first material found
-            if (usemtl)
-                break;
-            // Check for usemtl tag
-            for (unsigned int i = 1; i < (sizeof(usemtl_tag) / sizeof(c)) - 1; i++) {
-                if ((c = static_cast<char>(fgetc(file))) != usemtl_tag[i]) {
-                    // Break if tag ends early
-                    break;
-                }
-                if (c == EOF)
-                    goto exit_loop;
-                if (c == usemtl_tag[(sizeof(usemtl_tag) / sizeof(c)) - 2]) {
-                    // Find the first char
-                    while ((c = static_cast<char>(fgetc(file))) != EOF) {
-                        if (c != ' ')
-                            break;
-                    }
-                    // Fill buffer with the vert/tex/norm index components
-                    componentLength = 0;
-                    do {
-                        if (c == EOF)
-                            goto exit_loop2;
-                        buffer[componentLength] = c;
-                        componentLength++;
-                    } while ((c = static_cast<char>(fgetc(file))) != ' ' && c != '\r' && c != '\n');
-                    buffer[componentLength] = '\0';
-                    componentLength++;
-                    // Memcpy buffer to local storage
-                    usemtl = reinterpret_cast<char*>(malloc(componentLength * sizeof(char)));
-                    memcpy(usemtl, buffer, componentLength*sizeof(char));
-                }
-            }
-            break;
-        }
-        // Speed to the end of the line and begin next iteration
-        while (c != '\n') {
-            lnLen++;
-            c = static_cast<char>(fgetc(file));
-            if (c == EOF)
-                goto exit_loop2;
+    // Assign an id to each unique vertex/normal/texcoord triple, in order of first use
+    // The face vertex which first used each id is recorded, so the attributes can be copied once the buffer is allocated
+    std::vector<unsigned int> vn_source;
+    {
+        VertexDedupTable vn_pairs(faces.count * faces.components);
+        for (unsigned int i = 0; i < faces.count * faces.components; i++) {
+            bool inserted;
+            const unsigned int id = vn_pairs.findOrInsert(t_vert_pos[i], face_hasNormals ? t_norm_pos[i] : 0, face_hasTexcoords ? t_tex_pos[i] : 0, static_cast<unsigned int>(vn_source.size()), inserted);
+            if (inserted)
+                vn_source.push_back(i);
+            // Update index from face
+            reinterpret_cast<unsigned int *>(faces.data)[i] = id;
         }
     }
-exit_loop2: {}
-    // Cleanup buffer
-    delete[] buffer;
-    auto vn_pairs = new google::dense_hash_map<VN_PAIR, unsigned int, std::hash < VN_PAIR>, eqVN_PAIR>();
-    vn_pairs->set_empty_key({ UINT_MAX, UINT_MAX, UINT_MAX });
-    vn_pairs->resize(faces.count*faces.components);
-    // Calculate the number of unique vertex-normal pairs
-    for (unsigned int i = 0; i < faces.count*faces.components; i++) {
-        if (face_hasTexcoords)
-            (*vn_pairs)[{reinterpret_cast<unsigned int *>(faces.data)[i], t_norm_pos[i], t_tex_pos[i]}] = UINT_MAX;
-        else if (face_hasNormals)
-            (*vn_pairs)[{reinterpret_cast<unsigned int *>(faces.data)[i], t_norm_pos[i], 0}] = UINT_MAX;
-        else
-            (*vn_pairs)[{reinterpret_cast<unsigned int *>(faces.data)[i], 0, 0}] = UINT_MAX;
-    }
-    vn_count = static_cast<unsigned int>(vn_pairs->size());
+    vn_count = static_cast<unsigned int>(vn_source.size());
+    float acmrBefore = 0.0f;
+    if (optimiseModels) {
+        acmrBefore = optimiseFaces(vn_source);
+    }
 
     // Allocate instance vars from a single malloc
     unsigned int bufferSize = 0;
     bufferSize += vn_count * positions.components * positions.componentSize;
     bufferSize += (normals.count > 0) * vn_count * normals.components * normals.componentSize;
     bufferSize += (colors.count > 0) * vn_count * colors.components * colors.componentSize;
-    bufferSize += (texcoords.count > 0) * vn_count * positions.components * positions.componentSize;
+    bufferSize += (texcoords.count > 0) * vn_count * texcoords.components * texcoords.componentSize;
     positions.data = malloc(bufferSize);
     positions.count = vn_count;
     bufferSize = vn_count * positions.components * positions.componentSize;
@@ -872,77 +1503,300 @@ exit_loop2: {}
         texcoords.offset = bufferSize;
         bufferSize += vn_count * texcoords.components * texcoords.componentSize;
     }
-    // Calculate scale factor
-    this->modelDims = modelMax - modelMin;
-    this->scaleFactor = glm::vec4(1.0);
-    if (SCALE.x < 0) {
-        // Special case, negative scale means scale uniformly according to longest edge
-        this->scaleFactor.x = -SCALE.x / glm::compMax(modelDims);
-        this->scaleFactor.y = scaleFactor.x;
-        this->scaleFactor.z = scaleFactor.x;
-    } else {
-        if (SCALE.x > 0) this->scaleFactor.x = SCALE.x / modelDims.x;
-        if (SCALE.y > 0) this->scaleFactor.y = SCALE.y / modelDims.y;
-        if (SCALE.z > 0) this->scaleFactor.z = SCALE.z / modelDims.z;
-    }
-    unsigned int vn_assigned = 0;
-    for (unsigned int i = 0; i < faces.count * faces.components; i++) {
-        int i_tex = face_hasTexcoords ? t_tex_pos[i] : 0;
-        int i_norm = face_hasNormals ? t_norm_pos[i] : 0;
-        int i_vert = static_cast<unsigned int *>(faces.data)[i];
-        glm::vec3 t_normalised_norm;
-        // If vn pair hasn't been assigned an id yet
-        if ((*vn_pairs)[{static_cast<unsigned int>(i_vert), static_cast<unsigned int>(i_norm), static_cast<unsigned int>(i_tex)}] == UINT_MAX) {
-            // Set all n components of vertices and attributes to that id
-            for (unsigned int k = 0; k < positions.components; k++)
-                reinterpret_cast<float*>(positions.data)[(vn_assigned*positions.components) + k] = t_vertices[(i_vert*positions.components) + k];  //  * this->scaleFactor[k];  // We now scale with model matrix
-            if (face_hasNormals) {  // Normalise normals
-                t_normalised_norm = normalize(glm::vec3(t_normals[(t_norm_pos[i] * normals.components)], t_normals[(t_norm_pos[i] * normals.components) + 1], t_normals[(t_norm_pos[i] * normals.components) + 2]));
-                for (unsigned int k = 0; k < normals.components; k++)
-                    reinterpret_cast<float*>(normals.data)[(vn_assigned*normals.components) + k] = t_normalised_norm[k];
+    // Set all n components of vertices and attributes for each id
+    for (unsigned int vn = 0; vn < vn_count; vn++) {
+        const unsigned int i = vn_source[vn];
+        const unsigned int i_tex = face_hasTexcoords ? t_tex_pos[i] : 0;
+        const unsigned int i_norm = face_hasNormals ? t_norm_pos[i] : 0;
+        const unsigned int i_vert = t_vert_pos[i];
+        for (unsigned int k = 0; k < positions.components; k++)
+            reinterpret_cast<float*>(positions.data)[(vn*positions.components) + k] = t_vertices[(i_vert * 4) + k];  //  * this->scaleFactor[k];  // We now scale with model matrix
+        if (normals.count) {  // Normalise normals
+            const glm::vec3 t_normalised_norm = normalize(glm::vec3(t_normals[(i_norm * NORMALS_SIZE)], t_normals[(i_norm * NORMALS_SIZE) + 1], t_normals[(i_norm * NORMALS_SIZE) + 2]));
+            for (unsigned int k = 0; k < normals.components; k++)
+                reinterpret_cast<float*>(normals.data)[(vn*normals.components) + k] = t_normalised_norm[k];
+        }
+        if (colors.count) {
+            for (unsigned int k = 0; k < colors.components; k++)
+                reinterpret_cast<float*>(colors.data)[(vn*colors.components) + k] = t_colors[(i_vert * 4) + k];
+        }
+        if (texcoords.count) {
+            for (unsigned int k = 0; k < texcoords.components; k++)
+                reinterpret_cast<float*>(texcoords.data)[(vn*texcoords.components) + k] = t_texcoords[(i_tex * 3) + k];
+        }
+    }
+    // Material is only used if both tags were found
+    if (mtllib.empty() || usemtl.empty()) {
+        mtllib.clear();
+        usemtl.clear();
+    }
+    if (optimised) {
+        optimiseOverdraw(acmrBefore);
+    }
+    computeBounds();
+    // Cache the parsed model, so that subsequent loads can skip parsing
+    ExportHeader header = {};
+    header.FLAGS = optimised ? EXPORT_FLAG_OPTIMISED : 0;
+    header.SOURCE_HASH = sourceHash;
+    header.SOURCE_SIZE = sourceSize;
+    header.VN_COUNT = vn_count;
+    header.FACE_COUNT = faces.count;
+    header.POSITION_COMPONENTS = static_cast<unsigned char>(positions.components);
+    header.NORMAL_COMPONENTS = static_cast<unsigned char>(normals.count ? normals.components : 0);
+    header.COLOR_COMPONENTS = static_cast<unsigned char>(colors.count ? colors.components : 0);
+    header.TEXCOORD_COMPONENTS = static_cast<unsigned char>(texcoords.count ? texcoords.components : 0);
+    header.VERTEX_SIZE = vertexBufferSize();
+    header.INDEX_SIZE = faces.count * faces.components * faces.componentSize;
+    for (int k = 0; k < 3; ++k) {
+        header.BOUNDS_MIN[k] = modelMin[k];
+        header.BOUNDS_MAX[k] = modelMax[k];
+        header.BOUNDING_SPHERE[k] = (modelMin[k] + modelMax[k]) * 0.5f;
+    }
+    header.BOUNDING_SPHERE[3] = boundingRadius;
+    writeExport(tempExportPath, header, positions.data, faces.data, mtllib, usemtl);
+}
+/*
+Reorders faces for the post-transform vertex cache, then renumbers vertices in order of first use
+Both steps depend only on the face indices, so keyframe pairs which share topology retain matching vertex orders
+*/
+float Entity::ModelData::optimiseFaces(std::vector<unsigned int> &vn_source) {
+    unsigned int *indices = reinterpret_cast<unsigned int*>(faces.data);
+    const size_t indexCount = faces.count * faces.components;
+    const float acmr = MeshOptimiser::calculateACMR(indices, indexCount, vn_count);
+    MeshOptimiser::optimiseVertexCache(indices, indexCount, vn_count);
+    const std::vector<unsigned int> remap = MeshOptimiser::optimiseVertexFetch(indices, indexCount, vn_count);
+    std::vector<unsigned int> t_vn_source(vn_count);
+    for (unsigned int vn = 0; vn < vn_count; ++vn)
+        t_vn_source[remap[vn]] = vn_source[vn];
+    vn_source.swap(t_vn_source);
+    optimised = true;
+    return acmr;
+}
+/*
+Reorders clusters of faces so that those facing outwards are drawn first, this requires positions to have been filled
+*/
+void Entity::ModelData::optimiseOverdraw(const float acmrBefore) {
+    unsigned int *indices = reinterpret_cast<unsigned int*>(faces.data);
+    const size_t indexCount = faces.count * faces.components;
+    MeshOptimiser::optimiseOverdraw(indices, indexCount, reinterpret_cast<const float*>(positions.data), positions.components, vn_count);
+    const float acmrAfter = MeshOptimiser::calculateACMR(indices, indexCount, vn_count);
+    std::lock_guard<std::mutex> lock(optimisationStatsMutex);
+    ++optimisationTotals.models;
+    optimisationTotals.acmrBefore += acmrBefore;
+    optimisationTotals.acmrAfter += acmrAfter;
+}
+/*
+Generates the primitive named by modelPath into this classes primitive storage, in the same layout as .obj models
+Primitives are cheaper to generate than to load, so are never exported or optimised
+*/
+void Entity::ModelData::loadModelFromPrimitive() {
+    const PrimitiveMesh mesh(modelPath);
+    vn_count = mesh.vertexCount();
+    positions.components = 3;
+    normals.components = NORMALS_SIZE;
+    texcoords.components = DEFAULT_TEXCOORD_SIZE;
+    faces.components = FACES_SIZE;
+    positions.count = vn_count;
+    normals.count = vn_count;
+    texcoords.count = mesh.texcoords.empty() ? 0 : vn_count;
+    faces.count = static_cast<unsigned int>(mesh.indices.size() / FACES_SIZE);
+    // Allocate instance vars from a single malloc
+    const size_t positionBytes = mesh.positions.size() * sizeof(float);
+    const size_t normalBytes = mesh.normals.size() * sizeof(float);
+    const size_t texcoordBytes = mesh.texcoords.size() * sizeof(float);
+    normals.offset = static_cast<unsigned int>(positionBytes);
+    texcoords.offset = static_cast<unsigned int>(positionBytes + normalBytes);
+    positions.data = malloc(positionBytes + normalBytes + texcoordBytes);
+    faces.data = malloc(mesh.indices.size() * sizeof(unsigned int));
+    normals.data = reinterpret_cast<char*>(positions.data) + normals.offset;
+    texcoords.data = texcoords.count ? reinterpret_cast<char*>(positions.data) + texcoords.offset : nullptr;
+    memcpy(positions.data, mesh.positions.data(), positionBytes);
+    memcpy(normals.data, mesh.normals.data(), normalBytes);
+    if (texcoords.count)
+        memcpy(texcoords.data, mesh.texcoords.data(), texcoordBytes);
+    memcpy(faces.data, mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+    computeBounds();
+}
+/*
+Loads the specified binary glTF model into this classes primitive storage
+All primitives are flattened into a single vertex and index buffer (in the same layout as .obj models), with one sub-mesh per
+primitive (adjacent primitives of the same material are merged), so the model is drawn with one call per material
+Accessors which are tightly packed floats are copied from the mapped file in bulk, others are converted per element
+Node transforms are baked into the vertices, PBR material factors are approximated by the Phong parameters used by Material
+Textures, skins, morph targets and animations are not supported
+*/
+void Entity::ModelData::loadModelFromGLB(const std::string &path) {
+    const GLBFile glb(path);
+    // Count the elements of the flattened mesh
+    size_t vertexCount = 0, indexCount = 0;
+    bool hasNormals = false, hasColors = false, hasTexcoords = false, usesDefaultMaterial = false;
+    for (const GLBFile::Primitive &p : glb.primitives) {
+        vertexCount += p.position.count;
+        indexCount += ((p.indices.data ? p.indices.count : p.position.count) / FACES_SIZE) * FACES_SIZE;
+        hasNormals |= p.normal.data != nullptr;
+        hasColors |= p.color.data != nullptr;
+        hasTexcoords |= p.texcoord.data != nullptr;
+        usesDefaultMaterial |= p.material < 0;
+    }
+    if (vertexCount == 0 || indexCount == 0) {
+        THROW ResourceError("Vertex or face data missing.\nAre you sure that '%s' is a binary glTF (.glb) format model?\n", modelPath.c_str());
+    }
+    if (vertexCount > UINT_MAX || indexCount > UINT_MAX) {
+        THROW ResourceError("Model '%s' contains too many vertices to be loaded.\n", modelPath.c_str());
+    }
+    // Primitives without a material use an additional default material, if the file defines any
+    const size_t materialCount = glb.materials.size() + (usesDefaultMaterial && !glb.materials.empty());
+    if (materialCount > MAX_OBJ_MATERIALS) {
+        THROW ResourceError("Model '%s' contains %u materials, a maximum of %u are supported.\n", modelPath.c_str(), static_cast<unsigned int>(materialCount), MAX_OBJ_MATERIALS);
+    }
+    vn_count = static_cast<unsigned int>(vertexCount);
+    positions.components = 3;
+    normals.components = NORMALS_SIZE;
+    colors.components = 4;
+    texcoords.components = DEFAULT_TEXCOORD_SIZE;
+    faces.components = FACES_SIZE;
+    positions.count = vn_count;
+    normals.count = hasNormals ? vn_count : 0;
+    colors.count = hasColors ? vn_count : 0;
+    texcoords.count = hasTexcoords ? vn_count : 0;
+    faces.count = static_cast<unsigned int>(indexCount / FACES_SIZE);
+    // Allocate instance vars from a single malloc, in the same layout as .obj models
+    size_t bufferSize = vn_count * positions.components * positions.componentSize;
+    if (normals.count) {
+        normals.offset = static_cast<unsigned int>(bufferSize);
+        bufferSize += vn_count * normals.components * normals.componentSize;
+    }
+    if (colors.count) {
+        colors.offset = static_cast<unsigned int>(bufferSize);
+        bufferSize += vn_count * colors.components * colors.componentSize;
+    }
+    if (texcoords.count) {
+        texcoords.offset = static_cast<unsigned int>(bufferSize);
+        bufferSize += vn_count * texcoords.components * texcoords.componentSize;
+    }
+    positions.data = malloc(bufferSize);
+    faces.data = malloc(faces.count * faces.components * faces.componentSize);
+    normals.data = normals.count ? reinterpret_cast<char*>(positions.data) + normals.offset : nullptr;
+    colors.data = colors.count ? reinterpret_cast<char*>(positions.data) + colors.offset : nullptr;
+    texcoords.data = texcoords.count ? reinterpret_cast<char*>(positions.data) + texcoords.offset : nullptr;
+    float *const t_positions = reinterpret_cast<float*>(positions.data);
+    float *const t_normals = reinterpret_cast<float*>(normals.data);
+    float *const t_colors = reinterpret_cast<float*>(colors.data);
+    float *const t_texcoords = reinterpret_cast<float*>(texcoords.data);
+    unsigned int *const t_faces = reinterpret_cast<unsigned int*>(faces.data);
+    // Copy each primitive into the flattened mesh
+    unsigned int baseVertex = 0, baseFace = 0;
+    for (const GLBFile::Primitive &p : glb.primitives) {
+        const unsigned int count = p.position.count;
+        const bool identity = p.transform == glm::mat4(1.0f);
+        if (identity && p.position.isPackedFloat()) {
+            memcpy(t_positions + baseVertex * 3, p.position.data, count * 3 * sizeof(float));
+        } else {
+            for (unsigned int i = 0; i < count; ++i) {
+                const glm::vec4 v = p.transform * glm::vec4(p.position.get(i, 0), p.position.get(i, 1), p.position.get(i, 2), 1.0f);
+                for (unsigned int k = 0; k < 3; ++k)
+                    t_positions[(baseVertex + i) * 3 + k] = v[k];
             }
-            if (colors.count) {
-                for (unsigned int k = 0; k < colors.components; k++)
-                    reinterpret_cast<float*>(colors.data)[(vn_assigned*colors.components) + k] = t_colors[(i_vert*colors.components) + k];
+        }
+        if (t_normals) {
+            float *n = t_normals + baseVertex * NORMALS_SIZE;
+            if (!p.normal.data) {
+                std::fill(n, n + count * NORMALS_SIZE, 0.0f);
+            } else if (identity && p.normal.isPackedFloat() && p.normal.components == NORMALS_SIZE) {
+                memcpy(n, p.normal.data, count * NORMALS_SIZE * sizeof(float));
+            } else {
+                const glm::mat3 normalMat = glm::transpose(glm::inverse(glm::mat3(p.transform)));
+                for (unsigned int i = 0; i < count; ++i) {
+                    glm::vec3 t_normal = normalMat * glm::vec3(p.normal.get(i, 0), p.normal.get(i, 1), p.normal.get(i, 2));
+                    const float len = glm::length(t_normal);
+                    t_normal = len > 0 ? t_normal / len : t_normal;
+                    for (unsigned int k = 0; k < NORMALS_SIZE; ++k)
+                        n[i * NORMALS_SIZE + k] = t_normal[k];
+                }
             }
-            if (face_hasTexcoords) {
-                for (unsigned int k = 0; k < texcoords.components; k++)
-                    reinterpret_cast<float*>(texcoords.data)[(vn_assigned*texcoords.components) + k] = t_texcoords[(t_tex_pos[i] * texcoords.components) + k];
+        }
+        if (t_colors) {
+            float *c = t_colors + baseVertex * 4;
+            if (!p.color.data) {
+                std::fill(c, c + count * 4, 1.0f);
+            } else if (p.color.isPackedFloat() && p.color.components == 4) {
+                memcpy(c, p.color.data, count * 4 * sizeof(float));
+            } else {
+                for (unsigned int i = 0; i < count; ++i)
+                    for (unsigned int k = 0; k < 4; ++k)
+                        c[i * 4 + k] = k < p.color.components ? p.color.get(i, k) : 1.0f;
             }
-            // Assign it new lowest id
-            (*vn_pairs)[{static_cast<unsigned int>(i_vert), static_cast<unsigned int>(i_norm), static_cast<unsigned int>(i_tex)}] = vn_assigned++;
         }
-        // Update index from face
-        reinterpret_cast<unsigned int *>(faces.data)[i] = (*vn_pairs)[{static_cast<unsigned int>(i_vert), static_cast<unsigned int>(i_norm), static_cast<unsigned int>(i_tex)}];
-    }
-    // Free temps
-    std::thread([vn_pairs]() {
-        delete vn_pairs;
-    }).detach();
-    free(t_vertices);
-    free(t_colors);
-    free(t_normals);
-    free(t_texcoords);
-    free(t_norm_pos);
-    free(t_tex_pos);
-    // Load VBOs
-    generateVertexBufferObjects();
-    // Can the host copies be freed after a bind?
-    // No, we want to keep faces around as a minimum for easier vertex order switching
-    // free(vertices);
-    // if (normals)
-    //     free(normals);
-    // if (colors)
-    //     free(colors);
-    // if (textures)
-    //     free(textures);
-    // free(faces);
-    fclose(file);
-    if (mtllib&&usemtl) {
-        loadMaterialFromFile(modelPath, mtllib, usemtl);
+        if (t_texcoords) {
+            float *t = t_texcoords + baseVertex * DEFAULT_TEXCOORD_SIZE;
+            if (!p.texcoord.data) {
+                std::fill(t, t + count * DEFAULT_TEXCOORD_SIZE, 0.0f);
+            } else if (p.texcoord.isPackedFloat() && p.texcoord.components == DEFAULT_TEXCOORD_SIZE) {
+                memcpy(t, p.texcoord.data, count * DEFAULT_TEXCOORD_SIZE * sizeof(float));
+            } else {
+                for (unsigned int i = 0; i < count; ++i)
+                    for (unsigned int k = 0; k < DEFAULT_TEXCOORD_SIZE; ++k)
+                        t[i * DEFAULT_TEXCOORD_SIZE + k] = k < p.texcoord.components ? p.texcoord.get(i, k) : 0.0f;
+            }
+        }
+        // Indices are rebased onto the primitive's first vertex, non-indexed primitives are drawn in vertex order
+        const unsigned int faceCount = (p.indices.data ? p.indices.count : count) / FACES_SIZE;
+        unsigned int *f = t_faces + baseFace * FACES_SIZE;
+        for (unsigned int i = 0; i < faceCount * FACES_SIZE; ++i)
+            f[i] = baseVertex + (p.indices.data ? p.indices.getIndex(i) : i);
+        // Sub-mesh, merged with the previous if they share a material
+        const unsigned int material = p.material >= 0 ? static_cast<unsigned int>(p.material) : static_cast<unsigned int>(glb.materials.size());
+        const unsigned int subMeshMaterial = glb.materials.empty() ? 0 : material;
+        if (!subMeshes.empty() && subMeshes.back().material == subMeshMaterial) {
+            subMeshes.back().faceCount += faceCount;
+        } else if (faceCount) {
+            subMeshes.push_back({ baseFace, faceCount, subMeshMaterial });
+        }
+        baseVertex += count;
+        baseFace += faceCount;
     }
-    free(mtllib);
-    free(usemtl);
+    // Approximate each metallic-roughness material with Phong parameters
+    // Metals have no diffuse term, however Phong has no environment lighting to replace it, so base color is used for both
+    std::vector<GLBFile::Material> t_materials = glb.materials;
+    if (usesDefaultMaterial && !t_materials.empty()) {
+        t_materials.push_back(GLBFile::Material());
+        t_materials.back().name = "default";
+    }
+    for (const GLBFile::Material &m : t_materials) {
+        MaterialDescription d;
+        d.name = m.name;
+        d.diffuse = glm::vec3(m.baseColor);
+        d.ambient = glm::vec3(m.baseColor) * 0.1f;
+        const float roughness = glm::clamp(m.roughness, 0.0f, 1.0f);
+        d.specular = glm::mix(glm::vec3(0.04f), glm::vec3(m.baseColor), m.metallic) * (1.0f - roughness);
+        // Blinn-Phong exponent with an equivalent highlight to a GGX lobe of alpha = roughness^2
+        const float alpha = std::max(roughness * roughness, 1e-3f);
+        d.shininess = glm::clamp(2.0f / (alpha * alpha) - 2.0f, 1.0f, 256.0f);
+        d.emissive = m.emissive;
+        d.opacity = m.blend ? m.baseColor.a : 1.0f;
+        modelMaterials.push_back(d);
+    }
+    computeBounds();
+}
+/*
+Calculates modelMin, modelMax and boundingRadius from the positions buffer
+*/
+void Entity::ModelData::computeBounds() {
+    modelMin = glm::vec3(FLT_MAX);
+    modelMax = glm::vec3(-FLT_MAX);
+    const float *p = reinterpret_cast<const float*>(positions.data);
+    for (unsigned int i = 0; i < positions.count * positions.components; i += positions.components) {
+        const glm::vec3 position(p[i], p[i + 1], p[i + 2]);
+        modelMax = glm::max(modelMax, position);
+        modelMin = glm::min(modelMin, position);
+    }
+    const glm::vec3 centre = (modelMin + modelMax) * 0.5f;
+    float radius2 = 0;
+    for (unsigned int i = 0; i < positions.count * positions.components; i += positions.components) {
+        const glm::vec3 d = glm::vec3(p[i], p[i + 1], p[i + 2]) - centre;
+        radius2 = std::max(radius2, glm::dot(d, d));
+    }
+    boundingRadius = std::sqrt(radius2);
 }
 /*
 Loads a single material from a .mtl file
@@ -1076,25 +1930,45 @@ void Entity::loadMaterialFromFile(const char *objPath, const char *materialFilen
     for (auto &m : materials)
         m.bake();
 }
+/*
+Creates the materials described by the model file (currently only .glb models describe their materials)
+*/
+void Entity::loadModelMaterials() {
+    materials.clear();
+    for (const MaterialDescription &d : modelMaterials) {
+        this->materials.push_back(Material(materialBuffer, static_cast<unsigned int>(materials.size())));
+        Material &m = materials[materials.size() - 1];
+        m.setName(d.name);
+        m.setAmbient(d.ambient);
+        m.setDiffuse(d.diffuse);
+        m.setSpecular(d.specular);
+        m.setEmissive(d.emissive);
+        m.setShininess(d.shininess);
+        m.setOpacity(d.opacity);
+        m.bake();
+    }
+}
 void Entity::setMaterial(const glm::vec3 &ambient, const glm::vec3 &diffuse, const glm::vec3 &specular, const float &shininess, const float &opacity) {
     size_t matSize = materials.size() == 0 ? 1 : materials.size();
     materials.clear();
     // Override material
     for (unsigned int i = 0; i < matSize; ++i) {
         this->materials.push_back(Material(materialBuffer, static_cast<unsigned int>(materials.size()), {"", ambient, diffuse, specular, shininess, opacity}));
-        if (positions.data) {
+        if (positions.count) {
             auto it = materials[i].getShaders();
             if (it) {
-                it->setPositionsAttributeDetail(positions);
-                it->setNormalsAttributeDetail(normals);
-                it->setColorsAttributeDetail(colors);
-                it->setTexCoordsAttributeDetail(texcoords);
+                it->setPositionsAttributeDetail(devicePositions);
+                it->setNormalsAttributeDetail(deviceNormals);
+                it->setColorsAttributeDetail(deviceColors);
+                it->setTexCoordsAttributeDetail(deviceTexcoords);
                 it->setMaterialBuffer(materialBuffer);
                 it->setFaceVBO(faces.vbo);
                 if (keyframe_model) {
-                    it->addGenericAttributeDetail("_vertex2", keyframe_model->positions, false);
-                    it->addGenericAttributeDetail("_normal2", keyframe_model->normals, true);
+                    it->addGenericAttributeDetail("_vertex2", keyframe_model->devicePositions, false);
+                    it->addGenericAttributeDetail("_normal2", keyframe_model->deviceNormals, true);
                 }
+                if (keyframeAtlas)
+                    bindKeyFrames(it);
             } else if (shaders.empty()) {
                 THROW EntityError("Entity has no shaders!\n");
             }
@@ -1141,105 +2015,234 @@ glm::vec4 Entity::getRotation() const {
 }
 /*
 Exports the current model to a faster loading binary format which represents a direct copy of the buffers required by the model
-Models are stored by appending .sdl_export to their existing filename
-Models are stored in the following format;
-#Header
+Models are stored in the temp dir, by replacing .obj with .obj.sdl_export in their existing filename
+Models are stored in the following format (version 2);
+#Header (ExportHeader)
 [1 byte]                File type flag
 [1 byte]                Exporter version
 [1 byte]                float length (bytes)
 [1 byte]                uint length (bytes)
-[1 float]               Model scale (length of longest axis)
-[1 uint]                vn_count
-[1 bit]                 File contains (float) vertices of size 3
-[1 bit]                 File contains (float) vertices of size 4
-[1 bit]                 File contains (float) normals of size 3
-[1 bit]                 File contains (float) colors of size 3
-[1 bit]                 File contains (float) colors of size 4
-[1 bit]                 File contains (float) texcoords of size 2
-[1 bit]                 File contains (float) texcoords of size 3
-[1 bit]                 File contains (uint) faces of size 3
-[4 byte]                Reserved space for future expansion
-##Data## (Per item marked true from the bit fields in the header)
-[1 uint]                (faces only) Number of items
-[n x size float/uint]   Item data
+[1 uint32]              Loader version
+[1 uint64]              Content hash of the source model
+[1 uint64]              Size of the source model (bytes)
+[1 uint32]              vn_count
+[1 uint32]              Face count
+[4 byte]                Components of positions, normals, colors, texcoords (0 if not present)
+[2 uint32]              Offset and size of material names
+[1 uint32]              Reserved space for future expansion
+[2 uint64]              Offset and size of vertex block
+[2 uint64]              Offset and size of index block
+[6 float]               Bounding box min, max
+[4 float]               Bounding sphere centre, radius
+##Data##
+[n byte]                mtllib, usemtl (null terminated strings)
+(padding to EXPORT_ALIGNMENT)
+[n x size float]        Vertex block, positions, normals, colors then texcoords
+(padding to EXPORT_ALIGNMENT)
+[n x size uint]         Index block
 ##Footer##
 [1 byte]    File type flag
 */
-void Entity::exportModel() const {
-    if (positions.count == 0)
+void Entity::exportModel() {
+    // Binary exports do not record sub-meshes, so multi-material models are not exported
+    if (positions.count == 0 || subMeshes.size() > 1 || !modelMaterials.empty() || PrimitiveMesh::isPrimitivePath(modelPath))
         return;
+    restoreHostGeometry();
     std::string exportPath = Resources::toTempDir(modelPath);
     std::string objPath(OBJ_TYPE);
     if (!su::endsWith(modelPath, EXPORT_TYPE, false)) {
         exportPath = exportPath.substr(0, exportPath.length() - objPath.length()).append(EXPORT_TYPE);
     }
-    FILE * file = fopen(exportPath.c_str(), "r");
     // Only check if file already exists if we're not upgrading its version
-    if (!needsExport && file) {
-        fclose(file);
+    std::error_code ec;
+    if (!needsExport && std::filesystem::exists(exportPath, ec)) {
         return;
     }
-    if (file)
-        fclose(file);
-    file = fopen(exportPath.c_str(), "wb");
-    if (!file) {
-        // Fail silently
-        return;
+    ExportHeader header = {};
+    header.FLAGS = optimised ? EXPORT_FLAG_OPTIMISED : 0;
+    header.SOURCE_HASH = sourceHash;
+    header.SOURCE_SIZE = sourceSize;
+    header.VN_COUNT = vn_count;
+    header.FACE_COUNT = faces.count;
+    header.POSITION_COMPONENTS = static_cast<unsigned char>(positions.components);
+    header.NORMAL_COMPONENTS = static_cast<unsigned char>(normals.count ? normals.components : 0);
+    header.COLOR_COMPONENTS = static_cast<unsigned char>(colors.count ? colors.components : 0);
+    header.TEXCOORD_COMPONENTS = static_cast<unsigned char>(texcoords.count ? texcoords.components : 0);
+    header.VERTEX_SIZE = positions.count * positions.components * positions.componentSize
+        + normals.count * normals.components * normals.componentSize
+        + colors.count * colors.components * colors.componentSize
+        + texcoords.count * texcoords.components * texcoords.componentSize;
+    header.INDEX_SIZE = faces.count * faces.components * faces.componentSize;
+    const glm::vec4 sphere = getBoundingSphere();
+    for (int k = 0; k < 3; ++k) {
+        header.BOUNDS_MIN[k] = modelMin[k];
+        header.BOUNDS_MAX[k] = modelMax[k];
+        header.BOUNDING_SPHERE[k] = sphere[k];
     }
-    // Generate export mask
-    ExportMask mask{
-        FILE_TYPE_FLAG,
-        FILE_TYPE_VERSION,
-        sizeof(float),
-        sizeof(unsigned int),
-        glm::compMax(SCALE),  // scale isn't actually used on import anymore, so this value doesn't matter if they have 3D scale
-        vn_count,
-        positions.count && positions.components == 3,
-        positions.count && positions.components == 4,
-        normals.count && normals.components == 3,
-        colors.count && colors.components == 3,
-        colors.count && colors.components == 4,
-        texcoords.count && texcoords.components == 2,
-        texcoords.count && texcoords.components == 3,
-        faces.count && faces.components == 3,
-        0};
-    // Write out the export mask
-    fwrite(&mask, sizeof(ExportMask), 1, file);
-    // Write out each buffer in order
-    if (positions.count && (positions.components == 3 || positions.components == 4)) {
-        fwrite(positions.data, positions.componentSize, positions.count*positions.components, file);
-    }
-    if (normals.count && (NORMALS_SIZE == 3)) {
-        fwrite(normals.data, positions.componentSize, positions.count*positions.components, file);
-    }
-    if (colors.count && (colors.components == 3 || colors.components == 4)) {
-        fwrite(colors.data, colors.componentSize, colors.count*colors.components, file);
-    }
-    if (texcoords.count && (texcoords.components == 2 || texcoords.components == 3)) {
-        fwrite(texcoords.data, texcoords.componentSize, texcoords.count*texcoords.components, file);
-    }
-    if (faces.count && (faces.components == 3)) {
-        fwrite(&faces.count, sizeof(unsigned int), 1, file);
-        fwrite(faces.data, faces.componentSize, faces.count*faces.components, file);
+    header.BOUNDING_SPHERE[3] = sphere.w;
+    // Fail silently
+    writeExport(exportPath, header, positions.data, faces.data, mtllib, usemtl);
+}
+bool Entity::writeExport(const std::string &exportPath, const ExportHeader &_header, const void *vertexData, const void *indexData, const std::string &mtllib, const std::string &usemtl) {
+    auto align = [](const uint64_t offset) { return (offset + EXPORT_ALIGNMENT - 1) / EXPORT_ALIGNMENT * EXPORT_ALIGNMENT; };
+    ExportHeader header = _header;
+    header.FILE_TYPE_FLAG = FILE_TYPE_FLAG;
+    header.VERSION_FLAG = FILE_TYPE_VERSION;
+    header.SIZE_OF_FLOAT = sizeof(float);
+    header.SIZE_OF_UINT = sizeof(unsigned int);
+    header.LOADER_VERSION = LOADER_VERSION;
+    header.MATERIAL_OFFSET = sizeof(ExportHeader);
+    header.MATERIAL_SIZE = static_cast<uint32_t>(mtllib.size() + usemtl.size() + 2);
+    header.VERTEX_OFFSET = align(header.MATERIAL_OFFSET + header.MATERIAL_SIZE);
+    header.INDEX_OFFSET = align(header.VERTEX_OFFSET + header.VERTEX_SIZE);
+    // Write to a unique temporary file, then rename over the destination
+    const std::string tempPath = exportPath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    FILE *file = fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        return false;
     }
+    const char zeros[EXPORT_ALIGNMENT] = {};
+    bool success = fwrite(&header, sizeof(ExportHeader), 1, file) == 1;
+    success = success && fwrite(mtllib.c_str(), 1, mtllib.size() + 1, file) == mtllib.size() + 1;
+    success = success && fwrite(usemtl.c_str(), 1, usemtl.size() + 1, file) == usemtl.size() + 1;
+    const size_t vertexPadding = header.VERTEX_OFFSET - (header.MATERIAL_OFFSET + header.MATERIAL_SIZE);
+    success = success && fwrite(zeros, 1, vertexPadding, file) == vertexPadding;
+    success = success && fwrite(vertexData, 1, header.VERTEX_SIZE, file) == header.VERTEX_SIZE;
+    const size_t indexPadding = header.INDEX_OFFSET - (header.VERTEX_OFFSET + header.VERTEX_SIZE);
+    success = success && fwrite(zeros, 1, indexPadding, file) == indexPadding;
+    success = success && fwrite(indexData, 1, header.INDEX_SIZE, file) == header.INDEX_SIZE;
     // Finish by writing the file type flag again
     const char temp = FILE_TYPE_FLAG;
-    fwrite(&temp, sizeof(char), 1, file);
-    fclose(file);
+    success = success && fwrite(&temp, sizeof(char), 1, file) == 1;
+    success = fclose(file) == 0 && success;
+    std::error_code ec;
+    if (success) {
+        std::filesystem::rename(tempPath, exportPath, ec);
+        success = !ec;
+    }
+    if (!success) {
+        std::filesystem::remove(tempPath, ec);
+    }
+    return success;
 }
 /*
-Exports the current model to a fast loading binary format which represents a direct copy of the buffers required by the model
-@param file Path to the desired output file
+Imports a model previously exported to the fast loading binary format which represents a direct copy of the buffers required by the model
+Version 2 exports are memory mapped, and the attribute buffers point directly into the mapping
+@param path Path to the desired input file
+@param validateSource If true, the export must have been produced from a source model matching sourceSize and sourceHash
+@return False if the export could not be used, in which case the source model should be parsed instead
 */
-void Entity::importModel(const char *path) {
-    // Generate import path
-    std::string importPath(path);
-    std::string objPath(OBJ_TYPE);
-    if (su::endsWith(path, OBJ_TYPE, false)) {
-        importPath = importPath.substr(0, importPath.length() - objPath.length()).append(EXPORT_TYPE);
-    } else if (!su::endsWith(path, EXPORT_TYPE, false)) {
-        THROW ResourceError("Model File: %s, is not a support filetype (e.g. %s, %s)\n", path, OBJ_TYPE, EXPORT_TYPE);
+bool Entity::ModelData::importModel(const std::string &path, const bool validateSource) {
+    std::shared_ptr<const MappedFile> file;
+    try {
+        file = std::make_shared<const MappedFile>(path);
+    } catch (ResourceError&) {
+        return false;
+    }
+    const char *base = file->data();
+    const size_t fileSize = file->size();
+    if (fileSize < 2 || static_cast<unsigned char>(base[0]) != FILE_TYPE_FLAG) {
+        fprintf(stderr, "Model export '%s' is corrupt, it will be ignored.\n", path.c_str());
+        return false;
+    }
+    const unsigned char version = static_cast<unsigned char>(base[1]);
+    if (version > FILE_TYPE_VERSION) {
+        fprintf(stderr, "Model export '%s' is of newer version %u, this software supports a maximum version of %u, it will be ignored.\n", path.c_str(), static_cast<unsigned int>(version), static_cast<unsigned int>(FILE_TYPE_VERSION));
+        return false;
+    } else if (version < 2) {
+        // Legacy exports don't record their source, so are only used if the source is unavailable
+        if (validateSource)
+            return false;
+        importLegacyModel(path);
+        computeBounds();
+        return true;
+    }
+    ExportHeader header;
+    if (fileSize < sizeof(ExportHeader) + 1) {
+        fprintf(stderr, "Model export '%s' is corrupt, it will be ignored.\n", path.c_str());
+        return false;
+    }
+    memcpy(&header, base, sizeof(ExportHeader));
+    if (header.SIZE_OF_FLOAT != sizeof(float) || header.SIZE_OF_UINT != sizeof(unsigned int) || header.LOADER_VERSION != LOADER_VERSION) {
+        return false;
+    }
+    if (validateSource && (header.SOURCE_SIZE != sourceSize || header.SOURCE_HASH != sourceHash)) {
+        // Source model has changed since the export was written
+        return false;
+    }
+    if (validateSource && ((header.FLAGS & EXPORT_FLAG_OPTIMISED) != 0) != optimiseModels) {
+        // Export was written with a different optimisation setting, so re-parse (and re-export) the source
+        return false;
     }
+    // Validate the layout, so a truncated or corrupt export cannot cause reads out of bounds
+    const uint64_t vertexStride = (header.POSITION_COMPONENTS + header.NORMAL_COMPONENTS + header.COLOR_COMPONENTS + header.TEXCOORD_COMPONENTS) * sizeof(float);
+    if (header.POSITION_COMPONENTS < 3 || header.POSITION_COMPONENTS > 4 ||
+        (header.NORMAL_COMPONENTS && header.NORMAL_COMPONENTS != NORMALS_SIZE) ||
+        header.COLOR_COMPONENTS > 4 || header.TEXCOORD_COMPONENTS > 3 ||
+        header.VERTEX_SIZE != header.VN_COUNT * vertexStride ||
+        header.INDEX_SIZE != static_cast<uint64_t>(header.FACE_COUNT) * FACES_SIZE * sizeof(unsigned int) ||
+        header.VERTEX_OFFSET % EXPORT_ALIGNMENT || header.INDEX_OFFSET % EXPORT_ALIGNMENT ||
+        header.MATERIAL_OFFSET + static_cast<uint64_t>(header.MATERIAL_SIZE) > fileSize ||
+        header.VERTEX_OFFSET + header.VERTEX_SIZE > fileSize ||
+        header.INDEX_OFFSET + header.INDEX_SIZE + 1 > fileSize ||
+        static_cast<unsigned char>(base[fileSize - 1]) != FILE_TYPE_FLAG) {
+        fprintf(stderr, "Model export '%s' is corrupt, it will be ignored.\n", path.c_str());
+        return false;
+    }
+    // Material names
+    if (header.MATERIAL_SIZE) {
+        const char *material = base + header.MATERIAL_OFFSET;
+        const char *materialEnd = material + header.MATERIAL_SIZE;
+        const char *mtllibEnd = static_cast<const char*>(memchr(material, '\0', header.MATERIAL_SIZE));
+        if (mtllibEnd) {
+            mtllib.assign(material, mtllibEnd);
+            const char *usemtlEnd = static_cast<const char*>(memchr(mtllibEnd + 1, '\0', materialEnd - mtllibEnd - 1));
+            usemtl.assign(mtllibEnd + 1, usemtlEnd ? usemtlEnd : materialEnd);
+        }
+    }
+    // Point attributes directly into the mapping
+    vn_count = header.VN_COUNT;
+    char *vertexBlock = const_cast<char*>(base + header.VERTEX_OFFSET);
+    size_t offset = 0;
+    positions.components = header.POSITION_COMPONENTS;
+    positions.count = vn_count;
+    positions.data = vertexBlock;
+    offset += vn_count * positions.components * positions.componentSize;
+    if (header.NORMAL_COMPONENTS) {
+        normals.components = header.NORMAL_COMPONENTS;
+        normals.count = vn_count;
+        normals.offset = offset;
+        normals.data = vertexBlock + offset;
+        offset += vn_count * normals.components * normals.componentSize;
+    }
+    if (header.COLOR_COMPONENTS) {
+        colors.components = header.COLOR_COMPONENTS;
+        colors.count = vn_count;
+        colors.offset = offset;
+        colors.data = vertexBlock + offset;
+        offset += vn_count * colors.components * colors.componentSize;
+    }
+    if (header.TEXCOORD_COMPONENTS) {
+        texcoords.components = header.TEXCOORD_COMPONENTS;
+        texcoords.count = vn_count;
+        texcoords.offset = offset;
+        texcoords.data = vertexBlock + offset;
+    }
+    faces.count = header.FACE_COUNT;
+    faces.data = const_cast<char*>(base + header.INDEX_OFFSET);
+    // Bounding volumes
+    modelMin = glm::vec3(header.BOUNDS_MIN[0], header.BOUNDS_MIN[1], header.BOUNDS_MIN[2]);
+    modelMax = glm::vec3(header.BOUNDS_MAX[0], header.BOUNDS_MAX[1], header.BOUNDS_MAX[2]);
+    boundingRadius = header.BOUNDING_SPHERE[3];
+    optimised = (header.FLAGS & EXPORT_FLAG_OPTIMISED) != 0;
+    mapping = file;
+    return true;
+}
+/*
+Imports a version 1 export of the fast loading binary format, these are read into heap buffers
+@param importPath Path to the desired input file
+*/
+void Entity::ModelData::importLegacyModel(const std::string &importPath) {
     // Open file
     FILE * file = Resources::fopen(importPath.c_str(), "rb");
     if (!file) {
@@ -1258,12 +2261,9 @@ void Entity::importModel(const char *path) {
         THROW ResourceError("FILE TYPE FLAG missing from file header : %s.\n", importPath.c_str());
     }
     // Check version is supported
-    if (mask.VERSION_FLAG > FILE_TYPE_VERSION) {
-        fclose(file);
-        THROW ResourceError("File %s is of newer version %u, this software supports a maximum version of %u.\n", importPath.c_str(), static_cast<unsigned int>(mask.VERSION_FLAG), static_cast<unsigned int>(FILE_TYPE_VERSION));
-    } else if (mask.VERSION_FLAG < FILE_TYPE_VERSION) {
+    if (mask.VERSION_FLAG != 1) {
         fclose(file);
-        THROW ResourceError("File %s is of an older version %u, it will automatically be upgraded to version %u.\n", importPath.c_str(), static_cast<unsigned int>(mask.VERSION_FLAG), static_cast<unsigned int>(FILE_TYPE_VERSION));
+        THROW ResourceError("File %s is of version %u, expected version 1.\n", importPath.c_str(), static_cast<unsigned int>(mask.VERSION_FLAG));
     }
     // Check float/uint lengths aren't too short
     if (sizeof(float) != mask.SIZE_OF_FLOAT) {
@@ -1362,60 +2362,97 @@ void Entity::importModel(const char *path) {
     //     for (unsigned int i = 0; i < positions.count*positions.components; i++)
     //         ((float*)positions.data)[i] *= scaleFactor;
     // }
-    // Calc dims
-    modelMin = glm::vec3(FLT_MAX);
-    modelMax = glm::vec3(-FLT_MAX);
-    glm::vec3 position;
-    for (unsigned int i = 0; i < positions.count*positions.components; i += positions.components) {
-        position = glm::vec3(reinterpret_cast<float*>(positions.data)[i], reinterpret_cast<float*>(positions.data)[i + 1], reinterpret_cast<float*>(positions.data)[i + 2]);
-        modelMax = glm::max(modelMax, position);
-        modelMin = glm::min(modelMin, position);
-    }
-    this->modelDims = modelMax - modelMin;
-    this->scaleFactor = glm::vec4(1.0);
-    if (SCALE.x < 0) {
-        // Special case, negative scale means scale uniformly according to longest edge
-        this->scaleFactor.x = -SCALE.x / glm::compMax(modelDims);
-        this->scaleFactor.y = scaleFactor.x;
-        this->scaleFactor.z = scaleFactor.x;
-    } else {
-        if (SCALE.x > 0) this->scaleFactor.x = SCALE.x / modelDims.x;
-        if (SCALE.y > 0) this->scaleFactor.y = SCALE.y / modelDims.y;
-        if (SCALE.z > 0) this->scaleFactor.z = SCALE.z / modelDims.z;
-    }
-    // Allocate VBOs
-    generateVertexBufferObjects();
 }
 /*
 Creates the necessary vertex buffer objects, and fills them with the relevant instance var data.
 */
 void Entity::generateVertexBufferObjects() {
-    unsigned int bufferSize = 0;
-    bufferSize += positions.count * positions.components * positions.componentSize;  // Positions required
-    bufferSize += normals.count *   normals.components *   normals.componentSize;
-    bufferSize += colors.count *    colors.components *    colors.componentSize;
-    bufferSize += texcoords.count * texcoords.components * texcoords.componentSize;
-    createVertexBufferObject(&positions.vbo, GL_ARRAY_BUFFER, bufferSize, positions.data);
-    unsigned int offset = vn_count*positions.components*positions.componentSize;
-    if (normals.count) {
-        normals.vbo = positions.vbo;
-        // redundant
-        normals.offset = offset;
-        offset += normals.count*normals.components*normals.componentSize;
+    const bool pack = packModelVertices;
+    devicePositions = positions;
+    deviceNormals = normals;
+    deviceColors = colors;
+    deviceTexcoords = texcoords;
+    if (pack) {
+        // Half precision positions and texcoords are padded to 4 components where required, so that elements remain 4 byte aligned
+        devicePositions.componentType = GL_HALF_FLOAT;
+        devicePositions.componentSize = sizeof(uint16_t);
+        devicePositions.components = 4;
+        deviceNormals.componentType = GL_INT_2_10_10_10_REV;
+        deviceNormals.components = 4;
+        deviceNormals.normalized = true;
+        deviceTexcoords.componentType = GL_HALF_FLOAT;
+        deviceTexcoords.componentSize = sizeof(uint16_t);
+        deviceTexcoords.components = texcoords.components == 2 ? 2 : 4;
     }
-    if (colors.count) {
-        colors.vbo = positions.vbo;
-        // redundant
-        colors.offset = offset;
-        offset += colors.count*colors.components*colors.componentSize;
+    // Attributes are stored one after another within a single vbo
+    size_t bufferSize = 0;
+    for (Shaders::VertexAttributeDetail *d : { &devicePositions, &deviceNormals, &deviceColors, &deviceTexcoords }) {
+        d->data = nullptr;
+        d->offset = static_cast<unsigned int>(bufferSize);
+        bufferSize += d->count * d->elementSize();
     }
-    if (texcoords.count) {
-        texcoords.vbo = positions.vbo;
-        // redundant
-        texcoords.offset = offset;
-        // offset += texcoords.count*texcoords.components*texcoords.componentSize;
+    if (pack) {
+        std::vector<char> packed(bufferSize);
+        packVertexAttribute(positions, devicePositions, packed.data(), 1.0f);
+        packVertexAttribute(normals, deviceNormals, packed.data(), 0.0f);
+        packVertexAttribute(colors, deviceColors, packed.data(), 1.0f);
+        packVertexAttribute(texcoords, deviceTexcoords, packed.data(), 1.0f);
+        createVertexBufferObject(&positions.vbo, GL_ARRAY_BUFFER, static_cast<GLuint>(bufferSize), packed.data());
+    } else {
+        // Device layout matches the host copy
+        createVertexBufferObject(&positions.vbo, GL_ARRAY_BUFFER, static_cast<GLuint>(bufferSize), positions.data);
     }
-    createVertexBufferObject(&faces.vbo, GL_ELEMENT_ARRAY_BUFFER, faces.count*faces.components*faces.componentSize, faces.data);
+    devicePositions.vbo = positions.vbo;
+    for (Shaders::VertexAttributeDetail *d : { &deviceNormals, &deviceColors, &deviceTexcoords }) {
+        d->vbo = d->count ? positions.vbo : 0;
+    }
+    GL_CALL(glGenBuffers(1, &faces.vbo));
+    uploadFaces();
+}
+/*
+Converts a host attribute array of floats to the packed format described by device, writing it at device.offset within buffer
+@param host The host attribute, with GL_FLOAT components
+@param device The device attribute, with GL_FLOAT, GL_HALF_FLOAT or GL_INT_2_10_10_10_REV components
+@param buffer The start of the packed vertex buffer
+@param pad The value of components present in device but not host
+*/
+void Entity::packVertexAttribute(const Shaders::VertexAttributeDetail &host, const Shaders::VertexAttributeDetail &device, char *buffer, const float pad) {
+    const float *src = reinterpret_cast<const float*>(host.data);
+    char *dest = buffer + device.offset;
+    for (unsigned int i = 0; i < host.count; ++i) {
+        glm::vec4 v(pad);
+        for (unsigned int k = 0; k < host.components && k < 4; ++k)
+            v[k] = src[i * host.components + k];
+        if (device.componentType == GL_HALF_FLOAT) {
+            for (unsigned int k = 0; k < device.components; ++k) {
+                const uint16_t h = glm::packHalf1x16(v[k]);
+                memcpy(dest + (i * device.components + k) * sizeof(uint16_t), &h, sizeof(uint16_t));
+            }
+        } else if (device.componentType == GL_INT_2_10_10_10_REV) {
+            const uint32_t p = glm::packSnorm3x10_1x2(v);
+            memcpy(dest + i * sizeof(uint32_t), &p, sizeof(uint32_t));
+        } else {
+            memcpy(dest + i * device.elementSize(), src + i * host.components, device.elementSize());
+        }
+    }
+}
+/*
+Uploads the host copy of faces to faces.vbo
+16 bit indices are used if every vertex can be addressed by them
+*/
+void Entity::uploadFaces() {
+    const size_t indexCount = faces.count * faces.components;
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, faces.vbo));
+    if (vn_count <= std::numeric_limits<uint16_t>::max()) {
+        const unsigned int *src = reinterpret_cast<const unsigned int*>(faces.data);
+        std::vector<uint16_t> shortFaces(src, src + indexCount);
+        indexType = GL_UNSIGNED_SHORT;
+        GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(uint16_t), shortFaces.data(), GL_STATIC_DRAW));
+    } else {
+        indexType = GL_UNSIGNED_INT;
+        GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * faces.componentSize, faces.data, GL_STATIC_DRAW));
+    }
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 }
 /*
 Returns a shared pointer to this entities shaders
@@ -1476,6 +2513,8 @@ Switches the vertex order of the model
 @note Exporting a model after calling this WILL reverse it in the export
 */
 void Entity::flipVertexOrder() {
+    // Meshes may be shared with other entities, or memory mapped (read-only), so take a private copy first
+    detachMesh();
     unsigned int *faceData = reinterpret_cast<unsigned int *>(faces.data);
     unsigned int temp;
     for (unsigned int i = 0; i < faces.count; i++) {
@@ -1490,9 +2529,7 @@ void Entity::flipVertexOrder() {
         }
     }
     // Copy the new face order to the vbo
-    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, faces.vbo));
-    GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, faces.count*faces.components*faces.componentSize, faces.data, GL_STATIC_DRAW));
-    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, faces.vbo));
+    uploadFaces();
 }
 /*
 Disables or enables face culling
@@ -1,5 +1,6 @@
 #ifndef SRC_FLAMEGPU_VISUALISER_ENTITY_H_
 #define SRC_FLAMEGPU_VISUALISER_ENTITY_H_
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
@@ -16,6 +17,9 @@
 namespace flamegpu {
 namespace visualiser {
 
+class MappedFile;
+class ShaderStorageBuffer;
+
 /*
 A renderable model loaded from a .obj file
 */
@@ -53,11 +57,214 @@ class Entity : public Renderable {
         Stock::Materials::Material const material,
         const glm::vec3 &scale = glm::vec3(1.0f));
     virtual ~Entity();
+    /**
+     * A contiguous range of faces drawn with a single material
+     * Only models loaded from .glb contain sub-meshes, .obj models are drawn as a single range with the first material
+     */
+    struct SubMesh {
+        unsigned int firstFace;
+        unsigned int faceCount;
+        // Index into the entity's materials
+        unsigned int material;
+    };
+    /**
+     * Material properties read from a model file, converted to the Phong parameters used by Material
+     */
+    struct MaterialDescription {
+        std::string name;
+        glm::vec3 ambient, diffuse, specular, emissive;
+        float shininess;
+        float opacity;
+    };
+    /**
+     * Host copy of a model's geometry, as loaded from a model file
+     * Loading this does not require a GL context, so it may be performed on a worker thread
+     * @see preload()
+     */
+    struct ModelData {
+        /**
+         * Loads the named model file (or its binary export if available)
+         * @param modelPath Path to .obj or .glb format model file, or a primitive path
+         * @see PrimitiveMesh
+         */
+        explicit ModelData(const std::string &modelPath);
+        ~ModelData();
+        ModelData(const ModelData&) = delete;
+        ModelData &operator=(const ModelData&) = delete;
+        /**
+         * Returns the total size of the interleaved positions, normals, colors and texcoords allocation in bytes
+         */
+        size_t vertexBufferSize() const;
+        const std::string modelPath;
+        unsigned int vn_count;
+        Shaders::VertexAttributeDetail positions, normals, colors, texcoords, faces;
+        glm::vec3 modelMin, modelMax;
+        // Radius of the bounding sphere, centred on the centre of modelMin and modelMax
+        float boundingRadius;
+        // Material library and material name referenced by the model (empty if not present)
+        std::string mtllib, usemtl;
+        // Size and content hash of the source .obj, used to detect stale binary exports
+        uint64_t sourceSize, sourceHash;
+        // If set, positions.data and faces.data point into this read-only mapping of a binary export, rather than being malloc'd
+        std::shared_ptr<const MappedFile> mapping;
+        // True if the triangles and vertices have been reordered by MeshOptimiser
+        bool optimised;
+        // Material ranges and materials of .glb models (empty for .obj)
+        std::vector<SubMesh> subMeshes;
+        std::vector<MaterialDescription> modelMaterials;
+        // Set by importModel if the imported model was of an older version.
+        bool needsExport;
+
+     private:
+        void loadModelFromFile();
+        /**
+         * Imports a binary export
+         * @param path Path to the binary export
+         * @param validateSource If true, exports which do not match sourceSize/sourceHash are rejected
+         * @return False if the export was stale, corrupt or of an unsupported version
+         */
+        bool importModel(const std::string &path, bool validateSource);
+        void importLegacyModel(const std::string &path);
+        /**
+         * Loads a binary glTF model
+         * Primitives are flattened into a single mesh, with one sub-mesh per primitive
+         * @param path Path to the .glb file
+         */
+        void loadModelFromGLB(const std::string &path);
+        /**
+         * Generates the primitive named by modelPath
+         * @see PrimitiveMesh
+         */
+        void loadModelFromPrimitive();
+        void computeBounds();
+        /**
+         * Reorders faces and vertices for vertex cache, vertex fetch and overdraw efficiency
+         * @param vn_source Face vertex which provides the attributes of each unique vertex, this is permuted to match the new vertex order
+         * @return The ACMR of the faces prior to optimisation
+         * @note Must be called before the vertex attributes are filled from vn_source, as only overdraw ordering reads positions
+         */
+        float optimiseFaces(std::vector<unsigned int> &vn_source);
+        /**
+         * Reorders clusters of faces to reduce overdraw, and records the change in ACMR for getOptimisationStats()
+         * @param acmrBefore The value returned by optimiseFaces()
+         */
+        void optimiseOverdraw(float acmrBefore);
+    };
+    /**
+     * Geometry and buffer objects of a loaded model
+     * Entities which load the same model file share a single Mesh, they hold views of its buffers in their own attribute details
+     * The buffer objects and host copies are released when the last entity using the mesh is destroyed
+     */
+    struct Mesh {
+        Mesh();
+        ~Mesh();
+        Mesh(const Mesh&) = delete;
+        Mesh &operator=(const Mesh&) = delete;
+        unsigned int vn_count;
+        Shaders::VertexAttributeDetail positions, normals, colors, texcoords, faces;
+        Shaders::VertexAttributeDetail devicePositions, deviceNormals, deviceColors, deviceTexcoords;
+        GLenum indexType;
+        glm::vec3 modelMin, modelMax;
+        float boundingRadius;
+        std::string mtllib, usemtl;
+        uint64_t sourceSize, sourceHash;
+        bool optimised;
+        std::vector<SubMesh> subMeshes;
+        std::vector<MaterialDescription> modelMaterials;
+        // If set, positions.data and faces.data point into this read-only mapping of a binary export
+        std::shared_ptr<const MappedFile> mapping;
+        // Size of the host copies (whether or not they are resident) and buffer objects, in bytes
+        size_t hostBytes, deviceBytes;
+        // False if the host copies have been released, in which case the data pointers are null
+        bool hostResident;
+    };
+    /**
+     * Begins loading the named model file on a worker thread
+     * Entities subsequently constructed with the same model path use the preloaded data, rather than parsing the file themselves
+     * @param modelPath Path to .obj or .glb format model file
+     * @note Preloaded data is retained until clearPreloaded() is called
+     */
+    static void preload(const std::string &modelPath);
+    /**
+     * Releases all preloaded model data
+     */
+    static void clearPreloaded();
+    /**
+     * Enables reordering of subsequently loaded models' triangles and vertices, to reduce vertex cache misses and overdraw
+     * @see MeshOptimiser
+     */
+    static void setOptimiseModels(bool optimise);
+    static bool getOptimiseModels();
+    /**
+     * Enables uploading subsequently loaded models' vertex attributes in packed formats
+     * Positions and texcoords are stored as half floats, and normals as GL_INT_2_10_10_10_REV
+     * This roughly halves vertex fetch bandwidth, at the cost of precision for models far from their origin
+     * @note Indices are always stored as 16 bit when the model has fewer than 65536 vertices
+     */
+    static void setPackModelVertices(bool pack);
+    static bool getPackModelVertices();
+    /**
+     * Enables freeing the host copies of subsequently loaded models' geometry, once uploaded to buffer objects
+     * Host copies are only required to modify (e.g. flipVertexOrder()) or export a model, these restore them on demand
+     * @note Meshes shared with existing entities retain their host copies
+     */
+    static void setReleaseHostGeometry(bool release);
+    static bool getReleaseHostGeometry();
+    /**
+     * Memory used by the geometry of all live meshes, in bytes
+     */
+    struct GeometryMemory {
+        // Host copies of vertex attributes and faces
+        size_t host;
+        // Buffer objects
+        size_t device;
+        // Host copies which have been freed by setReleaseHostGeometry()
+        size_t released;
+    };
+    static GeometryMemory getGeometryMemory();
+    /**
+     * Vertex cache efficiency of the models optimised by setOptimiseModels()
+     */
+    struct OptimisationStats {
+        // Number of models optimised
+        unsigned int models;
+        // Mean ACMR of the optimised models, before and after optimisation
+        float acmrBefore;
+        float acmrAfter;
+    };
+    static OptimisationStats getOptimisationStats();
+    /**
+     * Returns the preloaded data of the named model, else parses it on the calling thread
+     * @param modelPath Path to .obj or .glb format model file, or a primitive path
+     * @see preload()
+     */
+    static std::shared_ptr<const ModelData> loadModelData(const std::string &modelPath);
+    /**
+     * Returns the factor which scales a model of the provided dimensions to the requested world size
+     * @param scale World size of each axis, 0 leaves the axis unscaled
+     * If x is negative, the model is instead scaled uniformly so that its longest axis is -x
+     * @param modelDims Model space dimensions of the model
+     */
+    static glm::vec3 getScaleFactor(const glm::vec3 &scale, const glm::vec3 &modelDims);
+    /**
+     * Returns the model matrix of a model with the provided world transform
+     * @param location Translation
+     * @param rotation Axis of rotation (xyz), and angle in degrees (w)
+     * @param scaleFactor Scale, as returned by getScaleFactor()
+     */
+    static glm::mat4 getModelMat(const glm::vec3 &location, const glm::vec4 &rotation, const glm::vec3 &scaleFactor);
     /**
      * Loads a second model (must have the same vertex/polygon count) and attaches it to _vertex2, _normal2 within the shader
      * This is used for keyframe animations
      */
     void loadKeyFrameModel(const std::string &modelpathB);
+    /**
+     * Loads N keyframe models (each must have the same vertex/polygon count) into a single shader storage buffer, _keyframes
+     * The vertex shader blends between consecutive keyframes, selected per instance via TexBufferConfig::AnimationFrame
+     * @param modelPaths Paths to 2 or more keyframe models
+     * @throws ResourceError If a keyframe's topology does not match this entity's model
+     */
+    void loadKeyFrameModels(const std::vector<std::string> &modelPaths);
     virtual void render(unsigned int shaderIndex = 0);
     void renderInstances(int count, unsigned int shaderIndex = 0);
     /**
@@ -69,7 +276,7 @@ class Entity : public Renderable {
     void setRotation(glm::vec4 rotation);
     glm::vec3 getLocation() const;
     glm::vec4 getRotation() const;
-    void exportModel() const;
+    void exportModel();
     void reload() override;
     /**
      * Ensure updateShaders() is called after making changes to shaders returned by this method
@@ -90,6 +297,11 @@ class Entity : public Renderable {
     glm::vec3 getMin() const { return modelMin; }
     glm::vec3 getMax() const { return modelMax; }
     glm::vec3 getDimensions() const { return modelDims; }
+    /**
+     * Returns the model space bounding sphere of the model, prior to scaling
+     * xyz: centre, w: radius
+     */
+    glm::vec4 getBoundingSphere() const { return glm::vec4((modelMin + modelMax) * 0.5f, boundingRadius); }
 
  protected:
     glm::mat4 const * viewMatPtr;
@@ -105,6 +317,10 @@ class Entity : public Renderable {
     // Model vertex and face counts
     unsigned int vn_count;
     Shaders::VertexAttributeDetail positions, normals, colors, texcoords, faces;
+    // Formats of the attributes as uploaded to the vbo, these may be more compact than the host copies
+    Shaders::VertexAttributeDetail devicePositions, deviceNormals, deviceColors, deviceTexcoords;
+    // Type of the indices within faces.vbo, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    GLenum indexType;
 
     // Optional material (loaded automaically if detected within model file)
     std::vector<Material> materials;
@@ -116,11 +332,55 @@ class Entity : public Renderable {
     static void deleteVertexBufferObject(GLuint *vbo);
     void loadModelFromFile();
     void loadMaterialFromFile(const char *objPath, const char *materialFilename, const char *materialName);
+    /**
+     * Creates a material for each of modelMaterials
+     */
+    void loadModelMaterials();
     void generateVertexBufferObjects();
+    void uploadFaces();
+    static void packVertexAttribute(const Shaders::VertexAttributeDetail &host, const Shaders::VertexAttributeDetail &device, char *buffer, float pad);
 
  private:
     glm::mat4 getModelMat() const;
     glm::vec3 modelMin, modelMax, modelDims;
+    float boundingRadius;
+    std::string mtllib, usemtl;
+    uint64_t sourceSize, sourceHash;
+    bool optimised;
+    std::vector<SubMesh> subMeshes;
+    std::vector<MaterialDescription> modelMaterials;
+    /**
+     * Returns the key used to share meshes between entities
+     * Scale is applied via the model matrix, so entities of differing scale may share a mesh
+     */
+    std::string meshKey() const;
+    /**
+     * Copies the geometry details of this entity to a new Mesh, which takes ownership of its host copies and buffer objects
+     */
+    std::shared_ptr<Mesh> createMesh(std::shared_ptr<const MappedFile> mapping) const;
+    /**
+     * Sets this entity's geometry details to view the provided mesh
+     */
+    void useMesh(const std::shared_ptr<Mesh> &mesh);
+    /**
+     * Replaces a shared or memory mapped mesh with a private copy, so that the geometry can be modified
+     */
+    void detachMesh();
+    /**
+     * Returns the size of the host copy of the vertex attributes in bytes
+     */
+    size_t hostVertexBytes() const;
+    /**
+     * Frees the host copies of the mesh, if enabled and no other entity shares it
+     * @see setReleaseHostGeometry()
+     */
+    void releaseHostGeometry();
+    /**
+     * Restores host copies freed by releaseHostGeometry()
+     * @throws ResourceError If they must be reloaded, and the model file no longer matches the uploaded geometry
+     */
+    void restoreHostGeometry();
+    std::shared_ptr<Mesh> mesh;
     static std::vector<std::shared_ptr<Shaders>> convertToShader(std::initializer_list<const Stock::Shaders::ShaderSet> ss) {
         std::vector<std::shared_ptr<Shaders>> rtn;
         for (auto&& s : ss)
@@ -132,11 +392,20 @@ class Entity : public Renderable {
     bool needsExport;
     bool cullFace;
     static const char *OBJ_TYPE;
+    static const char *GLB_TYPE;
     static const char *EXPORT_TYPE;
-    void importModel(const char *path);
     std::unique_ptr<Entity> keyframe_model;
 
  private:
+    /**
+     * Binds the keyframe atlas and its dimensions to the provided shader
+     */
+    void bindKeyFrames(const std::shared_ptr<Shaders> &s) const;
+    /**
+     * Vertices of all keyframes loaded by loadKeyFrameModels(), shared between entities with the same keyframes
+     */
+    std::shared_ptr<ShaderStorageBuffer> keyframeAtlas;
+    unsigned int keyframeCount = 0;
     struct ExportMask {
         unsigned char FILE_TYPE_FLAG;
         unsigned char VERSION_FLAG;
@@ -154,8 +423,54 @@ class Entity : public Renderable {
         unsigned int  FILE_HAS_FACES_3 : 1;
         unsigned int  RESERVED_SPACE : 32;
     };
+    /**
+     * Header of binary exports, from version 2
+     * The vertex and index blocks begin at multiples of EXPORT_ALIGNMENT, so that a memory mapped export can be passed
+     * straight to glBufferData() without an intermediate copy
+     * The vertex block has the same layout as the vertex buffer (positions, normals, colors, texcoords)
+     */
+    struct ExportHeader {
+        unsigned char FILE_TYPE_FLAG;
+        unsigned char VERSION_FLAG;
+        unsigned char SIZE_OF_FLOAT;
+        unsigned char SIZE_OF_UINT;
+        uint32_t LOADER_VERSION;
+        uint64_t SOURCE_HASH;
+        uint64_t SOURCE_SIZE;
+        uint32_t VN_COUNT;
+        uint32_t FACE_COUNT;
+        // Component counts of each attribute, 0 if the attribute is not present
+        unsigned char POSITION_COMPONENTS;
+        unsigned char NORMAL_COMPONENTS;
+        unsigned char COLOR_COMPONENTS;
+        unsigned char TEXCOORD_COMPONENTS;
+        // Location of the null terminated mtllib and usemtl strings
+        uint32_t MATERIAL_OFFSET;
+        uint32_t MATERIAL_SIZE;
+        // Bitmask of EXPORT_FLAG_*
+        uint32_t FLAGS;
+        uint64_t VERTEX_OFFSET;
+        uint64_t VERTEX_SIZE;
+        uint64_t INDEX_OFFSET;
+        uint64_t INDEX_SIZE;
+        // Bounding volumes, for culling
+        float BOUNDS_MIN[3];
+        float BOUNDS_MAX[3];
+        float BOUNDING_SPHERE[4];
+    };
+    /**
+     * Writes a binary export of the provided model data
+     * This writes to a temporary file which is then renamed, so concurrent readers never see a partial export
+     * @return False if the export could not be written
+     */
+    static bool writeExport(const std::string &exportPath, const ExportHeader &header, const void *vertexData, const void *indexData, const std::string &mtllib, const std::string &usemtl);
     static const unsigned char FILE_TYPE_FLAG = 0x12;
-    static const unsigned char FILE_TYPE_VERSION = 1;
+    static const unsigned char FILE_TYPE_VERSION = 2;
+    // Incremented whenever a change to the .obj loader would change the data it produces, invalidating existing exports
+    static const uint32_t LOADER_VERSION = 1;
+    static const uint64_t EXPORT_ALIGNMENT = 4096;
+    // The export's faces and vertices were reordered by MeshOptimiser
+    static const uint32_t EXPORT_FLAG_OPTIMISED = 1 << 0;
 };
 
 }  // namespace visualiser
@@ -5,6 +5,7 @@
 #include <string>
 
 #include "Visualiser.h"
+#include "util/RateLimiter.h"
 
 
 namespace flamegpu {
@@ -20,8 +21,7 @@ class LockHolder {
 
 FLAMEGPU_Visualisation::FLAMEGPU_Visualisation(const ModelConfig& modelcfg)
     : vis(new Visualiser(modelcfg))
-    // int division is fine, sleeping less is better than sleeping more, system interrupts already mean sleep might be longer
-    , step_ms(modelcfg.stepsPerSecond ? 1000 / modelcfg.stepsPerSecond : 0) { }
+    , step_limiter(modelcfg.stepsPerSecond ? new RateLimiter(modelcfg.stepsPerSecond) : nullptr) { }
 FLAMEGPU_Visualisation::~FLAMEGPU_Visualisation() {
     if (vis)
         delete vis;
@@ -29,6 +29,8 @@ FLAMEGPU_Visualisation::~FLAMEGPU_Visualisation() {
         delete lock;
     if (dynamic_lines_lock)
         delete dynamic_lines_lock;
+    if (step_limiter)
+        delete step_limiter;
 }
 void FLAMEGPU_Visualisation::addAgentState(const char *agent_name, const char *state_name, const AgentStateConfig &vc,
     const std::map<TexBufferConfig::Function, TexBufferConfig>& core_tex_buffers, const std::multimap<TexBufferConfig::Function, CustomTexBufferConfig>& tex_buffers) {
@@ -47,12 +49,21 @@ void FLAMEGPU_Visualisation::registerEnvironmentProperty(const std::string& prop
 void FLAMEGPU_Visualisation::updateDynamicLine(const char *graph_name) {
     vis->updateDynamicLine(graph_name);
 }
+void FLAMEGPU_Visualisation::appendLineStream(const char *stream_name, const float *vertices, const float *colors, const unsigned int count) {
+    vis->appendLineStream(stream_name, vertices, colors, count);
+}
 void FLAMEGPU_Visualisation::setStepCount(const unsigned int stepCount) {
     vis->setStepCount(stepCount);
 }
 void FLAMEGPU_Visualisation::setRandomSeed(const uint64_t randomSeed) {
     vis->setRandomSeed(randomSeed);
 }
+void FLAMEGPU_Visualisation::setSwapInterval(const int interval) {
+    vis->setSwapInterval(interval);
+}
+void FLAMEGPU_Visualisation::setFrameRateLimit(const unsigned int fps) {
+    vis->setFrameRateLimit(fps);
+}
 void FLAMEGPU_Visualisation::start() {
     vis->start();
 }
@@ -83,18 +94,10 @@ void FLAMEGPU_Visualisation::releaseMutex() {
         lock = nullptr;
     }
     // Block the return to hit the desired steps per second
-    if (step_ms) {
-        static unsigned int last_ticks;
-        const unsigned int new_ticks = SDL_GetTicks();
-        const int sleep_time = step_ms - (new_ticks - last_ticks);
-        if (sleep_time > 0) {
-            SDL_Delay(sleep_time);
-            last_ticks += step_ms;
-        } else if (last_ticks < new_ticks) {
-            // Edge case where a step takes longer than step_ms
-            last_ticks = new_ticks;
-        }
-    }
+    // Steps are scheduled against a fixed period, so sleep overshoot does not accumulate
+    // If a step (or a pause) overruns by more than a period, the schedule restarts rather than bursting to catch up
+    if (step_limiter)
+        step_limiter->wait();
 }
 void FLAMEGPU_Visualisation::lockDynamicLinesMutex() {
     dynamic_lines_lock = new LockHolder(vis->getDynamicLineMutex());
@@ -0,0 +1,221 @@
+#include "flamegpu/visualiser/StaticScene.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <limits>
+
+namespace flamegpu {
+namespace visualiser {
+
+bool StaticScene::canMerge(const Entity::ModelData &model, const bool overrideMaterial) {
+    // Entity loads a model's own materials under the same conditions
+    const bool hasMaterials = (!model.mtllib.empty() && !model.usemtl.empty()) || !model.modelMaterials.empty();
+    return overrideMaterial || !hasMaterials;
+}
+/*
+Merges the provided models into a single vertex and index buffer, and uploads them
+Each part's vertices are transformed to world space, so the scene is drawn with an identity model matrix
+Indices are left relative to their part, and rebased by the draw's base vertex, so 16 bit indices are used whenever every
+part has fewer than 65536 vertices
+@param parts The models to be merged, and their transforms
+@param shaders The shader used to draw the scene
+@param texture Optional diffuse texture, shared by all parts
+*/
+StaticScene::StaticScene(const std::vector<Part> &parts, std::shared_ptr<Shaders> _shaders, std::shared_ptr<const Texture> texture)
+    : shaders({ _shaders })
+    , texture(texture)
+    , materialBuffer(std::make_shared<UniformBuffer>(sizeof(MaterialProperties)))
+    , viewMatPtr(nullptr)
+    , projectionMatPtr(nullptr)
+    , lightBufferBindPt(UINT_MAX)
+    , positions(GL_FLOAT, 3, sizeof(float))
+    , normals(GL_FLOAT, NORMALS_SIZE, sizeof(float))
+    , texcoords(GL_FLOAT, 2, sizeof(float))
+    , faces(GL_UNSIGNED_INT, 3, sizeof(unsigned int))
+    , indexType(GL_UNSIGNED_INT)
+    , modelMat(1.0f) {
+    GL_CHECK();
+    if (parts.empty()) {
+        THROW ResourceError("StaticScene::StaticScene(): A static scene requires at least 1 model.");
+    }
+    // Count the elements of the merged buffers
+    size_t vertexCount = 0, indexCount = 0;
+    unsigned int maxPartVertices = 0;
+    for (const Part &p : parts) {
+        vertexCount += p.model->vn_count;
+        indexCount += p.model->faces.count * p.model->faces.components;
+        maxPartVertices = std::max(maxPartVertices, p.model->vn_count);
+    }
+    if (vertexCount > INT_MAX || indexCount > UINT_MAX) {
+        THROW ResourceError("StaticScene::StaticScene(): %llu vertices exceeds the limit of a static scene.", static_cast<unsigned long long>(vertexCount));
+    }
+    // Attributes are stored one after another within a single vbo, texcoords are only required if textured
+    const bool hasTexcoords = texture != nullptr;
+    positions.count = static_cast<unsigned int>(vertexCount);
+    normals.count = static_cast<unsigned int>(vertexCount);
+    texcoords.count = hasTexcoords ? static_cast<unsigned int>(vertexCount) : 0;
+    faces.count = static_cast<unsigned int>(indexCount / faces.components);
+    normals.offset = static_cast<unsigned int>(positions.count * positions.elementSize());
+    texcoords.offset = normals.offset + static_cast<unsigned int>(normals.count * normals.elementSize());
+    std::vector<float> vertexData(vertexCount * (positions.components + normals.components) + texcoords.count * texcoords.components);
+    float *outPositions = vertexData.data();
+    float *outNormals = outPositions + vertexCount * positions.components;
+    float *outTexcoords = outNormals + vertexCount * normals.components;
+    indexType = maxPartVertices <= std::numeric_limits<uint16_t>::max() ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    const size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    std::vector<uint16_t> shortIndices(indexType == GL_UNSIGNED_SHORT ? indexCount : 0);
+    std::vector<uint32_t> intIndices(indexType == GL_UNSIGNED_INT ? indexCount : 0);
+    // Bake each part's transform into its vertices
+    size_t baseVertex = 0, firstIndex = 0;
+    for (const Part &p : parts) {
+        const Entity::ModelData &m = *p.model;
+        // Attributes are sub-allocations of the positions buffer
+        const char *src = static_cast<const char*>(m.positions.data);
+        const float *srcPositions = reinterpret_cast<const float*>(src + m.positions.offset);
+        const float *srcNormals = m.normals.count ? reinterpret_cast<const float*>(src + m.normals.offset) : nullptr;
+        const float *srcTexcoords = m.texcoords.count ? reinterpret_cast<const float*>(src + m.texcoords.offset) : nullptr;
+        const glm::mat3 normalMat = glm::transpose(glm::inverse(glm::mat3(p.transform)));
+        for (unsigned int i = 0; i < m.vn_count; ++i) {
+            const float *sp = srcPositions + i * m.positions.components;
+            const glm::vec3 position = glm::vec3(p.transform * glm::vec4(sp[0], sp[1], sp[2], 1.0f));
+            std::copy(&position[0], &position[0] + 3, outPositions + (baseVertex + i) * 3);
+            glm::vec3 normal(0.0f);
+            if (srcNormals) {
+                const float *sn = srcNormals + i * m.normals.components;
+                normal = normalMat * glm::vec3(sn[0], sn[1], sn[2]);
+                // Degenerate normals are left as zero, rather than becoming NaN
+                const float len = glm::length(normal);
+                normal = len > 0.0f ? normal / len : glm::vec3(0.0f);
+            }
+            std::copy(&normal[0], &normal[0] + 3, outNormals + (baseVertex + i) * 3);
+            if (hasTexcoords) {
+                float *dt = outTexcoords + (baseVertex + i) * 2;
+                dt[0] = srcTexcoords ? srcTexcoords[i * m.texcoords.components] : 0.0f;
+                dt[1] = srcTexcoords ? srcTexcoords[i * m.texcoords.components + 1] : 0.0f;
+            }
+        }
+        const unsigned int *srcFaces = static_cast<const unsigned int*>(m.faces.data);
+        const size_t partIndices = m.faces.count * m.faces.components;
+        if (indexType == GL_UNSIGNED_SHORT)
+            std::copy(srcFaces, srcFaces + partIndices, shortIndices.begin() + firstIndex);
+        else
+            std::copy(srcFaces, srcFaces + partIndices, intIndices.begin() + firstIndex);
+        drawCounts.push_back(static_cast<GLsizei>(partIndices));
+        drawOffsets.push_back(reinterpret_cast<const void*>(firstIndex * indexSize));
+        drawBaseVertices.push_back(static_cast<GLint>(baseVertex));
+        baseVertex += m.vn_count;
+        firstIndex += partIndices;
+    }
+    // Upload
+    GL_CALL(glGenBuffers(1, &positions.vbo));
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, positions.vbo));
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_STATIC_DRAW));
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    normals.vbo = positions.vbo;
+    texcoords.vbo = texcoords.count ? positions.vbo : 0;
+    GL_CALL(glGenBuffers(1, &faces.vbo));
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, faces.vbo));
+    if (indexType == GL_UNSIGNED_SHORT) {
+        GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(uint16_t), shortIndices.data(), GL_STATIC_DRAW));
+    } else {
+        GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, intIndices.size() * sizeof(uint32_t), intIndices.data(), GL_STATIC_DRAW));
+    }
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+    // Setup the provided shaders
+    for (auto &&it : this->shaders) {
+        if (it) {
+            it->setPositionsAttributeDetail(positions);
+            it->setNormalsAttributeDetail(normals);
+            it->setTexCoordsAttributeDetail(texcoords);
+            it->setMaterialBuffer(materialBuffer);
+            it->setFaceVBO(faces.vbo);
+            if (texture)
+                it->addTexture("t_diffuse", texture);
+        }
+    }
+    // Setup the default material
+    materials.push_back(Material(materialBuffer, 0));
+    if (texture) {
+        Material::TextureFrame frame = Material::TextureFrame();
+        frame.texture = texture;
+        materials[0].addTexture(frame, Material::TextureType::Diffuse);
+    }
+    bindMaterial();
+}
+/*
+Destructor, frees the merged buffers
+*/
+StaticScene::~StaticScene() {
+    materials.clear();
+    materialBuffer.reset();
+    GL_CALL(glDeleteBuffers(1, &positions.vbo));
+    GL_CALL(glDeleteBuffers(1, &faces.vbo));
+}
+void StaticScene::bindMaterial() {
+    for (auto &m : materials) {
+        auto it = m.getShaders();
+        if (it) {
+            it->setPositionsAttributeDetail(positions);
+            it->setNormalsAttributeDetail(normals);
+            it->setTexCoordsAttributeDetail(texcoords);
+            it->setMaterialBuffer(materialBuffer);
+            it->setFaceVBO(faces.vbo);
+        }
+        m.setCustomShaders(this->shaders);
+        if (viewMatPtr)
+            m.setViewMatPtr(viewMatPtr);
+        if (projectionMatPtr)
+            m.setProjectionMatPtr(projectionMatPtr);
+        if (lightBufferBindPt != UINT_MAX)
+            m.setLightsBuffer(lightBufferBindPt);
+        m.bake();
+    }
+}
+void StaticScene::setMaterial(const glm::vec3 &ambient, const glm::vec3 &diffuse, const glm::vec3 &specular, const float &shininess, const float &opacity) {
+    materials.clear();
+    materials.push_back(Material(materialBuffer, 0, { "", ambient, diffuse, specular, shininess, opacity }));
+    bindMaterial();
+}
+/*
+Draws all parts with a single call, each part is a separate draw of the multi-draw so that its indices may remain 16 bit
+*/
+void StaticScene::render(unsigned int shaderIndex) {
+    materials[0].use(modelMat, shaderIndex, true);
+    GL_CALL(glMultiDrawElementsBaseVertex(GL_TRIANGLES, drawCounts.data(), indexType, drawOffsets.data(), static_cast<GLsizei>(drawCounts.size()), drawBaseVertices.data()));
+    materials[0].clear();
+}
+void StaticScene::reload() {
+    for (auto &&it : shaders)
+        if (it)
+            it->reload();
+    for (auto &&it : materials)
+        it.reload();
+}
+void StaticScene::setViewMatPtr(glm::mat4 const *viewMat) {
+    viewMatPtr = viewMat;
+    for (auto &&it : shaders)
+        if (it)
+            it->setViewMatPtr(viewMat);
+    for (auto &m : materials)
+        m.setViewMatPtr(viewMat);
+}
+void StaticScene::setProjectionMatPtr(glm::mat4 const *projectionMat) {
+    projectionMatPtr = projectionMat;
+    for (auto &&it : shaders)
+        if (it)
+            it->setProjectionMatPtr(projectionMat);
+    for (auto &m : materials)
+        m.setProjectionMatPtr(projectionMat);
+}
+void StaticScene::setLightsBuffer(const GLuint &bufferBindingPoint) {
+    lightBufferBindPt = bufferBindingPoint;
+    for (auto &&it : shaders)
+        if (it)
+            it->setLightsBuffer(bufferBindingPoint);
+    for (auto &m : materials)
+        m.setLightsBuffer(bufferBindingPoint);
+}
+
+}  // namespace visualiser
+}  // namespace flamegpu
@@ -0,0 +1,97 @@
+#ifndef SRC_FLAMEGPU_VISUALISER_STATICSCENE_H_
+#define SRC_FLAMEGPU_VISUALISER_STATICSCENE_H_
+
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "flamegpu/visualiser/Entity.h"
+#include "flamegpu/visualiser/interface/Renderable.h"
+#include "flamegpu/visualiser/model/Material.h"
+#include "flamegpu/visualiser/shader/Shaders.h"
+#include "flamegpu/visualiser/texture/Texture.h"
+
+namespace flamegpu {
+namespace visualiser {
+
+/**
+ * Several static models, merged into a single vertex and index buffer and drawn with a single multi-draw call
+ * Each model's world transform is baked into its vertices, so the whole scene shares one material, one program bind and
+ * one (identity) model matrix, rather than paying for them per model as individual entities do
+ */
+class StaticScene : public Renderable {
+ public:
+    /**
+     * A model placed within the scene
+     */
+    struct Part {
+        std::shared_ptr<const Entity::ModelData> model;
+        // Model matrix of the part, as returned by Entity::getModelMat()
+        glm::mat4 transform;
+    };
+    /**
+     * Returns true if the model would be drawn the same as part of a static scene as by its own entity
+     * Models with materials of their own can only be merged if the material is to be overridden by setMaterial()
+     * @param model The model to be merged
+     * @param overrideMaterial True if setMaterial() will be called on the scene
+     */
+    static bool canMerge(const Entity::ModelData &model, bool overrideMaterial);
+    /**
+     * Merges and uploads the provided models
+     * @param parts The models to be merged, and their transforms
+     * @param shaders The shader used to draw the scene
+     * @param texture Optional diffuse texture, shared by all parts
+     * @throws ResourceError If parts is empty
+     */
+    StaticScene(const std::vector<Part> &parts, std::shared_ptr<Shaders> shaders, std::shared_ptr<const Texture> texture = nullptr);
+    ~StaticScene();
+    StaticScene(const StaticScene&) = delete;
+    StaticScene &operator=(const StaticScene&) = delete;
+    /**
+     * Overrides the material in use, this will lose the texture
+     */
+    void setMaterial(const glm::vec3 &ambient, const glm::vec3 &diffuse, const glm::vec3 &specular = glm::vec3(0.1f), const float &shininess = 10.0f, const float &opacity = 1.0f);
+    /**
+     * Draws every part of the scene
+     */
+    void render(unsigned int shaderIndex = 0);
+    void reload() override;
+    void setViewMatPtr(glm::mat4 const *viewMat) override;
+    using Renderable::setViewMatPtr;
+    void setProjectionMatPtr(glm::mat4 const *projectionMat) override;
+    using Renderable::setProjectionMatPtr;
+    void setLightsBuffer(const GLuint &bufferBindingPoint) override;
+    using Renderable::setLightsBuffer;
+    /**
+     * Returns the number of models merged into the scene
+     */
+    size_t getPartCount() const { return drawCounts.size(); }
+
+ private:
+    /**
+     * Points the shaders of the material and custom shaders to the scene's buffers
+     */
+    void bindMaterial();
+    std::vector<std::shared_ptr<Shaders>> shaders;
+    std::shared_ptr<const Texture> texture;
+    std::shared_ptr<UniformBuffer> materialBuffer;
+    std::vector<Material> materials;
+    glm::mat4 const *viewMatPtr;
+    glm::mat4 const *projectionMatPtr;
+    GLuint lightBufferBindPt;
+    Shaders::VertexAttributeDetail positions, normals, texcoords, faces;
+    // Type of the indices within faces.vbo, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    GLenum indexType;
+    // Arguments of glMultiDrawElementsBaseVertex(), one element per part
+    std::vector<GLsizei> drawCounts;
+    std::vector<const void*> drawOffsets;
+    std::vector<GLint> drawBaseVertices;
+    // The model matrix of all parts, as their transforms are baked into their vertices
+    glm::mat4 modelMat;
+};
+
+}  // namespace visualiser
+}  // namespace flamegpu
+
+#endif  // SRC_FLAMEGPU_VISUALISER_STATICSCENE_H_
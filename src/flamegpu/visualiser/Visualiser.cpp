@@ -23,16 +23,13 @@
 #include "flamegpu/visualiser/shader/DirectionFunction.h"
 #include "flamegpu/visualiser/shader/ScaleFunction.h"
 #include "flamegpu/visualiser/shader/lights/LightsBuffer.h"
+#include "flamegpu/visualiser/shader/buffer/ShaderStorageBuffer.h"
 #include "flamegpu/visualiser/ui/Text.h"
 #include "flamegpu/visualiser/ui/SplashScreen.h"
 #include "flamegpu/visualiser/multipass/FrameBuffer.h"
 #include "flamegpu/visualiser/multipass/FrameBufferAttachment.h"
 #include "util/Resources.h"
 
-#if defined(__GNUC__) || defined(__clang__)
-#include <fontconfig/fontconfig.h>
-#endif
-
 namespace flamegpu {
 namespace visualiser {
 
@@ -43,7 +40,8 @@ namespace visualiser {
 #define MOUSE_SPEED_FPS 0.05f
 #define DELTA_ROLL 0.01f
 #define ONE_SECOND_MS 1000
-#define VSYNC 1
+// Frames drawn following input or camera movement, when idle rendering
+#define IDLE_ACTIVE_FRAMES 3
 
 #define MOVEMENT_MULTIPLIER 1.f
 #define AXIS_LEFT_DEAD_ZONE 0.2f
@@ -64,7 +62,8 @@ Visualiser::RenderInfo::RenderInfo(const AgentStateConfig& vc,
     , instanceCount(0)
     , entity(nullptr)
     , requiredSize(0)
-    , dataSize(0) {
+    , dataSize(0)
+    , trailOutOfDate(false) {
         // Copy texture buffers to dedicated structures
         for (auto &c : _core_tex_buffers) {
             core_texture_buffers.emplace(c.first, nullptr);
@@ -73,10 +72,26 @@ Visualiser::RenderInfo::RenderInfo(const AgentStateConfig& vc,
             custom_texture_buffers.emplace(c.first, std::make_pair(c.second, nullptr));
         }
         // Select the corresponding shader
-        VertexFunction vf(_core_tex_buffers, vc.model_pathB);
+        VertexFunction vf(_core_tex_buffers, vc.model_pathB, vc.model_keyframes.size());
         PositionFunction pf(_core_tex_buffers);
         DirectionFunction df(_core_tex_buffers);
         ScaleFunction sf(_core_tex_buffers);
+        position_src = pf.getSrc();
+        shader_src = vf.getSrc() + position_src + df.getSrc() + sf.getSrc();
+        // Begin decoding the models/texture, the entity is created later in createEntity()
+        Entity::preload(vc.model_path);
+        if (vc.model_pathB) {
+            Entity::preload(vc.model_pathB);
+        }
+        for (const auto &keyframe : vc.model_keyframes) {
+            Entity::preload(keyframe);
+        }
+        if (vc.model_texture) {
+            Texture2D::preload(vc.model_texture);
+        }
+}
+void Visualiser::RenderInfo::createEntity() {
+        const AgentStateConfig &vc = config;
         if (!vc.color_shader_src.empty()) {
             // Entity has a color and direction override
             entity = std::make_shared<Entity>(
@@ -86,7 +101,7 @@ Visualiser::RenderInfo::RenderInfo(const AgentStateConfig& vc,
                     "resources/instanced_default_Tcolor_Tpos_Tdir_Tscale.vert",
                     "resources/material_flat_Tcolor.frag",
                     "",
-                    vf.getSrc() + pf.getSrc() + df.getSrc() + sf.getSrc() + vc.color_shader_src));
+                    shader_src + vc.color_shader_src));
         } else if (vc.model_texture) {
             // Entity has texture
             entity = std::make_shared<Entity>(
@@ -96,7 +111,7 @@ Visualiser::RenderInfo::RenderInfo(const AgentStateConfig& vc,
                     "resources/instanced_default_Tpos_Tdir_Tscale.vert",
                     "resources/material_phong.frag",
                     "",
-                    vf.getSrc() + pf.getSrc() + df.getSrc() + sf.getSrc()),
+                    shader_src),
                 Texture2D::load(vc.model_texture));
         } else {
             // Entity does not have a texture
@@ -107,12 +122,19 @@ Visualiser::RenderInfo::RenderInfo(const AgentStateConfig& vc,
                     "resources/instanced_default_Tpos_Tdir_Tscale.vert",
                     "resources/material_flat.frag",
                     "",
-                    vf.getSrc() + pf.getSrc() + df.getSrc() + sf.getSrc()));
+                    shader_src));
             entity->setMaterial(glm::vec3(0.1f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.7f));
         }
-        if (vc.model_pathB) {
+        if (vc.model_keyframes.size() >= 2) {
+            // Only bound if VertexFunction generated the keyframe atlas lookup
+            if (core_texture_buffers.find(TexBufferConfig::AnimationFrame) != core_texture_buffers.end())
+                entity->loadKeyFrameModels(vc.model_keyframes);
+        } else if (vc.model_pathB) {
             entity->loadKeyFrameModel(vc.model_pathB);
         }
+        if (vc.trail_length) {
+            trail = std::make_shared<AgentTrail>(position_src, vc.trail_length, *reinterpret_cast<const glm::vec4*>(vc.trail_color), vc.trail_fade);
+        }
 }
 void addLine(std::shared_ptr<Draw> &lines, const std::shared_ptr<LineConfig> &line, const std::string &name, bool replace) {
     // Check it's valid
@@ -125,13 +147,9 @@ void addLine(std::shared_ptr<Draw> &lines, const std::shared_ptr<LineConfig> &li
             THROW SketchError("Lines sketch contains invalid number of vertices (%d/3) or colours (%d/4).\n", line->vertices.size(), line->colors.size());
         }
     }
-    // Convert to Draw
-    lines->begin(line->lineType == LineConfig::Type::Polyline ? Draw::Type::Polyline : Draw::Type::Lines, name);
-    for (size_t i = 0; i < line->vertices.size() / 3; ++i) {
-        lines->color(*reinterpret_cast<const glm::vec4*>(&line->colors[i * 4]));
-        lines->vertex(*reinterpret_cast<const glm::vec3*>(&line->vertices[i * 3]));
-    }
-    lines->save(replace);
+    // Upload the arrays straight to the Draw's buffers
+    lines->saveArrays(name, line->lineType == LineConfig::Type::Polyline ? Draw::Type::Polyline : Draw::Type::Lines,
+        line->vertices.data(), line->colors.data(), static_cast<unsigned int>(line->vertices.size() / 3), replace);
 }
 Visualiser::Visualiser(const ModelConfig& modelcfg)
     : hud(std::make_shared<HUD>(modelcfg.windowDimensions[0], modelcfg.windowDimensions[1]))
@@ -153,6 +171,8 @@ Visualiser::Visualiser(const ModelConfig& modelcfg)
     , joystick(nullptr)
     , joystickInstance(0)
     , gamepadConnected(false) {
+    setSwapInterval(modelcfg.swapInterval);
+    setFrameRateLimit(modelcfg.frameRateLimit);
     this->isInitialised = this->init();
     // Init splash screen
     splashScreen = std::make_shared<SplashScreen>(*reinterpret_cast<const glm::vec3*>(&modelcfg.fpsColor[0]), "Loading...", modelcfg.isPython);
@@ -160,6 +180,9 @@ Visualiser::Visualiser(const ModelConfig& modelcfg)
     lighting = std::make_shared<LightsBuffer>(camera->getViewMatPtr());
     // Apply user specified stuff
     BackBuffer::setClear(true, *reinterpret_cast<const glm::vec3*>(&modelcfg.clearColor[0]));
+    Entity::setOptimiseModels(modelcfg.optimiseModels);
+    Entity::setPackModelVertices(modelcfg.packModelVertices);
+    Entity::setReleaseHostGeometry(modelcfg.releaseModelGeometry);
     if (modelcfg.fpsVisible) {
         fpsDisplay = std::make_shared<Text>("", 10, *reinterpret_cast<const glm::vec3 *>(&modelcfg.fpsColor[0]), fonts::findFont({"Arial"}, fonts::GenericFontFamily::SANS).c_str());
         fpsDisplay->setUseAA(false);
@@ -183,8 +206,38 @@ Visualiser::Visualiser(const ModelConfig& modelcfg)
     lines_dynamic = std::make_shared<Draw>();
     lines_dynamic->setViewMatPtr(camera->getViewMatPtr());
     lines_dynamic->setProjectionMatPtr(&this->projMat);
+    for (const auto &[name, stream] : modelcfg.line_streams) {
+        if (stream->capacity < 2) {
+            THROW SketchError("Line stream '%s' requires a capacity of at least 2 points.\n", name.c_str());
+        }
+        lines_dynamic->createStream(name, stream->capacity);
+    }
     // Process static models
+    // Decode all model and texture files in parallel, before any are uploaded
+    for (auto &sm : modelcfg.staticModels) {
+        Entity::preload(sm->path);
+        if (!sm->texture.empty())
+            Texture2D::preload(sm->texture);
+    }
+    // Models which would be drawn with the same shader and material are merged into a static scene, drawn with a single call
+    // Untextured models share a flat material, textured models are grouped by texture
+    std::map<std::string, std::vector<StaticScene::Part>> sceneParts;
     for (auto &sm : modelcfg.staticModels) {
+        // Instanced models are drawn with a single instanced draw, so gain nothing from merging
+        const bool instanced = !sm->instances.empty();
+        if (!instanced) {
+            std::shared_ptr<const Entity::ModelData> data = Entity::loadModelData(sm->path);
+            if (StaticScene::canMerge(*data, sm->texture.empty())) {
+                const glm::vec3 scaleFactor = Entity::getScaleFactor(*reinterpret_cast<const glm::vec3*>(sm->scale), data->modelMax - data->modelMin);
+                sceneParts[sm->texture].push_back({ data, Entity::getModelMat(
+                    *reinterpret_cast<const glm::vec3*>(sm->location),
+                    *reinterpret_cast<const glm::vec4*>(sm->rotation),
+                    scaleFactor) });
+                continue;
+            }
+        }
+        // Instanced models read each instance's transform within the vertex shader
+        const char *vertexShader = instanced ? "resources/instanced_static.vert" : "resources/default.vert";
         std::shared_ptr<Entity> entity;
         if (sm->texture.empty()) {
             // Entity does not have a texture
@@ -192,7 +245,7 @@ Visualiser::Visualiser(const ModelConfig& modelcfg)
                 sm->path.c_str(),
                 *reinterpret_cast<const glm::vec3*>(sm->scale),
                 std::make_shared<Shaders>(
-                    "resources/default.vert",
+                    vertexShader,
                     "resources/material_flat.frag"));
             entity->setMaterial(glm::vec3(0.1f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.7f));
         } else {
@@ -201,7 +254,7 @@ Visualiser::Visualiser(const ModelConfig& modelcfg)
                 sm->path.c_str(),
                 *reinterpret_cast<const glm::vec3*>(&sm->scale),
                 std::make_shared<Shaders>(
-                    "resources/default.vert",
+                    vertexShader,
                     "resources/material_phong.frag"),
                 Texture2D::load(sm->texture));
         }
@@ -212,9 +265,55 @@ Visualiser::Visualiser(const ModelConfig& modelcfg)
             entity->setProjectionMatPtr(&this->projMat);
             entity->setLightsBuffer(this->lighting);
 
-            staticModels.push_back(entity);
+            if (instanced) {
+                // Upload the transforms once, matching _StaticInstance within instanced_static.vert
+                struct StaticInstance {
+                    glm::mat4 modelMat;
+                    glm::mat4 normalMat;
+                };
+                const glm::mat4 modelMat = Entity::getModelMat(entity->getLocation(), entity->getRotation(),
+                    Entity::getScaleFactor(*reinterpret_cast<const glm::vec3*>(sm->scale), entity->getDimensions()));
+                std::vector<StaticInstance> transforms;
+                transforms.reserve(sm->instances.size());
+                for (const auto &inst : sm->instances) {
+                    const glm::mat4 instanceMat = Entity::getModelMat(
+                        *reinterpret_cast<const glm::vec3*>(inst.location),
+                        *reinterpret_cast<const glm::vec4*>(inst.rotation),
+                        *reinterpret_cast<const glm::vec3*>(inst.scale));
+                    transforms.push_back({ instanceMat, glm::mat4(glm::transpose(glm::inverse(glm::mat3(instanceMat * modelMat)))) });
+                }
+                auto buffer = std::make_shared<ShaderStorageBuffer>(transforms.size() * sizeof(StaticInstance), transforms.data());
+                entity->getShaders()->addBuffer("_staticInstances", buffer);
+                staticInstances.push_back({ entity, buffer, static_cast<unsigned int>(transforms.size()) });
+            } else {
+                staticModels.push_back(entity);
+            }
+        }
+    }
+    for (const auto &[texture, parts] : sceneParts) {
+        std::shared_ptr<StaticScene> scene;
+        if (texture.empty()) {
+            scene = std::make_shared<StaticScene>(
+                parts,
+                std::make_shared<Shaders>(
+                    "resources/default.vert",
+                    "resources/material_flat.frag"));
+            scene->setMaterial(glm::vec3(0.1f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.7f));
+        } else {
+            scene = std::make_shared<StaticScene>(
+                parts,
+                std::make_shared<Shaders>(
+                    "resources/default.vert",
+                    "resources/material_phong.frag"),
+                Texture2D::load(texture));
         }
+        scene->setViewMatPtr(camera->getViewMatPtr());
+        scene->setProjectionMatPtr(&this->projMat);
+        scene->setLightsBuffer(this->lighting);
+        staticScenes.push_back(scene);
     }
+    Entity::clearPreloaded();
+    Texture2D::clearPreloaded();
     // Process lines
     for (auto &line : modelcfg.lines) {
         addLine(lines_static, line, std::to_string(totalLines++), false);
@@ -231,10 +330,8 @@ Visualiser::Visualiser(const ModelConfig& modelcfg)
 }
 Visualiser::~Visualiser() {
     this->close();
-#if defined(__GNUC__) || defined(__clang__)
     // Fully clean up font config
-    FcFini();
-#endif
+    fonts::releaseFontConfig();
 }
 void Visualiser::start() {
     // Only execute if background thread is not active
@@ -243,6 +340,8 @@ void Visualiser::start() {
             // Async window was closed via cross, so thread still exists
             join();  // This kills the thread properly
         }
+        // Upload any agent models that were decoded in the background since addAgentState()
+        createAgentStateEntities();
         // Clear the context from current thread, otherwise we cant move it to background thread
         SDL_GL_MakeCurrent(this->window, NULL);
         SDL_DestroyWindow(this->window);
@@ -276,6 +375,8 @@ void Visualiser::join() {
 }
 void Visualiser::stop() {
     this->continueRender = false;
+    // Wake the render loop, so that it notices
+    requestRedraw();
 }
 void Visualiser::run() {
     if (!this->isInitialised) {
@@ -305,18 +406,35 @@ void Visualiser::run() {
             if (err != 0) {
                 THROW VisAssert("Visualiser::run(): SDL_GL_MakeCurrent failed!\n", SDL_GetError());
             }
+            // The swap interval belongs to the window, so must be reapplied
+            this->applySwapInterval();
             GL_CHECK();
             this->resizeWindow();
             GL_CHECK();
             SDL_StartTextInput();
             while (this->continueRender) {
+                if (modelConfig.idleRendering) {
+                    waitForRedraw();
+                    if (!this->continueRender)
+                        break;
+                }
+                if (this->swapInterval != this->appliedSwapInterval)
+                    this->applySwapInterval();
                 //  Update the fps in the window title
                 this->updateFPS();
                 if (this->stepDisplay) {
-                    this->spsDisplay->setString("%.3f sps", stepsPerSecond);
+                    // Report the actual rate against the target, if the step rate is limited
+                    if (modelConfig.stepsPerSecond && !pause_guard)
+                        this->spsDisplay->setString("%.3f / %u sps", stepsPerSecond, modelConfig.stepsPerSecond);
+                    else
+                        this->spsDisplay->setString("%.3f sps", stepsPerSecond);
                     this->stepDisplay->setString("%sStep %u", (pause_guard? "(Paused) " : ""), stepCount);
                 }
                 this->render();
+                // Limit the frame rate, independent of vsync
+                if (frameLimiter.getRate() != static_cast<double>(frameRateLimit))
+                    frameLimiter.setRate(frameRateLimit);
+                frameLimiter.wait();
             }
             SDL_StopTextInput();
             // Release mouse lock
@@ -337,12 +455,14 @@ void Visualiser::run() {
     }
 }
 void Visualiser::render() {
-    // Static fn var for tracking the time to send to scene->update()
-    static unsigned int updateTime = 0;
     const unsigned int t_updateTime = SDL_GetTicks();
     // If the program runs for over ~49 days, the return value of SDL_GetTicks() will wrap
     const unsigned int frameTime = t_updateTime < updateTime ? (t_updateTime + (UINT_MAX - updateTime)) : t_updateTime - updateTime;
     updateTime = t_updateTime;
+    // Requests made during this frame require another
+    redrawRequested = false;
+    if (activeFrames)
+        --activeFrames;
     SDL_Event e;
     //  Handle continuous key presses (movement)
     const Uint8* state = SDL_GetKeyboardState(NULL);
@@ -397,6 +517,9 @@ void Visualiser::render() {
     this->lighting->getPointLight(0).Position(this->camera->getEye());
     //  handle each event on the queue
     while (SDL_PollEvent(&e) != 0) {
+        // Any input may change the UI, so continue drawing briefly
+        if (e.type != redrawEventType)
+            activeFrames = IDLE_ACTIVE_FRAMES;
         if (!SDL_GetRelativeMouseMode()) {
             // Assume ImGUI is top level, allow it first chance on IO if mouse isn't locked for movement
             ImGui_ImplSDL2_ProcessEvent(&e);
@@ -451,12 +574,22 @@ void Visualiser::render() {
     }
     // Doesn't use the event class for some historical reason I (pth) don't remember.
     this->queryControllerAxis(frameTime);
+    // Continue drawing whilst the camera moves, as held keys and axes do not produce events every frame
+    if (*camera->getViewMatPtr() != lastViewMat || projMat != lastProjMat) {
+        lastViewMat = *camera->getViewMatPtr();
+        lastProjMat = projMat;
+        activeFrames = IDLE_ACTIVE_FRAMES;
+    }
     // Update lighting
     lighting->update();
     //  Render
     render_buffer->use();
     for (auto &sm : staticModels)
         sm->render();
+    for (auto &ss : staticScenes)
+        ss->render();
+    for (auto &si : staticInstances)
+        si.entity->renderInstances(si.count);
     renderAgentStates();
     // Close splash screen if we are ready (renderAgentStates sets this)
     if (closeSplashScreen && splashScreen) {
@@ -470,17 +603,21 @@ void Visualiser::render() {
         for (auto &name :  lines_dynamic_updates)
             addLine(lines_dynamic, modelConfig.dynamic_lines.at(name), name, true);
         lines_dynamic_updates.clear();
+        for (auto &[name, points] : line_stream_updates) {
+            if (points.vertices.empty())
+                continue;
+            lines_dynamic->appendStream(name, points.vertices.data(), points.colors.data(), static_cast<unsigned int>(points.vertices.size() / 3));
+            points.vertices.clear();
+            points.colors.clear();
+        }
     }
     // Render lines last, as they may contain alpha
     if (renderLines) {
         GL_CALL(glEnable(GL_BLEND));
         GL_CALL(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
-        for (unsigned int i = 0; i < totalLines; ++i)
-            lines_static->render(std::to_string(i));
-        for (const auto &[name, _] : modelConfig.dynamic_lines)
-            // Dynamic lines may begin uninitialised
-            if (lines_dynamic->has(name))
-                lines_dynamic->render(name);
+        lines_static->renderAll();
+        // Dynamic lines which are still uninitialised have no draw state, so are skipped
+        lines_dynamic->renderAll();
         GL_CALL(glDisable(GL_BLEND));
     }
     GL_CALL(glViewport(0, 0, windowDims.x, windowDims.y));
@@ -494,6 +631,35 @@ void Visualiser::render() {
     //  update the screen
     SDL_GL_SwapWindow(window);
 }
+void Visualiser::waitForRedraw() {
+    bool waited = false;
+    // The splash screen is drawn continuously until the simulation has loaded
+    while (continueRender && !redrawRequested && !activeFrames && closeSplashScreen) {
+        int timeout = -1;
+        if (modelConfig.idleHeartbeat) {
+            const unsigned int sinceLastFrame = SDL_GetTicks() - currentTime;
+            if (sinceLastFrame >= modelConfig.idleHeartbeat)
+                break;
+            timeout = static_cast<int>(modelConfig.idleHeartbeat - sinceLastFrame);
+        }
+        waited = true;
+        // Passing nullptr leaves the event in the queue
+        if (SDL_WaitEventTimeout(nullptr, timeout))
+            break;
+    }
+    // Time spent idle must not be treated as frame time, else held movement keys would jump the camera
+    if (waited)
+        updateTime = SDL_GetTicks();
+}
+void Visualiser::requestRedraw() {
+    // Only a single wake event is queued at a time
+    if (!redrawRequested.exchange(true) && modelConfig.idleRendering && redrawEventType != static_cast<Uint32>(-1)) {
+        SDL_Event e;
+        SDL_zero(e);
+        e.type = redrawEventType;
+        SDL_PushEvent(&e);
+    }
+}
 bool Visualiser::isRunning() const {
     return continueRender;
 }
@@ -507,12 +673,8 @@ void Visualiser::addAgentState(const std::string &agent_name, const std::string
     const std::map<TexBufferConfig::Function, TexBufferConfig>& core_tex_buffers, const std::multimap<TexBufferConfig::Function, CustomTexBufferConfig>& tex_buffers) {
     std::pair<std::string, std::string> namepair = { agent_name, state_name };
     GL_CHECK();
+    // Entity is allocated by createAgentStateEntities(), so that files of multiple agent states are loaded concurrently
     agentStates.emplace(std::make_pair(namepair, RenderInfo(vc, core_tex_buffers, tex_buffers)));
-    //  Allocate entity
-    auto &ent = agentStates.at(namepair).entity;
-    ent->setViewMatPtr(camera->getViewMatPtr());
-    ent->setProjectionMatPtr(&this->projMat);
-    ent->setLightsBuffer(this->lighting);
     // Check if there are multiple agent states
     for (auto &as : agentStates) {
         if (as.first.second != state_name) {
@@ -521,6 +683,23 @@ void Visualiser::addAgentState(const std::string &agent_name, const std::string
         }
     }
 }
+void Visualiser::createAgentStateEntities() {
+    for (auto &_as : agentStates) {
+        auto &as = _as.second;
+        if (as.entity)
+            continue;
+        as.createEntity();
+        as.entity->setViewMatPtr(camera->getViewMatPtr());
+        as.entity->setProjectionMatPtr(&this->projMat);
+        as.entity->setLightsBuffer(this->lighting);
+        if (as.trail) {
+            as.trail->setViewMatPtr(camera->getViewMatPtr());
+            as.trail->setProjectionMatPtr(&this->projMat);
+        }
+    }
+    Entity::clearPreloaded();
+    Texture2D::clearPreloaded();
+}
 
 void Visualiser::renderAgentStates() {
     static unsigned int texture_unit_counter = 1;
@@ -553,8 +732,11 @@ void Visualiser::renderAgentStates() {
             for (auto &_tb : as.core_texture_buffers) {
                 auto &tb = _tb.second;
                 const std::string samplerName = TexBufferConfig::SamplerName(_tb.first);
+                const bool isPosition = _tb.first <= TexBufferConfig::Position_xyz;
                 // Remove old buff from shader
                 shader_vec->removeTextureUniform(samplerName.c_str());
+                if (as.trail && isPosition)
+                    as.trail->removePositionTexture(samplerName);
                 CUDATextureBuffer<float> *old_tb = tb;
                 // Alloc new buffs (this needs to occur in render thread!)
                 tb = mallocGLInteropTextureBuffer<float>(newSize * TexBufferConfig::SamplerElements(_tb.first), 1);
@@ -568,6 +750,8 @@ void Visualiser::renderAgentStates() {
                 GL_CALL(glBindTexture(GL_TEXTURE_BUFFER, tb->glTexName));
                 GL_CALL(glActiveTexture(GL_TEXTURE0));
                 shader_vec->addTexture(samplerName.c_str(), GL_TEXTURE_BUFFER, tb->glTexName, as.tex_unit_offset + tui);
+                if (as.trail && isPosition)
+                    as.trail->addPositionTexture(samplerName, tb->glTexName, as.tex_unit_offset + tui);
                 // Free old buff
                 if (old_tb && old_tb->d_pointer)
                     freeGLInteropTextureBuffer(old_tb);
@@ -597,6 +781,8 @@ void Visualiser::renderAgentStates() {
                 ++tui;
                 GL_CHECK();
             }
+            if (as.trail)
+                as.trail->resize(newSize);
             hasResized = true;
         }
     }
@@ -636,12 +822,29 @@ void Visualiser::renderAgentStates() {
                 for (auto& _tb : as.custom_texture_buffers) {
                     _tb.second.second->updateMapped();
                 }
+                // Capture positions once per update, rather than once per frame
+                if (as.trail && as.trailOutOfDate) {
+                    as.trail->capture(as.dataSize);
+                    as.trailOutOfDate = false;
+                }
             }
         }
         GL_CHECK();
+        bool hasTrails = false;
         for (auto &as : agentStates) {
             if (!as.second.core_texture_buffers.empty() && as.second.dataSize)  // Check to make sure buffer has been allocated successfully
                 as.second.entity->renderInstances(static_cast<int>(as.second.dataSize));
+            hasTrails |= as.second.trail != nullptr;
+        }
+        // Trails fade out, so are drawn after all agents
+        if (hasTrails) {
+            GL_CALL(glEnable(GL_BLEND));
+            GL_CALL(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+            for (auto &as : agentStates) {
+                if (as.second.trail)
+                    as.second.trail->render();
+            }
+            GL_CALL(glDisable(GL_BLEND));
         }
     }
     if (guard)
@@ -654,7 +857,11 @@ void Visualiser::requestBufferResizes(const std::string &agent_name, const std::
     if (as.requiredSize != buffLen && force)
         buffersAllocated = false;
     // Update required size
-    as.requiredSize = buffLen;
+    if (as.requiredSize != buffLen) {
+        as.requiredSize = buffLen;
+        // Buffers are resized by the render thread
+        requestRedraw();
+    }
 }
 void Visualiser::updateAgentStateBuffer(const std::string &agent_name, const std::string &state_name, const unsigned buffLen,
     const std::map<TexBufferConfig::Function, TexBufferConfig>& ext_core_tex_buffers, const std::multimap<TexBufferConfig::Function, CustomTexBufferConfig>& ext_tex_buffers) {
@@ -684,6 +891,8 @@ void Visualiser::updateAgentStateBuffer(const std::string &agent_name, const std
                 }
             }
         }
+        as.trailOutOfDate = true;
+        requestRedraw();
     }
 }
 void Visualiser::registerEnvironmentProperty(const std::string& property_name, void* ptr, std::type_index /*type*/, unsigned int elements, bool is_const) {
@@ -696,6 +905,8 @@ bool Visualiser::init() {
         fprintf(stderr, "Unable to initialize SDL: %s", SDL_GetError());
         return false;
     }
+    // Used by requestRedraw() to wake an idle render loop
+    redrawEventType = SDL_RegisterEvents(1);
 
     SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
     //  Enable MSAA (Must occur before SDL_CreateWindow)
@@ -730,11 +941,8 @@ bool Visualiser::init() {
         //  Get context
         this->context = SDL_GL_CreateContext(window);
 
-        // Enable VSync
-        int swapIntervalResult = SDL_GL_SetSwapInterval(VSYNC);
-        if (swapIntervalResult == -1) {
-            fprintf(stderr, "Swap Interval Failed: %s\n", SDL_GetError());
-        }
+        // Enable VSync (or as configured)
+        applySwapInterval();
 
         // @todo - why is this a macro?
         GLEW_INIT();
@@ -783,6 +991,30 @@ void Visualiser::setMSAA(bool state) {
     else
         glDisable(GL_MULTISAMPLE);
 }
+void Visualiser::applySwapInterval() {
+    appliedSwapInterval = swapInterval;
+    if (SDL_GL_SetSwapInterval(appliedSwapInterval) != 0) {
+        if (appliedSwapInterval == -1) {
+            // Adaptive vsync is not supported by all drivers
+            fprintf(stderr, "Adaptive VSync is not supported, falling back to VSync: %s\n", SDL_GetError());
+            if (SDL_GL_SetSwapInterval(1) != 0)
+                fprintf(stderr, "Swap Interval Failed: %s\n", SDL_GetError());
+        } else {
+            fprintf(stderr, "Swap Interval Failed: %s\n", SDL_GetError());
+        }
+    }
+}
+void Visualiser::setSwapInterval(const int interval) {
+    if (interval < -1 || interval > 1) {
+        THROW VisAssert("Visualiser::setSwapInterval(): Swap interval must be -1, 0 or 1, %d is not valid.\n", interval);
+    }
+    swapInterval = interval;
+    requestRedraw();
+}
+void Visualiser::setFrameRateLimit(const unsigned int fps) {
+    frameRateLimit = fps;
+    requestRedraw();
+}
 void Visualiser::resizeWindow() {
     //  Use the sdl drawable size
     {
@@ -833,9 +1065,13 @@ void Visualiser::deallocateGLObjects() {
     // Don't clear the map, as update buffer methods might still be called
     for (auto &as : agentStates) {
         as.second.entity.reset();
+        as.second.trail.reset();
     }
     this->lines_static.reset();
     this->lines_dynamic.reset();
+    staticModels.clear();
+    staticScenes.clear();
+    staticInstances.clear();
     render_buffer.reset();
     screenshot_buffer.reset();
 
@@ -847,6 +1083,7 @@ void Visualiser::deallocateGLObjects() {
 
 void Visualiser::close() {
     continueRender = false;
+    requestRedraw();
     if (this->pause_guard) {
         delete this->pause_guard;
         this->pause_guard = nullptr;
@@ -945,16 +1182,37 @@ void Visualiser::handleKeypress(SDL_Keycode keycode, int /*x*/, int /*y*/) {
     case SDLK_F8:
         this->toggleFPSStatus();
         break;
+    case SDLK_F7:
+        // Cycle vsync, adaptive vsync, off
+        this->setSwapInterval(this->swapInterval == 1 ? -1 : (this->swapInterval == -1 ? 0 : 1));
+        break;
+    case SDLK_F6: {
+        // Cycle the frame rate limit through a few common rates
+        static const unsigned int FRAME_RATE_LIMITS[] = { 0, 30, 60, 120 };
+        const unsigned int LIMIT_COUNT = sizeof(FRAME_RATE_LIMITS) / sizeof(unsigned int);
+        unsigned int i = 0;
+        while (i < LIMIT_COUNT && FRAME_RATE_LIMITS[i] <= this->frameRateLimit)
+            ++i;
+        this->setFrameRateLimit(i < LIMIT_COUNT ? FRAME_RATE_LIMITS[i] : 0);
+        break;
+    }
     case SDLK_F5:
         // Reload all shaders
         if (this->lines_static)
             this->lines_static->reload();
         if (this->lines_dynamic)
             this->lines_dynamic->reload();
-        for (auto& as : this->agentStates)
+        for (auto& as : this->agentStates) {
             as.second.entity->reload();
+            if (as.second.trail)
+                as.second.trail->reload();
+        }
         for (auto& sm : this->staticModels)
             sm->reload();
+        for (auto& ss : this->staticScenes)
+            ss->reload();
+        for (auto& si : this->staticInstances)
+            si.entity->reload();
         this->hud->reload();
         break;
     case SDLK_F1:
@@ -1059,6 +1317,7 @@ void Visualiser::setStepCount(const unsigned int &_stepCount) {
         this->previousStepTime = this->currentStepTime;
         this->lastStepCount = _stepCount;
     }
+    requestRedraw();
 }
 void Visualiser::setRandomSeed(const uint64_t _randomSeed) {
     randomSeed = _randomSeed;
@@ -1297,6 +1556,24 @@ void Visualiser::setWindowIcon() {
 void Visualiser::updateDynamicLine(const std::string& name) {
     // Store a list of dynamic line updates, as they must occur in render thread
     lines_dynamic_updates.insert(name);
+    requestRedraw();
+}
+void Visualiser::appendLineStream(const std::string &name, const float *vertices, const float *colors, const unsigned int count) {
+    const auto f = modelConfig.line_streams.find(name);
+    if (f == modelConfig.line_streams.end()) {
+        THROW SketchError("Line stream '%s' was not found.\n", name.c_str());
+    }
+    LineStreamPoints &points = line_stream_updates[name];
+    points.vertices.insert(points.vertices.end(), vertices, vertices + count * 3);
+    points.colors.insert(points.colors.end(), colors, colors + count * 4);
+    // Points beyond the stream's capacity would be overwritten on upload, so don't let the queue outgrow it
+    const size_t capacity = f->second->capacity;
+    if (points.vertices.size() > capacity * 3) {
+        const size_t excess = points.vertices.size() / 3 - capacity;
+        points.vertices.erase(points.vertices.begin(), points.vertices.begin() + excess * 3);
+        points.colors.erase(points.colors.begin(), points.colors.begin() + excess * 4);
+    }
+    requestRedraw();
 }
 
 }  // namespace visualiser
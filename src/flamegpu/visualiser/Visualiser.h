@@ -14,13 +14,16 @@
 #include <utility>
 #include <map>
 #include <set>
+#include <vector>
 #include <cstdint>
 #define GLM_FORCE_NO_CTOR_INIT
 #include <glm/glm.hpp>
 
+#include "flamegpu/visualiser/AgentTrail.h"
 #include "flamegpu/visualiser/Draw.h"
 #include "flamegpu/visualiser/Entity.h"
 #include "flamegpu/visualiser/HUD.h"
+#include "flamegpu/visualiser/StaticScene.h"
 #include "flamegpu/visualiser/ui/Text.h"
 #include "flamegpu/visualiser/ui/ImGuiPanel.h"
 #include "flamegpu/visualiser/camera/NoClipCamera.h"
@@ -28,6 +31,7 @@
 #include "flamegpu/visualiser/config/TexBufferConfig.h"
 #include "flamegpu/visualiser/config/ModelConfig.h"
 #include "flamegpu/visualiser/interface/Viewport.h"
+#include "flamegpu/visualiser/util/RateLimiter.h"
 
 namespace flamegpu {
 namespace visualiser {
@@ -38,6 +42,7 @@ class SplashScreen;
 class Text;
 
 class LightsBuffer;
+class ShaderStorageBuffer;
 
 /**
  * This is the main class of the visualisation, hosting the window and render loop
@@ -56,12 +61,33 @@ class Visualiser : public ViewportExt {
             const std::map<TexBufferConfig::Function, TexBufferConfig>& core_tex_buffers, const std::multimap<TexBufferConfig::Function, CustomTexBufferConfig>& tex_buffers);
         RenderInfo(const RenderInfo& vc) = default;
         RenderInfo& operator= (const RenderInfo & vc) = default;
+        /**
+         * Creates entity from config and shader_src
+         * Requires the GL context to be current
+         */
+        void createEntity();
         AgentStateConfig config;
         unsigned int tex_unit_offset;
         unsigned int instanceCount;
         std::map<TexBufferConfig::Function, CUDATextureBuffer<float>*> core_texture_buffers;
         std::multimap<TexBufferConfig::Function, std::pair<CustomTexBufferConfig, CUDATextureBuffer<float>*>> custom_texture_buffers;
         std::shared_ptr<Entity> entity;
+        /**
+         * Only created if config.trail_length is non-0
+         */
+        std::shared_ptr<AgentTrail> trail;
+        /**
+         * Generated shader functions, used to create entity
+         */
+        std::string shader_src;
+        /**
+         * Generated getPosition(), used to create trail
+         */
+        std::string position_src;
+        /**
+         * Set when new data is copied to the buffers, so that the trail captures it
+         */
+        bool trailOutOfDate;
         unsigned int requiredSize;  //  Ideally this needs to be threadsafe, but if we make it atomic stuff fails to build
         unsigned int dataSize;  // Number of elements we have initialised data for
     };
@@ -134,6 +160,16 @@ class Visualiser : public ViewportExt {
      * @note getDynamicLineMutex() should be locked before this is called
      */
     void updateDynamicLine(const std::string &name);
+    /**
+     * Queue points to be appended to the line_streams with the corresponding name
+     * @param name Name of the line stream
+     * @param vertices 3 floats per point
+     * @param colors 4 floats per point
+     * @param count The number of points
+     * @throws SketchError If the line stream was not found
+     * @note getDynamicLineMutex() should be locked before this is called
+     */
+    void appendLineStream(const std::string &name, const float *vertices, const float *colors, unsigned int count);
 
  private:
     void run();
@@ -142,6 +178,21 @@ class Visualiser : public ViewportExt {
      * Also handles keyboard/mouse IO
      */
     void render();
+    /**
+     * Blocks until the next frame needs to be drawn, used when idle rendering is enabled
+     * Returns when an event is queued (it is left for render() to handle), a redraw is requested or the heartbeat is due
+     */
+    void waitForRedraw();
+    /**
+     * Notifies the render loop that the scene has changed, so that it draws a frame if idle
+     * This may be called from any thread
+     */
+    void requestRedraw();
+    /**
+     * Creates the entity of any agent state which does not have one yet
+     * Must be called from the thread which holds the GL context
+     */
+    void createAgentStateEntities();
     /**
      * Renders contents of agentStates map
      */
@@ -172,6 +223,11 @@ class Visualiser : public ViewportExt {
      * @note Unless blocked by the active Scene the F10 key toggles MSAA at runtime
      */
     void setMSAA(bool state);
+    /**
+     * Applies swapInterval to the current GL context, falling back to vsync if adaptive vsync is not supported
+     * Must be called from the thread which holds the GL context
+     */
+    void applySwapInterval();
     /**
      * Provides key handling for none KEY_DOWN events of utility keys (ESC, F11, F10, F5, etc)
      * @param keycode The keypress detected
@@ -262,6 +318,17 @@ class Visualiser : public ViewportExt {
      * Sets the value to be rendered for random seed in the debug menu
      */
     void setRandomSeed(uint64_t randomSeed);
+    /**
+     * Sets the swap interval of the window, this is applied by the render thread before its next frame
+     * @param interval 1 (vsync), 0 (off) or -1 (adaptive vsync)
+     * @throws VisAssert If interval is not -1, 0 or 1
+     */
+    void setSwapInterval(int interval);
+    /**
+     * Sets the maximum number of frames to render per second
+     * @param fps The frame rate limit, 0 is treated as unlimited
+     */
+    void setFrameRateLimit(unsigned int fps);
 
  private:
     SDL_Window *window;
@@ -366,11 +433,32 @@ class Visualiser : public ViewportExt {
      * User defined static models to be rendered
      */
     std::list<std::shared_ptr<Entity>> staticModels;
+    /**
+     * Static models which have been merged, grouped by shader and material
+     */
+    std::list<std::shared_ptr<StaticScene>> staticScenes;
+    /**
+     * Static models with instances, each is drawn with a single instanced draw call
+     */
+    struct StaticInstances {
+        std::shared_ptr<Entity> entity;
+        // Transform of each instance, read by instanced_static.vert
+        std::shared_ptr<ShaderStorageBuffer> transforms;
+        unsigned int count;
+    };
+    std::list<StaticInstances> staticInstances;
     /**
      * User defined lines to be rendered
      */
     std::shared_ptr<Draw> lines_static, lines_dynamic;
     std::set<std::string> lines_dynamic_updates;
+    /**
+     * Points appended to each line stream since the last frame, these are uploaded by the render thread
+     */
+    struct LineStreamPoints {
+        std::vector<float> vertices, colors;
+    };
+    std::map<std::string, LineStreamPoints> line_stream_updates;
     std::mutex lines_dynamic_mutex;
     /**
      * Provides a simple default lighting configuration located at the camera using the old fixed function pipeline methods
@@ -407,6 +495,50 @@ class Visualiser : public ViewportExt {
 
     std::shared_ptr<FrameBuffer> render_buffer;
     std::shared_ptr<FrameBuffer> screenshot_buffer;
+
+    // Idle rendering
+    /**
+     * SDL user event pushed by requestRedraw(), to wake the render loop from waitForRedraw()
+     */
+    Uint32 redrawEventType = static_cast<Uint32>(-1);
+    /**
+     * Set by requestRedraw(), cleared at the start of each frame
+     * Whilst set, no further wake events are pushed
+     */
+    std::atomic<bool> redrawRequested{ true };
+    /**
+     * Number of frames still to be drawn following input or camera movement
+     * This allows ImGui to settle (e.g. hover states), and continuous movement to be drawn smoothly
+     */
+    unsigned int activeFrames = 0;
+    /**
+     * SDL_GetTicks() at the start of the previous frame, used to scale camera movement by frame time
+     * Reset by waitForRedraw(), so that time spent idle is not counted
+     */
+    unsigned int updateTime = 0;
+    /**
+     * The view and projection matrices of the previous frame, a change means the camera is moving
+     */
+    glm::mat4 lastViewMat = glm::mat4(0.0f), lastProjMat = glm::mat4(0.0f);
+
+    // Frame pacing
+    /**
+     * Requested swap interval, this may be set from any thread and is applied by the render thread
+     */
+    std::atomic<int> swapInterval{ 1 };
+    /**
+     * The value of swapInterval last passed to applySwapInterval()
+     * Adaptive vsync may have fallen back to vsync, SDL_GL_GetSwapInterval() returns the interval in use
+     */
+    int appliedSwapInterval = 1;
+    /**
+     * Maximum frames per second, 0 if unlimited, this may be set from any thread
+     */
+    std::atomic<unsigned int> frameRateLimit{ 0 };
+    /**
+     * Paces the render loop to frameRateLimit
+     */
+    RateLimiter frameLimiter;
 };
 
 }  // namespace visualiser
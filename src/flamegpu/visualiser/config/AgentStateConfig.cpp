@@ -6,6 +6,7 @@ namespace visualiser {
 
 AgentStateConfig::AgentStateConfig()
     : model_path(nullptr)
+    , model_pathB(nullptr)
     , model_texture(nullptr) {
     setString(&model_path, Stock::Models::ICOSPHERE.modelPath);
     model_scale[0] = -1.0f;  // Uniformly scale model to 1
@@ -13,22 +14,31 @@ AgentStateConfig::AgentStateConfig()
 AgentStateConfig::~AgentStateConfig() {
     if (model_path)
         free(const_cast<char*>(model_path));
+    if (model_pathB)
+        free(const_cast<char*>(model_pathB));
     if (model_texture)
         free(const_cast<char*>(model_texture));
 }
 AgentStateConfig::AgentStateConfig(const AgentStateConfig &other)
     : model_path(nullptr)
+    , model_pathB(nullptr)
     , model_texture(nullptr)  {
     *this = other;
 }
 AgentStateConfig &AgentStateConfig::operator=(const AgentStateConfig &other) {
     if (other.model_path)
         setString(&model_path, other.model_path);
+    if (other.model_pathB)
+        setString(&model_pathB, other.model_pathB);
     if (other.model_texture)
         setString(&model_texture, other.model_texture);
+    model_keyframes = other.model_keyframes;
     memcpy(model_scale, other.model_scale, sizeof(model_scale));
 
     color_shader_src = other.color_shader_src;
+    trail_length = other.trail_length;
+    memcpy(trail_color, other.trail_color, sizeof(trail_color));
+    trail_fade = other.trail_fade;
     tex_buffers = other.tex_buffers;
     return *this;
 }
@@ -11,6 +11,10 @@ ModelConfig::StaticModel::StaticModel()
     , scale{-1, 0, 0}
     , location{0, 0, 0}
     , rotation{1, 0, 0, 0} { }
+ModelConfig::StaticModel::Instance::Instance()
+    : location{0, 0, 0}
+    , rotation{1, 0, 0, 0}
+    , scale{1, 1, 1} { }
 ModelConfig::ModelConfig(const char* _windowTitle)
     : windowTitle(nullptr)
     , windowDimensions{1280, 720}
@@ -44,11 +48,20 @@ ModelConfig &ModelConfig::operator=(const ModelConfig &other) {
     memcpy(cameraSpeed, other.cameraSpeed, sizeof(cameraSpeed));
     memcpy(nearFarClip, other.nearFarClip, sizeof(nearFarClip));
     stepVisible = other.stepVisible;
+    stepsPerSecond = other.stepsPerSecond;
     beginPaused = other.beginPaused;
     isPython = other.isPython;
     isOrtho = other.isOrtho;
     orthoZoom = other.orthoZoom;
+    optimiseModels = other.optimiseModels;
+    packModelVertices = other.packModelVertices;
+    releaseModelGeometry = other.releaseModelGeometry;
+    idleRendering = other.idleRendering;
+    idleHeartbeat = other.idleHeartbeat;
+    swapInterval = other.swapInterval;
+    frameRateLimit = other.frameRateLimit;
     dynamic_lines = other.dynamic_lines;  // Here because they are probably empty at construction, so addLine() can't be used
+    line_streams = other.line_streams;
     // staticModels
     // lines
     // panels
@@ -0,0 +1,520 @@
+#include "flamegpu/visualiser/model/GLBFile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "flamegpu/visualiser/util/MappedFile.h"
+#include "flamegpu/visualiser/util/VisException.h"
+
+namespace flamegpu {
+namespace visualiser {
+
+namespace {
+const uint32_t GLB_MAGIC = 0x46546C67;  // "glTF"
+const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;  // "JSON"
+const uint32_t GLB_CHUNK_BIN = 0x004E4942;  // "BIN\0"
+const unsigned int GLTF_BYTE = 5120;
+const unsigned int GLTF_UNSIGNED_BYTE = 5121;
+const unsigned int GLTF_SHORT = 5122;
+const unsigned int GLTF_UNSIGNED_SHORT = 5123;
+const unsigned int GLTF_UNSIGNED_INT = 5125;
+const unsigned int GLTF_FLOAT = 5126;
+const unsigned int GLTF_TRIANGLES = 4;
+/**
+ * Maximum depth of nested JSON arrays/objects, and of the node hierarchy
+ */
+const int MAX_DEPTH = 64;
+
+/**
+ * Minimal JSON document model, sufficient for reading the glTF JSON chunk
+ */
+class Json {
+ public:
+    enum Type { Null, Bool, Number, String, Array, Object };
+    Type type = Null;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<Json> array;
+    std::vector<std::pair<std::string, Json>> object;
+    /**
+     * Returns the named member, or a null value if this is not an object or the member is not present
+     */
+    const Json &operator[](const char *key) const {
+        if (type == Object) {
+            for (const auto &m : object)
+                if (m.first == key)
+                    return m.second;
+        }
+        return null();
+    }
+    /**
+     * Returns the indexed element, or a null value if this is not an array or the index is out of bounds
+     */
+    const Json &operator[](const size_t i) const {
+        if (type == Array && i < array.size())
+            return array[i];
+        return null();
+    }
+    const Json &operator[](const int i) const { return (*this)[static_cast<size_t>(i)]; }
+    bool isNull() const { return type == Null; }
+    size_t size() const { return type == Array ? array.size() : 0; }
+    double getNumber(const double fallback) const { return type == Number ? number : fallback; }
+    /**
+     * Returns the value as a non-negative integer (e.g. an index or count), or fallback if not a number
+     */
+    int64_t getIndex(const int64_t fallback) const { return type == Number && number >= 0 ? static_cast<int64_t>(number) : fallback; }
+    bool getBool(const bool fallback) const { return type == Bool ? boolean : fallback; }
+    const std::string &getString() const { return string; }
+
+ private:
+    static const Json &null() {
+        static const Json n;
+        return n;
+    }
+};
+/**
+ * Recursive descent parser for Json
+ */
+class JsonParser {
+ public:
+    JsonParser(const char *begin, const char *_end, const std::string &_path)
+        : s(begin)
+        , end(_end)
+        , path(_path) { }
+    Json parse() {
+        Json rtn = parseValue(0);
+        skipSpace();
+        if (s != end && *s != '\0')
+            fail("trailing characters");
+        return rtn;
+    }
+
+ private:
+    const char *s;
+    const char *const end;
+    const std::string &path;
+    [[noreturn]] void fail(const char *reason) {
+        THROW ResourceError("GLBFile::GLBFile(): JSON chunk of '%s' is malformed (%s).\n", path.c_str(), reason);
+    }
+    void skipSpace() {
+        while (s < end && (*s == ' ' || *s == '\t' || *s == '\n' || *s == '\r'))
+            ++s;
+    }
+    bool consume(const char *literal) {
+        const size_t len = strlen(literal);
+        if (static_cast<size_t>(end - s) >= len && memcmp(s, literal, len) == 0) {
+            s += len;
+            return true;
+        }
+        return false;
+    }
+    Json parseValue(const int depth) {
+        if (depth > MAX_DEPTH)
+            fail("nested too deeply");
+        skipSpace();
+        if (s >= end)
+            fail("unexpected end");
+        Json rtn;
+        if (*s == '{') {
+            ++s;
+            rtn.type = Json::Object;
+            skipSpace();
+            if (s < end && *s == '}') {
+                ++s;
+                return rtn;
+            }
+            while (true) {
+                skipSpace();
+                if (s >= end || *s != '"')
+                    fail("expected member name");
+                std::string key = parseString();
+                skipSpace();
+                if (s >= end || *s != ':')
+                    fail("expected ':'");
+                ++s;
+                rtn.object.emplace_back(std::move(key), parseValue(depth + 1));
+                skipSpace();
+                if (s < end && *s == ',') {
+                    ++s;
+                } else if (s < end && *s == '}') {
+                    ++s;
+                    return rtn;
+                } else {
+                    fail("expected ',' or '}'");
+                }
+            }
+        } else if (*s == '[') {
+            ++s;
+            rtn.type = Json::Array;
+            skipSpace();
+            if (s < end && *s == ']') {
+                ++s;
+                return rtn;
+            }
+            while (true) {
+                rtn.array.push_back(parseValue(depth + 1));
+                skipSpace();
+                if (s < end && *s == ',') {
+                    ++s;
+                } else if (s < end && *s == ']') {
+                    ++s;
+                    return rtn;
+                } else {
+                    fail("expected ',' or ']'");
+                }
+            }
+        } else if (*s == '"') {
+            rtn.type = Json::String;
+            rtn.string = parseString();
+        } else if (consume("true")) {
+            rtn.type = Json::Bool;
+            rtn.boolean = true;
+        } else if (consume("false")) {
+            rtn.type = Json::Bool;
+        } else if (consume("null")) {
+        } else {
+            // from_chars() is locale independent, and does not require the chunk to be null terminated
+            rtn.type = Json::Number;
+            const auto result = std::from_chars(s, end, rtn.number);
+            if (result.ec != std::errc() || result.ptr == s)
+                fail("unexpected character");
+            s = result.ptr;
+        }
+        return rtn;
+    }
+    std::string parseString() {
+        ++s;  // Opening quote
+        std::string rtn;
+        while (s < end && *s != '"') {
+            if (*s == '\\') {
+                if (++s >= end)
+                    break;
+                switch (*s) {
+                case 'b': rtn.push_back('\b'); break;
+                case 'f': rtn.push_back('\f'); break;
+                case 'n': rtn.push_back('\n'); break;
+                case 'r': rtn.push_back('\r'); break;
+                case 't': rtn.push_back('\t'); break;
+                case 'u': {
+                    if (end - s < 5)
+                        fail("invalid escape");
+                    char hex[5] = { s[1], s[2], s[3], s[4], '\0' };
+                    const unsigned long c = strtoul(hex, nullptr, 16);  // NOLINT(runtime/int)
+                    // Encode as UTF-8, surrogate pairs are not combined as names are not expected to contain them
+                    if (c < 0x80) {
+                        rtn.push_back(static_cast<char>(c));
+                    } else if (c < 0x800) {
+                        rtn.push_back(static_cast<char>(0xC0 | (c >> 6)));
+                        rtn.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+                    } else {
+                        rtn.push_back(static_cast<char>(0xE0 | (c >> 12)));
+                        rtn.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+                        rtn.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+                    }
+                    s += 4;
+                    break;
+                }
+                default: rtn.push_back(*s); break;
+                }
+                ++s;
+            } else {
+                rtn.push_back(*s++);
+            }
+        }
+        if (s >= end)
+            fail("unterminated string");
+        ++s;  // Closing quote
+        return rtn;
+    }
+};
+/**
+ * Returns the local transform of a glTF node
+ */
+glm::mat4 nodeTransform(const Json &node) {
+    const Json &matrix = node["matrix"];
+    if (matrix.size() == 16) {
+        float m[16];
+        for (int i = 0; i < 16; ++i)
+            m[i] = static_cast<float>(matrix[i].getNumber(0));
+        return glm::make_mat4(m);  // glTF matrices are column major, as are glm's
+    }
+    glm::mat4 rtn(1.0f);
+    const Json &t = node["translation"];
+    if (t.size() == 3)
+        rtn = glm::translate(rtn, glm::vec3(t[0].getNumber(0), t[1].getNumber(0), t[2].getNumber(0)));
+    const Json &r = node["rotation"];
+    if (r.size() == 4) {
+        // glTF stores quaternions as xyzw, glm's constructor takes wxyz
+        const glm::quat q(static_cast<float>(r[3].getNumber(1)), static_cast<float>(r[0].getNumber(0)), static_cast<float>(r[1].getNumber(0)), static_cast<float>(r[2].getNumber(0)));
+        rtn *= glm::mat4_cast(q);
+    }
+    const Json &sc = node["scale"];
+    if (sc.size() == 3)
+        rtn = glm::scale(rtn, glm::vec3(sc[0].getNumber(1), sc[1].getNumber(1), sc[2].getNumber(1)));
+    return rtn;
+}
+}  // namespace
+
+unsigned int GLBFile::Accessor::componentSize() const {
+    switch (componentType) {
+    case GLTF_BYTE:
+    case GLTF_UNSIGNED_BYTE:
+        return 1;
+    case GLTF_SHORT:
+    case GLTF_UNSIGNED_SHORT:
+        return 2;
+    default:
+        return 4;
+    }
+}
+bool GLBFile::Accessor::isPackedFloat() const {
+    return componentType == GLTF_FLOAT && stride == components * sizeof(float);
+}
+float GLBFile::Accessor::get(const unsigned int i, const unsigned int k) const {
+    const char *p = data + static_cast<size_t>(i) * stride + k * componentSize();
+    switch (componentType) {
+    case GLTF_BYTE: {
+        int8_t v;
+        memcpy(&v, p, sizeof(v));
+        return normalized ? glm::max(v / 127.0f, -1.0f) : v;
+    }
+    case GLTF_UNSIGNED_BYTE: {
+        uint8_t v;
+        memcpy(&v, p, sizeof(v));
+        return normalized ? v / 255.0f : v;
+    }
+    case GLTF_SHORT: {
+        int16_t v;
+        memcpy(&v, p, sizeof(v));
+        return normalized ? glm::max(v / 32767.0f, -1.0f) : v;
+    }
+    case GLTF_UNSIGNED_SHORT: {
+        uint16_t v;
+        memcpy(&v, p, sizeof(v));
+        return normalized ? v / 65535.0f : v;
+    }
+    case GLTF_UNSIGNED_INT: {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return static_cast<float>(v);
+    }
+    default: {
+        float v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    }
+}
+unsigned int GLBFile::Accessor::getIndex(const unsigned int i) const {
+    const char *p = data + static_cast<size_t>(i) * stride;
+    switch (componentType) {
+    case GLTF_UNSIGNED_BYTE:
+        return static_cast<unsigned char>(*p);
+    case GLTF_UNSIGNED_SHORT: {
+        uint16_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    default: {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    }
+}
+
+GLBFile::GLBFile(const std::string &path)
+    : file(std::make_shared<const MappedFile>(path)) {
+    const char *base = file->data();
+    const size_t fileSize = file->size();
+    auto readU32 = [base](const size_t offset) {
+        uint32_t v;
+        memcpy(&v, base + offset, sizeof(v));
+        return v;
+    };
+    // Header
+    if (fileSize < 20 || readU32(0) != GLB_MAGIC) {
+        THROW ResourceError("GLBFile::GLBFile(): '%s' is not a binary glTF file.\n", path.c_str());
+    }
+    if (readU32(4) != 2) {
+        THROW ResourceError("GLBFile::GLBFile(): '%s' is glTF version %u, only version 2 is supported.\n", path.c_str(), readU32(4));
+    }
+    const size_t length = std::min<size_t>(readU32(8), fileSize);
+    // Chunks, the JSON chunk must come first and the BIN chunk (if present) second
+    const char *jsonBegin = nullptr, *binBegin = nullptr;
+    size_t jsonLength = 0, binLength = 0;
+    for (size_t offset = 12; offset + 8 <= length;) {
+        const size_t chunkLength = readU32(offset);
+        const uint32_t chunkType = readU32(offset + 4);
+        if (offset + 8 + chunkLength > length) {
+            THROW ResourceError("GLBFile::GLBFile(): '%s' is truncated.\n", path.c_str());
+        }
+        if (chunkType == GLB_CHUNK_JSON && !jsonBegin) {
+            jsonBegin = base + offset + 8;
+            jsonLength = chunkLength;
+        } else if (chunkType == GLB_CHUNK_BIN && !binBegin) {
+            binBegin = base + offset + 8;
+            binLength = chunkLength;
+        }
+        // Chunks are padded to 4 byte alignment
+        offset += 8 + ((chunkLength + 3) & ~static_cast<size_t>(3));
+    }
+    if (!jsonBegin) {
+        THROW ResourceError("GLBFile::GLBFile(): '%s' does not contain a JSON chunk.\n", path.c_str());
+    }
+    const Json gltf = JsonParser(jsonBegin, jsonBegin + jsonLength, path).parse();
+    // Resolve accessors to pointers within the BIN chunk
+    auto resolveAccessor = [&](const int64_t index) {
+        Accessor rtn;
+        if (index < 0)
+            return rtn;
+        const Json &accessor = gltf["accessors"][static_cast<size_t>(index)];
+        if (accessor.isNull()) {
+            THROW ResourceError("GLBFile::GLBFile(): '%s' references missing accessor %lld.\n", path.c_str(), static_cast<long long>(index));  // NOLINT(runtime/int)
+        }
+        if (!accessor["sparse"].isNull() || accessor["bufferView"].isNull()) {
+            THROW ResourceError("GLBFile::GLBFile(): '%s' uses sparse accessors, these are not supported.\n", path.c_str());
+        }
+        const Json &view = gltf["bufferViews"][static_cast<size_t>(accessor["bufferView"].getIndex(SIZE_MAX))];
+        const Json &buffer = gltf["buffers"][static_cast<size_t>(view["buffer"].getIndex(SIZE_MAX))];
+        if (view.isNull() || buffer.isNull() || !buffer["uri"].isNull() || !binBegin) {
+            THROW ResourceError("GLBFile::GLBFile(): '%s' references data outside of its binary chunk, external buffers are not supported.\n", path.c_str());
+        }
+        const std::string &type = accessor["type"].getString();
+        rtn.components = type == "SCALAR" ? 1 : type == "VEC2" ? 2 : type == "VEC3" ? 3 : type == "VEC4" ? 4 : 0;
+        rtn.componentType = static_cast<unsigned int>(accessor["componentType"].getIndex(0));
+        rtn.count = static_cast<unsigned int>(accessor["count"].getIndex(0));
+        rtn.normalized = accessor["normalized"].getBool(false);
+        if (!rtn.components || rtn.componentType < GLTF_BYTE || rtn.componentType > GLTF_FLOAT || rtn.componentType == 5124) {
+            THROW ResourceError("GLBFile::GLBFile(): '%s' accessor %lld is of an unsupported type.\n", path.c_str(), static_cast<long long>(index));  // NOLINT(runtime/int)
+        }
+        const size_t elementSize = rtn.components * rtn.componentSize();
+        rtn.stride = static_cast<unsigned int>(view["byteStride"].getIndex(0));
+        if (!rtn.stride)
+            rtn.stride = static_cast<unsigned int>(elementSize);
+        const size_t viewOffset = static_cast<size_t>(view["byteOffset"].getIndex(0));
+        const size_t viewLength = static_cast<size_t>(view["byteLength"].getIndex(0));
+        const size_t accessorOffset = static_cast<size_t>(accessor["byteOffset"].getIndex(0));
+        // Validate, so that a malformed file cannot cause reads out of bounds
+        const size_t accessorLength = rtn.count ? static_cast<size_t>(rtn.count - 1) * rtn.stride + elementSize : 0;
+        if (viewOffset + viewLength > binLength || accessorOffset + accessorLength > viewLength) {
+            THROW ResourceError("GLBFile::GLBFile(): '%s' accessor %lld exceeds its buffer.\n", path.c_str(), static_cast<long long>(index));  // NOLINT(runtime/int)
+        }
+        rtn.data = binBegin + viewOffset + accessorOffset;
+        return rtn;
+    };
+    // Materials
+    for (const Json &m : gltf["materials"].array) {
+        Material mat;
+        mat.name = m["name"].getString();
+        const Json &pbr = m["pbrMetallicRoughness"];
+        const Json &baseColor = pbr["baseColorFactor"];
+        if (baseColor.size() == 4)
+            mat.baseColor = glm::vec4(baseColor[0].getNumber(1), baseColor[1].getNumber(1), baseColor[2].getNumber(1), baseColor[3].getNumber(1));
+        mat.metallic = static_cast<float>(pbr["metallicFactor"].getNumber(1));
+        mat.roughness = static_cast<float>(pbr["roughnessFactor"].getNumber(1));
+        const Json &emissive = m["emissiveFactor"];
+        if (emissive.size() == 3)
+            mat.emissive = glm::vec3(emissive[0].getNumber(0), emissive[1].getNumber(0), emissive[2].getNumber(0));
+        mat.blend = m["alphaMode"].getString() == "BLEND";
+        materials.push_back(mat);
+    }
+    // Primitives of each mesh instanced by the node hierarchy
+    auto addMesh = [&](const int64_t meshIndex, const glm::mat4 &transform) {
+        const Json &mesh = gltf["meshes"][static_cast<size_t>(meshIndex)];
+        for (const Json &p : mesh["primitives"].array) {
+            if (p["mode"].getIndex(GLTF_TRIANGLES) != GLTF_TRIANGLES) {
+                fprintf(stderr, "GLBFile: '%s' contains a non-triangle primitive, it will be ignored.\n", path.c_str());
+                continue;
+            }
+            const Json &attributes = p["attributes"];
+            Primitive primitive;
+            primitive.position = resolveAccessor(attributes["POSITION"].getIndex(-1));
+            primitive.normal = resolveAccessor(attributes["NORMAL"].getIndex(-1));
+            primitive.texcoord = resolveAccessor(attributes["TEXCOORD_0"].getIndex(-1));
+            primitive.color = resolveAccessor(attributes["COLOR_0"].getIndex(-1));
+            primitive.indices = resolveAccessor(p["indices"].getIndex(-1));
+            primitive.material = static_cast<int>(p["material"].getIndex(-1));
+            primitive.transform = transform;
+            if (!primitive.position.data || primitive.position.components != 3) {
+                continue;
+            }
+            if (primitive.material >= static_cast<int>(materials.size()))
+                primitive.material = -1;
+            if (primitive.indices.data && primitive.indices.components != 1) {
+                THROW ResourceError("GLBFile::GLBFile(): '%s' contains a primitive with malformed indices.\n", path.c_str());
+            }
+            // Validate indices and per-vertex attribute counts up front, so that the loader need not
+            for (const Accessor *a : { &primitive.normal, &primitive.texcoord, &primitive.color }) {
+                if (a->data && a->count < primitive.position.count) {
+                    THROW ResourceError("GLBFile::GLBFile(): '%s' contains a primitive with mismatched attribute counts.\n", path.c_str());
+                }
+            }
+            for (unsigned int i = 0; i < primitive.indices.count; ++i) {
+                if (primitive.indices.getIndex(i) >= primitive.position.count) {
+                    THROW ResourceError("GLBFile::GLBFile(): '%s' contains a primitive with out of range indices.\n", path.c_str());
+                }
+            }
+            primitives.push_back(primitive);
+        }
+    };
+    const Json &nodes = gltf["nodes"];
+    std::vector<int64_t> roots;
+    const Json &scene = gltf["scenes"][static_cast<size_t>(gltf["scene"].getIndex(0))];
+    if (!scene.isNull()) {
+        for (const Json &n : scene["nodes"].array)
+            roots.push_back(n.getIndex(-1));
+    } else {
+        // No scene, so treat every node which is not a child as a root
+        std::vector<bool> isChild(nodes.size(), false);
+        for (const Json &n : nodes.array)
+            for (const Json &c : n["children"].array)
+                if (static_cast<size_t>(c.getIndex(SIZE_MAX)) < isChild.size())
+                    isChild[static_cast<size_t>(c.getIndex(0))] = true;
+        for (size_t i = 0; i < isChild.size(); ++i)
+            if (!isChild[i])
+                roots.push_back(static_cast<int64_t>(i));
+    }
+    // Depth first traversal
+    std::vector<std::pair<int64_t, std::pair<glm::mat4, int>>> stack;
+    for (auto r = roots.rbegin(); r != roots.rend(); ++r)
+        stack.push_back({ *r, { glm::mat4(1.0f), 0 } });
+    while (!stack.empty()) {
+        const int64_t index = stack.back().first;
+        const glm::mat4 parent = stack.back().second.first;
+        const int depth = stack.back().second.second;
+        stack.pop_back();
+        const Json &node = nodes[static_cast<size_t>(index)];
+        if (node.isNull() || depth > MAX_DEPTH)
+            continue;
+        const glm::mat4 transform = parent * nodeTransform(node);
+        if (node["mesh"].getIndex(-1) >= 0)
+            addMesh(node["mesh"].getIndex(-1), transform);
+        const Json &children = node["children"];
+        for (size_t c = children.size(); c > 0; --c)
+            stack.push_back({ children[c - 1].getIndex(-1), { transform, depth + 1 } });
+    }
+    if (nodes.isNull()) {
+        // A file of bare meshes
+        for (size_t m = 0; m < gltf["meshes"].size(); ++m)
+            addMesh(static_cast<int64_t>(m), glm::mat4(1.0f));
+    }
+    if (primitives.empty()) {
+        THROW ResourceError("GLBFile::GLBFile(): '%s' does not contain any triangle meshes.\n", path.c_str());
+    }
+}
+
+}  // namespace visualiser
+}  // namespace flamegpu
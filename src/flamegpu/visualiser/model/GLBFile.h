@@ -0,0 +1,113 @@
+#ifndef SRC_FLAMEGPU_VISUALISER_MODEL_GLBFILE_H_
+#define SRC_FLAMEGPU_VISUALISER_MODEL_GLBFILE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace flamegpu {
+namespace visualiser {
+
+class MappedFile;
+
+/**
+ * Reader for binary glTF 2.0 (.glb) models
+ * The file is memory mapped, accessors point directly into the mapped binary chunk
+ * Only the subset of glTF required to render static meshes is supported:
+ * indexed or non-indexed triangle primitives, with positions, normals, texcoords, vertex colors and PBR material factors
+ * Node transforms of the default scene are resolved, so each primitive is reported with the transform to apply
+ */
+class GLBFile {
+ public:
+    /**
+     * A typed view of elements within the binary chunk
+     */
+    struct Accessor {
+        /**
+         * Pointer to the first element, nullptr if the attribute is not present
+         */
+        const char *data = nullptr;
+        unsigned int count = 0;
+        /**
+         * Number of components per element (1-4)
+         */
+        unsigned int components = 0;
+        /**
+         * glTF component type, these match their GL counterparts (e.g. 5126 is GL_FLOAT)
+         */
+        unsigned int componentType = 0;
+        /**
+         * Bytes between consecutive elements
+         */
+        unsigned int stride = 0;
+        /**
+         * Integer components should be mapped to [0, 1] or [-1, 1]
+         */
+        bool normalized = false;
+        /**
+         * Returns the size of a single component in bytes
+         */
+        unsigned int componentSize() const;
+        /**
+         * Returns true if the elements are tightly packed floats, so may be copied without conversion
+         */
+        bool isPackedFloat() const;
+        /**
+         * Reads component k of element i, converted to float
+         */
+        float get(unsigned int i, unsigned int k) const;
+        /**
+         * Reads element i of an index accessor
+         */
+        unsigned int getIndex(unsigned int i) const;
+    };
+    /**
+     * A triangle list with a single material
+     */
+    struct Primitive {
+        Accessor position, normal, texcoord, color, indices;
+        /**
+         * Index into materials, -1 if the primitive uses the default material
+         */
+        int material = -1;
+        /**
+         * Model space transform of the node which instances the primitive's mesh
+         */
+        glm::mat4 transform = glm::mat4(1.0f);
+    };
+    /**
+     * Metallic-roughness material factors, textures are not supported
+     */
+    struct Material {
+        std::string name;
+        glm::vec4 baseColor = glm::vec4(1.0f);
+        float metallic = 1.0f;
+        float roughness = 1.0f;
+        glm::vec3 emissive = glm::vec3(0.0f);
+        bool blend = false;
+    };
+    /**
+     * Maps and parses the named file
+     * @param path Path to the .glb file, this is not passed via Resources::locateFile()
+     * @throws ResourceError If the file cannot be read, is malformed, or uses unsupported features
+     */
+    explicit GLBFile(const std::string &path);
+    /**
+     * Primitives of all mesh instances in the default scene
+     */
+    std::vector<Primitive> primitives;
+    std::vector<Material> materials;
+
+ private:
+    /**
+     * Keeps the mapping alive, as accessors point into it
+     */
+    std::shared_ptr<const MappedFile> file;
+};
+
+}  // namespace visualiser
+}  // namespace flamegpu
+
+#endif  // SRC_FLAMEGPU_VISUALISER_MODEL_GLBFILE_H_
@@ -0,0 +1,230 @@
+#include "flamegpu/visualiser/model/MeshOptimiser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace flamegpu {
+namespace visualiser {
+
+namespace {
+/**
+ * Simulated FIFO post-transform vertex cache
+ */
+class FifoCache {
+ public:
+    FifoCache(const unsigned int vertexCount, const unsigned int _cacheSize)
+        : stamp(vertexCount, 0)
+        , cacheSize(_cacheSize)
+        , time(_cacheSize + 1)
+        , flushTime(0) { }
+    /**
+     * Returns true if the vertex was not in the cache (and inserts it)
+     */
+    bool access(const unsigned int v) {
+        if (stamp[v] > flushTime && time - stamp[v] <= cacheSize)
+            return false;
+        stamp[v] = time++;
+        return true;
+    }
+    /**
+     * Empties the cache
+     */
+    void flush() {
+        flushTime = time;
+        time += cacheSize + 1;
+    }
+
+ private:
+    std::vector<unsigned int> stamp;
+    const unsigned int cacheSize;
+    unsigned int time;
+    unsigned int flushTime;
+};
+}  // namespace
+
+float MeshOptimiser::calculateACMR(const unsigned int *indices, const size_t indexCount, const unsigned int vertexCount, const unsigned int cacheSize) {
+    if (indexCount < 3)
+        return 0.0f;
+    FifoCache cache(vertexCount, cacheSize);
+    size_t misses = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        misses += cache.access(indices[i]);
+    }
+    return static_cast<float>(misses) / static_cast<float>(indexCount / 3);
+}
+
+void MeshOptimiser::optimiseVertexCache(unsigned int *indices, const size_t indexCount, const unsigned int vertexCount, const unsigned int cacheSize) {
+    const size_t triCount = indexCount / 3;
+    if (triCount < 2 || !vertexCount)
+        return;
+    // Build vertex-triangle adjacency
+    std::vector<unsigned int> live(vertexCount, 0);
+    for (size_t i = 0; i < triCount * 3; ++i)
+        ++live[indices[i]];
+    std::vector<size_t> adjOffset(vertexCount + 1, 0);
+    for (unsigned int v = 0; v < vertexCount; ++v)
+        adjOffset[v + 1] = adjOffset[v] + live[v];
+    std::vector<unsigned int> adj(adjOffset[vertexCount]);
+    {
+        std::vector<size_t> fill(adjOffset.begin(), adjOffset.end() - 1);
+        for (size_t t = 0; t < triCount; ++t) {
+            for (int k = 0; k < 3; ++k)
+                adj[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+        }
+    }
+    std::vector<unsigned int> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triCount, false);
+    std::vector<unsigned int> deadEnd;
+    std::vector<unsigned int> candidates;
+    std::vector<unsigned int> output;
+    output.reserve(triCount * 3);
+    unsigned int s = cacheSize + 1;
+    unsigned int cursor = 0;
+    int f = 0;
+    while (f >= 0) {
+        const unsigned int fv = static_cast<unsigned int>(f);
+        candidates.clear();
+        // Emit all remaining triangles in the fan of f
+        for (size_t a = adjOffset[fv]; a < adjOffset[fv + 1]; ++a) {
+            const unsigned int t = adj[a];
+            if (emitted[t])
+                continue;
+            for (int k = 0; k < 3; ++k) {
+                const unsigned int v = indices[t * 3 + k];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (s - cacheTime[v] > cacheSize) {
+                    cacheTime[v] = s++;
+                }
+            }
+            emitted[t] = true;
+        }
+        // Select the next fanning vertex, preferring the oldest candidate which will still be in cache after its fan is emitted
+        f = -1;
+        int bestPriority = -1;
+        for (const unsigned int v : candidates) {
+            if (live[v] > 0) {
+                int priority = 0;
+                if (s - cacheTime[v] + 2 * live[v] <= cacheSize)
+                    priority = static_cast<int>(s - cacheTime[v]);
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    f = static_cast<int>(v);
+                }
+            }
+        }
+        if (f == -1) {
+            // Dead end, try recently referenced vertices, then fall back to the next vertex in input order
+            while (!deadEnd.empty()) {
+                const unsigned int d = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[d] > 0) {
+                    f = static_cast<int>(d);
+                    break;
+                }
+            }
+            while (f == -1 && cursor < vertexCount) {
+                if (live[cursor] > 0)
+                    f = static_cast<int>(cursor);
+                ++cursor;
+            }
+        }
+    }
+    std::copy(output.begin(), output.end(), indices);
+}
+
+void MeshOptimiser::optimiseOverdraw(unsigned int *indices, const size_t indexCount, const float *positions, const unsigned int positionComponents, const unsigned int vertexCount, const float threshold) {
+    const size_t triCount = indexCount / 3;
+    if (triCount < 2 || !vertexCount)
+        return;
+    // Split into clusters, each of which retains a cold-cache ACMR within threshold of the mesh's ACMR
+    const float targetACMR = calculateACMR(indices, indexCount, vertexCount) * threshold;
+    std::vector<size_t> clusterStart;
+    {
+        FifoCache cache(vertexCount, CACHE_SIZE);
+        size_t clusterMisses = 0, clusterTris = 0;
+        for (size_t t = 0; t < triCount; ++t) {
+            if (clusterTris == 0) {
+                clusterStart.push_back(t);
+                cache.flush();
+            }
+            for (int k = 0; k < 3; ++k)
+                clusterMisses += cache.access(indices[t * 3 + k]);
+            ++clusterTris;
+            if (static_cast<float>(clusterMisses) <= targetACMR * static_cast<float>(clusterTris)) {
+                clusterMisses = 0;
+                clusterTris = 0;
+            }
+        }
+    }
+    if (clusterStart.size() < 2)
+        return;
+    clusterStart.push_back(triCount);
+    // Mesh centroid
+    double mesh[3] = { 0, 0, 0 };
+    for (unsigned int v = 0; v < vertexCount; ++v)
+        for (int k = 0; k < 3; ++k)
+            mesh[k] += positions[v * positionComponents + k];
+    for (int k = 0; k < 3; ++k)
+        mesh[k] /= vertexCount;
+    // Sort key for each cluster, how far its centroid lies outwards along its average normal
+    const size_t clusterCount = clusterStart.size() - 1;
+    std::vector<float> sortKey(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        double centroid[3] = { 0, 0, 0 }, normal[3] = { 0, 0, 0 }, area = 0;
+        for (size_t t = clusterStart[c]; t < clusterStart[c + 1]; ++t) {
+            const float *p0 = positions + indices[t * 3 + 0] * positionComponents;
+            const float *p1 = positions + indices[t * 3 + 1] * positionComponents;
+            const float *p2 = positions + indices[t * 3 + 2] * positionComponents;
+            const double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            const double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+            const double n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+            const double a = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int k = 0; k < 3; ++k) {
+                centroid[k] += (p0[k] + p1[k] + p2[k]) * (a / 3.0);
+                normal[k] += n[k];
+            }
+            area += a;
+        }
+        const double normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        double key = 0;
+        if (area > 0 && normalLength > 0) {
+            for (int k = 0; k < 3; ++k)
+                key += (centroid[k] / area - mesh[k]) * (normal[k] / normalLength);
+        }
+        sortKey[c] = static_cast<float>(key);
+    }
+    // Outward facing clusters first, these are most likely to occlude the rest of the mesh
+    std::vector<unsigned int> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sortKey](const unsigned int a, const unsigned int b) { return sortKey[a] > sortKey[b]; });
+    std::vector<unsigned int> output;
+    output.reserve(triCount * 3);
+    for (const unsigned int c : order) {
+        output.insert(output.end(), indices + clusterStart[c] * 3, indices + clusterStart[c + 1] * 3);
+    }
+    std::copy(output.begin(), output.end(), indices);
+}
+
+std::vector<unsigned int> MeshOptimiser::optimiseVertexFetch(unsigned int *indices, const size_t indexCount, const unsigned int vertexCount) {
+    std::vector<unsigned int> remap(vertexCount, ~0u);
+    unsigned int next = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        unsigned int &r = remap[indices[i]];
+        if (r == ~0u)
+            r = next++;
+        indices[i] = r;
+    }
+    for (unsigned int &r : remap) {
+        if (r == ~0u)
+            r = next++;
+    }
+    return remap;
+}
+
+}  // namespace visualiser
+}  // namespace flamegpu
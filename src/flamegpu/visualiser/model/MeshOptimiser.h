@@ -0,0 +1,65 @@
+#ifndef SRC_FLAMEGPU_VISUALISER_MODEL_MESHOPTIMISER_H_
+#define SRC_FLAMEGPU_VISUALISER_MODEL_MESHOPTIMISER_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace flamegpu {
+namespace visualiser {
+
+/**
+ * Utilities for reordering indexed triangle lists, to reduce the cost of rendering them
+ * Instanced agent models are drawn many times per frame, so per-model savings are multiplied by the population
+ * The intended order of use is optimiseVertexCache(), optimiseVertexFetch(), optimiseOverdraw()
+ * Vertex fetch reordering is performed before overdraw ordering, so that the final vertex order depends only on the
+ * topology of the mesh, this keeps keyframe pairs (which share topology but not positions) consistent
+ */
+class MeshOptimiser {
+ public:
+    /**
+     * Size of the simulated post-transform vertex cache
+     */
+    static const unsigned int CACHE_SIZE = 16;
+    /**
+     * Returns the average cache miss ratio (transformed vertices per triangle) of a triangle list, using a FIFO cache simulation
+     * 3.0 is the worst case, 0.5 is the theoretical best for a large regular mesh
+     * @param indices Triangle list indices
+     * @param indexCount Number of indices (3 per triangle)
+     * @param vertexCount Number of vertices referenced by indices
+     * @param cacheSize Number of vertices held by the simulated cache
+     */
+    static float calculateACMR(const unsigned int *indices, size_t indexCount, unsigned int vertexCount, unsigned int cacheSize = CACHE_SIZE);
+    /**
+     * Reorders triangles to improve post-transform vertex cache utilisation
+     * This implements Tipsify (Sander, Nehab & Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw", 2007)
+     * @param indices Triangle list indices, these are reordered in place
+     * @param indexCount Number of indices (3 per triangle)
+     * @param vertexCount Number of vertices referenced by indices
+     * @param cacheSize Number of vertices held by the target cache
+     */
+    static void optimiseVertexCache(unsigned int *indices, size_t indexCount, unsigned int vertexCount, unsigned int cacheSize = CACHE_SIZE);
+    /**
+     * Reorders clusters of triangles, so that those most likely to occlude the rest of the mesh are drawn first
+     * Clusters are split where the local ACMR is within threshold of the mesh's ACMR, so vertex cache efficiency is mostly retained
+     * @param indices Triangle list indices, these should have already been optimised by optimiseVertexCache(), they are reordered in place
+     * @param indexCount Number of indices (3 per triangle)
+     * @param positions Vertex positions, the first 3 components of each vertex are used
+     * @param positionComponents Number of components per vertex in positions
+     * @param vertexCount Number of vertices in positions
+     * @param threshold Maximum permitted ratio between the ACMR of the result and the input
+     */
+    static void optimiseOverdraw(unsigned int *indices, size_t indexCount, const float *positions, unsigned int positionComponents, unsigned int vertexCount, float threshold = 1.05f);
+    /**
+     * Renumbers vertices in the order they are first referenced, to improve pre-transform (memory) locality
+     * @param indices Triangle list indices, these are rewritten in place
+     * @param indexCount Number of indices (3 per triangle)
+     * @param vertexCount Number of vertices referenced by indices
+     * @return Mapping from old vertex index to new vertex index, unreferenced vertices are placed at the end
+     */
+    static std::vector<unsigned int> optimiseVertexFetch(unsigned int *indices, size_t indexCount, unsigned int vertexCount);
+};
+
+}  // namespace visualiser
+}  // namespace flamegpu
+
+#endif  // SRC_FLAMEGPU_VISUALISER_MODEL_MESHOPTIMISER_H_
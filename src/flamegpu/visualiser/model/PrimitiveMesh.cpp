@@ -0,0 +1,315 @@
+#include "flamegpu/visualiser/model/PrimitiveMesh.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flamegpu/visualiser/util/VisException.h"
+
+namespace flamegpu {
+namespace visualiser {
+
+namespace {
+const float PI = 3.14159265358979323846f;
+/**
+ * Upper bound on the segments, slices and stacks of generated shapes
+ */
+const unsigned int MAX_SEGMENTS = 1024;
+/**
+ * Upper bound on icosphere subdivisions, 7 produces 327680 faces
+ */
+const unsigned int MAX_SUBDIVISIONS = 7;
+/**
+ * Arrow proportions, the shaft runs from -1 to ARROW_HEAD_X
+ */
+const float ARROW_HEAD_X = 0.2f;
+const float ARROW_SHAFT_RADIUS = 0.25f;
+const float ARROW_HEAD_RADIUS = 0.5f;
+
+unsigned int detailOr(const unsigned int detail, const unsigned int defaultDetail, const unsigned int min, const unsigned int max) {
+    return detail == PrimitiveMesh::DEFAULT_DETAIL ? defaultDetail : std::clamp(detail, min, max);
+}
+}  // namespace
+
+const char *PrimitiveMesh::PATH_PREFIX = "primitive:";
+
+bool PrimitiveMesh::isPrimitivePath(const std::string &path) {
+    return path.compare(0, strlen(PATH_PREFIX), PATH_PREFIX) == 0;
+}
+PrimitiveMesh::PrimitiveMesh(const std::string &path) {
+    if (!isPrimitivePath(path)) {
+        THROW ResourceError("'%s' is not a primitive model path, in PrimitiveMesh::PrimitiveMesh()\n", path.c_str());
+    }
+    // Split the remainder of the path into the shape name and its details
+    std::vector<std::string> tokens;
+    size_t begin = strlen(PATH_PREFIX);
+    while (true) {
+        const size_t end = path.find(':', begin);
+        tokens.push_back(path.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+        if (end == std::string::npos)
+            break;
+        begin = end + 1;
+    }
+    static const std::pair<const char*, Shape> SHAPES[] = {
+        { "sphere", Sphere }, { "icosphere", Icosphere }, { "cube", Cube }, { "cylinder", Cylinder },
+        { "cone", Cone }, { "arrow", Arrow }, { "quad", Quad }, { "disc", Disc } };
+    const auto shape = std::find_if(std::begin(SHAPES), std::end(SHAPES), [&tokens](const std::pair<const char*, Shape> &s) {
+        return tokens[0] == s.first;
+    });
+    if (shape == std::end(SHAPES)) {
+        THROW ResourceError("Primitive model '%s' names an unknown shape, supported shapes: "
+            "sphere, icosphere, cube, cylinder, cone, arrow, quad, disc, in PrimitiveMesh::PrimitiveMesh()\n", path.c_str());
+    }
+    if (tokens.size() > 3) {
+        THROW ResourceError("Primitive model '%s' has too many details, a maximum of 2 are supported, in PrimitiveMesh::PrimitiveMesh()\n", path.c_str());
+    }
+    unsigned int details[2] = { DEFAULT_DETAIL, DEFAULT_DETAIL };
+    for (size_t i = 1; i < tokens.size(); ++i) {
+        const std::string &t = tokens[i];
+        const auto result = std::from_chars(t.data(), t.data() + t.size(), details[i - 1]);
+        if (t.empty() || result.ec != std::errc() || result.ptr != t.data() + t.size()) {
+            THROW ResourceError("Primitive model '%s' has an invalid detail '%s', in PrimitiveMesh::PrimitiveMesh()\n", path.c_str(), t.c_str());
+        }
+    }
+    generate(shape->second, details[0], details[1]);
+}
+PrimitiveMesh::PrimitiveMesh(const Shape shape, const unsigned int detailA, const unsigned int detailB) {
+    generate(shape, detailA, detailB);
+}
+void PrimitiveMesh::generate(const Shape shape, const unsigned int detailA, const unsigned int detailB) {
+    switch (shape) {
+    case Sphere:
+        generateSphere(detailOr(detailA, 32, 3, MAX_SEGMENTS), detailOr(detailB, 16, 2, MAX_SEGMENTS));
+        break;
+    case Icosphere:
+        generateIcosphere(detailOr(detailA, 1, 0, MAX_SUBDIVISIONS));
+        break;
+    case Cube:
+        generateCube();
+        break;
+    case Cylinder: {
+        const unsigned int segments = detailOr(detailA, 32, 3, MAX_SEGMENTS);
+        addLatheCap(segments, -1.0f, 0.0f, 1.0f, -1.0f);
+        addLatheBand(segments, -1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f);
+        addLatheCap(segments, 1.0f, 0.0f, 1.0f, 1.0f);
+        break;
+    }
+    case Cone: {
+        const unsigned int segments = detailOr(detailA, 32, 3, MAX_SEGMENTS);
+        addLatheCap(segments, -1.0f, 0.0f, 1.0f, -1.0f);
+        // Radius falls by 1 over a length of 2, so the surface normal is (1, 2) in (axial, radial), scaled
+        addLatheBand(segments, -1.0f, 1.0f, 1.0f, 0.0f, 0.5f, 1.0f);
+        break;
+    }
+    case Arrow: {
+        const unsigned int segments = detailOr(detailA, 16, 3, MAX_SEGMENTS);
+        addLatheCap(segments, -1.0f, 0.0f, ARROW_SHAFT_RADIUS, -1.0f);
+        addLatheBand(segments, -1.0f, ARROW_SHAFT_RADIUS, ARROW_HEAD_X, ARROW_SHAFT_RADIUS, 0.0f, 1.0f);
+        addLatheCap(segments, ARROW_HEAD_X, ARROW_SHAFT_RADIUS, ARROW_HEAD_RADIUS, -1.0f);
+        addLatheBand(segments, ARROW_HEAD_X, ARROW_HEAD_RADIUS, 1.0f, 0.0f, ARROW_HEAD_RADIUS / (1.0f - ARROW_HEAD_X), 1.0f);
+        break;
+    }
+    case Quad:
+        generateQuad();
+        break;
+    case Disc:
+        generateDisc(detailOr(detailA, 32, 3, MAX_SEGMENTS));
+        break;
+    }
+}
+unsigned int PrimitiveMesh::addVertex(const float px, const float py, const float pz, const float nx, const float ny, const float nz, const float u, const float v) {
+    const unsigned int index = vertexCount();
+    const float len = std::sqrt(nx * nx + ny * ny + nz * nz);
+    positions.insert(positions.end(), { px, py, pz });
+    normals.insert(normals.end(), { nx / len, ny / len, nz / len });
+    texcoords.insert(texcoords.end(), { u, v });
+    return index;
+}
+void PrimitiveMesh::addTriangle(const unsigned int a, const unsigned int b, const unsigned int c) {
+    indices.insert(indices.end(), { a, b, c });
+}
+/*
+Latitude/longitude sphere, each ring has a duplicate vertex at the texture seam
+Pole vertices are duplicated per slice, so that each slice's texcoords meet at the pole
+*/
+void PrimitiveMesh::generateSphere(const unsigned int slices, const unsigned int stacks) {
+    for (unsigned int i = 0; i <= stacks; ++i) {
+        const float phi = PI * i / stacks;
+        const float y = i == 0 ? 1.0f : i == stacks ? -1.0f : std::cos(phi);
+        const float r = i == 0 || i == stacks ? 0.0f : std::sin(phi);
+        for (unsigned int j = 0; j <= slices; ++j) {
+            // Pole texcoords are centred on their slice
+            const float u = (i == 0 || i == stacks) && j < slices ? (j + 0.5f) / slices : static_cast<float>(j) / slices;
+            const float theta = 2 * PI * j / slices;
+            const float x = r * std::cos(theta), z = -r * std::sin(theta);
+            addVertex(x, y, z, x, y, z, u, 1.0f - static_cast<float>(i) / stacks);
+        }
+    }
+    const unsigned int row = slices + 1;
+    for (unsigned int i = 0; i < stacks; ++i) {
+        for (unsigned int j = 0; j < slices; ++j) {
+            const unsigned int a = i * row + j, b = a + row, c = b + 1, d = a + 1;
+            // Triangles touching a pole use the pole vertex of their own slice
+            if (i != 0)
+                addTriangle(a, b, d);
+            if (i != stacks - 1)
+                addTriangle(b, c, i == 0 ? a : d);
+        }
+    }
+}
+/*
+Icosahedron with poles on the Y axis, each subdivision splits every face into 4 and projects the new vertices onto the sphere
+Vertices are shared between faces, so there is no texture mapping
+*/
+void PrimitiveMesh::generateIcosphere(const unsigned int subdivisions) {
+    const float ringY = 1.0f / std::sqrt(5.0f);
+    const float ringR = 2.0f / std::sqrt(5.0f);
+    positions = { 0.0f, 1.0f, 0.0f, 0.0f, -1.0f, 0.0f };
+    // Upper ring (vertices 2-6), then lower ring (vertices 7-11), offset by half a step
+    for (unsigned int ring = 0; ring < 2; ++ring) {
+        for (unsigned int k = 0; k < 5; ++k) {
+            const float theta = 2 * PI * (k + 0.5f * ring) / 5;
+            positions.insert(positions.end(), { ringR * std::cos(theta), ring ? -ringY : ringY, -ringR * std::sin(theta) });
+        }
+    }
+    for (unsigned int k = 0; k < 5; ++k) {
+        const unsigned int u0 = 2 + k, u1 = 2 + (k + 1) % 5;
+        const unsigned int l0 = 7 + k, l1 = 7 + (k + 1) % 5;
+        addTriangle(u0, u1, 0);
+        addTriangle(u0, l0, u1);
+        addTriangle(l0, l1, u1);
+        addTriangle(l0, 1, l1);
+    }
+    for (unsigned int s = 0; s < subdivisions; ++s) {
+        // Edges are shared by two faces, so midpoints are cached by their (ordered) end points
+        std::unordered_map<uint64_t, unsigned int> midpoints;
+        const auto midpoint = [this, &midpoints](const unsigned int a, const unsigned int b) {
+            const uint64_t key = (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+            const auto it = midpoints.find(key);
+            if (it != midpoints.end())
+                return it->second;
+            float m[3];
+            for (unsigned int k = 0; k < 3; ++k)
+                m[k] = positions[a * 3 + k] + positions[b * 3 + k];
+            const float len = std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+            const unsigned int index = vertexCount();
+            positions.insert(positions.end(), { m[0] / len, m[1] / len, m[2] / len });
+            midpoints.emplace(key, index);
+            return index;
+        };
+        std::vector<unsigned int> faces;
+        faces.swap(indices);
+        indices.reserve(faces.size() * 4);
+        for (size_t f = 0; f < faces.size(); f += 3) {
+            const unsigned int a = faces[f], b = faces[f + 1], c = faces[f + 2];
+            const unsigned int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+            addTriangle(a, ab, ca);
+            addTriangle(b, bc, ab);
+            addTriangle(c, ca, bc);
+            addTriangle(ab, bc, ca);
+        }
+    }
+    // Positions lie on the unit sphere, so are also the normals
+    normals = positions;
+}
+void PrimitiveMesh::generateCube() {
+    // Normal, then the two in-plane axes of each face, ordered such that u x v = normal
+    static const float FACES[6][3][3] = {
+        { { 1, 0, 0 }, { 0, 0, -1 }, { 0, 1, 0 } },
+        { { -1, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 } },
+        { { 0, 1, 0 }, { 1, 0, 0 }, { 0, 0, -1 } },
+        { { 0, -1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } },
+        { { 0, 0, 1 }, { 1, 0, 0 }, { 0, 1, 0 } },
+        { { 0, 0, -1 }, { -1, 0, 0 }, { 0, 1, 0 } } };
+    static const float CORNERS[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+    for (const auto &face : FACES) {
+        const float *n = face[0], *u = face[1], *v = face[2];
+        const unsigned int first = vertexCount();
+        for (const auto &c : CORNERS) {
+            addVertex(n[0] + c[0] * u[0] + c[1] * v[0], n[1] + c[0] * u[1] + c[1] * v[1], n[2] + c[0] * u[2] + c[1] * v[2],
+                n[0], n[1], n[2], 0.5f + 0.5f * c[0], 0.5f + 0.5f * c[1]);
+        }
+        addTriangle(first, first + 1, first + 2);
+        addTriangle(first, first + 2, first + 3);
+    }
+}
+void PrimitiveMesh::generateQuad() {
+    addVertex(-1, -1, 0, 0, 0, 1, 0, 0);
+    addVertex(1, -1, 0, 0, 0, 1, 1, 0);
+    addVertex(1, 1, 0, 0, 0, 1, 1, 1);
+    addVertex(-1, 1, 0, 0, 0, 1, 0, 1);
+    addTriangle(0, 1, 2);
+    addTriangle(0, 2, 3);
+}
+void PrimitiveMesh::generateDisc(const unsigned int segments) {
+    const unsigned int centre = addVertex(0, 0, 0, 0, 0, 1, 0.5f, 0.5f);
+    for (unsigned int j = 0; j < segments; ++j) {
+        const float theta = 2 * PI * j / segments;
+        const float x = std::cos(theta), y = std::sin(theta);
+        addVertex(x, y, 0, 0, 0, 1, 0.5f + 0.5f * x, 0.5f + 0.5f * y);
+    }
+    for (unsigned int j = 0; j < segments; ++j)
+        addTriangle(centre, centre + 1 + j, centre + 1 + (j + 1) % segments);
+}
+void PrimitiveMesh::addLatheBand(const unsigned int segments, const float x0, const float r0, const float x1, const float r1, const float normalX, const float normalR) {
+    const unsigned int first = vertexCount();
+    for (const unsigned int ring : { 0u, 1u }) {
+        const float x = ring ? x1 : x0;
+        const float r = ring ? r1 : r0;
+        for (unsigned int j = 0; j <= segments; ++j) {
+            // Apex vertices take the normal of the centre of their segment
+            const float theta = 2 * PI * (r == 0.0f ? j + 0.5f : static_cast<float>(j)) / segments;
+            const float c = std::cos(theta), s = std::sin(theta);
+            addVertex(x, r * c, r * s, normalX, normalR * c, normalR * s, static_cast<float>(j) / segments, 0.5f + 0.5f * x);
+        }
+    }
+    const unsigned int row = segments + 1;
+    for (unsigned int j = 0; j < segments; ++j) {
+        const unsigned int a = first + j, b = a + 1, c = b + row, d = a + row;
+        if (r0 != 0.0f)
+            addTriangle(a, b, d);
+        if (r1 != 0.0f)
+            addTriangle(b, c, d);
+    }
+}
+void PrimitiveMesh::addLatheCap(const unsigned int segments, const float x, const float rInner, const float rOuter, const float facing) {
+    const auto capVertex = [&](const float r, const float theta) {
+        const float y = r * std::cos(theta), z = r * std::sin(theta);
+        return addVertex(x, y, z, facing, 0, 0, 0.5f + 0.5f * y / rOuter, 0.5f + 0.5f * z / rOuter);
+    };
+    // Triangles are wound to face +X, then flipped if facing -X
+    const auto addCapTriangle = [this, facing](const unsigned int a, const unsigned int b, const unsigned int c) {
+        if (facing > 0)
+            addTriangle(a, b, c);
+        else
+            addTriangle(a, c, b);
+    };
+    if (rInner == 0.0f) {
+        const unsigned int centre = capVertex(0.0f, 0.0f);
+        for (unsigned int j = 0; j < segments; ++j)
+            capVertex(rOuter, 2 * PI * j / segments);
+        for (unsigned int j = 0; j < segments; ++j)
+            addCapTriangle(centre, centre + 1 + j, centre + 1 + (j + 1) % segments);
+    } else {
+        const unsigned int first = vertexCount();
+        for (unsigned int j = 0; j < segments; ++j) {
+            capVertex(rInner, 2 * PI * j / segments);
+            capVertex(rOuter, 2 * PI * j / segments);
+        }
+        for (unsigned int j = 0; j < segments; ++j) {
+            const unsigned int i0 = first + 2 * j, o0 = i0 + 1;
+            const unsigned int i1 = first + 2 * ((j + 1) % segments), o1 = i1 + 1;
+            addCapTriangle(i0, o0, o1);
+            addCapTriangle(i0, o1, i1);
+        }
+    }
+}
+
+}  // namespace visualiser
+}  // namespace flamegpu
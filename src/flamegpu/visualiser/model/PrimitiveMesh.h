@@ -0,0 +1,131 @@
+#ifndef SRC_FLAMEGPU_VISUALISER_MODEL_PRIMITIVEMESH_H_
+#define SRC_FLAMEGPU_VISUALISER_MODEL_PRIMITIVEMESH_H_
+
+#include <string>
+#include <vector>
+
+namespace flamegpu {
+namespace visualiser {
+
+/**
+ * Generator for simple shapes, which are built directly in memory rather than loaded from a model file
+ * Primitives are requested via a model path of the form "primitive:<shape>[:<detail>[:<detail>]]"
+ * e.g. "primitive:sphere:16:8", "primitive:icosphere:2", "primitive:cube"
+ * Details control tessellation, so the cheapest adequate mesh can be chosen
+ *
+ * Orientation matches the stock models:
+ *   - Sphere, icosphere and cube are centred on the origin, with poles on the Y axis
+ *   - Cylinder, cone and arrow lie along the X axis, the cone and arrow point towards +X
+ *   - Quad and disc lie in the XY plane, facing +Z
+ * All shapes span [-1, 1] on their major axes, and are drawn with counter-clockwise front faces
+ */
+class PrimitiveMesh {
+ public:
+    enum Shape {
+        /**
+         * Details: slices (around the Y axis), stacks (pole to pole), default 32:16
+         */
+        Sphere,
+        /**
+         * Details: subdivisions of an icosahedron, default 1 (42 vertices), each subdivision quadruples the face count
+         */
+        Icosphere,
+        /**
+         * No details, each face has its own vertices so faces are flat shaded
+         */
+        Cube,
+        /**
+         * Details: segments around the X axis, default 32
+         */
+        Cylinder,
+        /**
+         * Details: segments around the X axis, default 32
+         */
+        Cone,
+        /**
+         * Cylindrical shaft with a conical head
+         * Details: segments around the X axis, default 16
+         */
+        Arrow,
+        /**
+         * No details
+         */
+        Quad,
+        /**
+         * Details: segments around the Z axis, default 32
+         */
+        Disc
+    };
+    /**
+     * Model paths beginning with this prefix are generated by PrimitiveMesh
+     */
+    static const char *PATH_PREFIX;
+    /**
+     * Passed as a detail to select the shape's default tessellation
+     */
+    static const unsigned int DEFAULT_DETAIL = 0xFFFFFFFFu;
+    /**
+     * Returns true if the path names a primitive, rather than a model file
+     */
+    static bool isPrimitivePath(const std::string &path);
+    /**
+     * Parses a primitive model path, and generates the named shape
+     * @param path A path beginning with PATH_PREFIX
+     * @throws ResourceError If the shape is unknown, or a detail is not a valid number
+     */
+    explicit PrimitiveMesh(const std::string &path);
+    /**
+     * Generates the specified shape
+     * @param shape The shape to generate
+     * @param detailA First tessellation detail
+     * @param detailB Second tessellation detail
+     * @note Details are clamped to the range each shape supports
+     */
+    explicit PrimitiveMesh(Shape shape, unsigned int detailA = DEFAULT_DETAIL, unsigned int detailB = DEFAULT_DETAIL);
+    /**
+     * Number of vertices, each has a position, normal and (if texcoords is not empty) texcoord
+     */
+    unsigned int vertexCount() const { return static_cast<unsigned int>(positions.size() / 3); }
+    /**
+     * 3 components per vertex
+     */
+    std::vector<float> positions;
+    /**
+     * 3 components per vertex, unit length
+     */
+    std::vector<float> normals;
+    /**
+     * 2 components per vertex, empty if the shape has no texture mapping (icosphere)
+     */
+    std::vector<float> texcoords;
+    /**
+     * Triangle list, 3 indices per face
+     */
+    std::vector<unsigned int> indices;
+
+ private:
+    unsigned int addVertex(float px, float py, float pz, float nx, float ny, float nz, float u, float v);
+    void addTriangle(unsigned int a, unsigned int b, unsigned int c);
+    void generate(Shape shape, unsigned int detailA, unsigned int detailB);
+    void generateSphere(unsigned int slices, unsigned int stacks);
+    void generateIcosphere(unsigned int subdivisions);
+    void generateCube();
+    void generateQuad();
+    void generateDisc(unsigned int segments);
+    /**
+     * Adds a band around the X axis, between two rings
+     * Normals are given as an axial and a radial component, so that they may be set independently of the band's slope
+     * A ring of radius 0 is treated as an apex, and only emits a single triangle per segment
+     */
+    void addLatheBand(unsigned int segments, float x0, float r0, float x1, float r1, float normalX, float normalR);
+    /**
+     * Adds a flat ring (or disc if rInner is 0) facing along the X axis
+     * @param facing +1 to face +X, -1 to face -X
+     */
+    void addLatheCap(unsigned int segments, float x, float rInner, float rOuter, float facing);
+};
+
+}  // namespace visualiser
+}  // namespace flamegpu
+
+#endif  // SRC_FLAMEGPU_VISUALISER_MODEL_PRIMITIVEMESH_H_
@@ -149,7 +149,7 @@ void ShaderCore::setupBindings() {
     // Refresh buffers
     std::list<BufferDetail> t_buffers;
     t_buffers.splice(t_buffers.end(), lostBuffers);
-    for (std::map<GLuint, BufferDetail>::iterator i = buffers.begin(); i != buffers.end(); ++i) {
+    for (auto i = buffers.begin(); i != buffers.end(); ++i) {
         t_buffers.push_back(i->second);
     }
     buffers.clear();
@@ -159,9 +159,9 @@ void ShaderCore::setupBindings() {
             continue;
         GLuint uniformBlockIndex = GL_CALL(glGetProgramResourceIndex(this->programId, blockType, d.nameInShader.c_str()));
         if (uniformBlockIndex != GL_INVALID_INDEX) {
-            auto rtn = buffers.emplace(uniformBlockIndex, d);
+            auto rtn = buffers.emplace(std::make_pair(blockType, uniformBlockIndex), d);
             if (!rtn.second)fprintf(stderr, "Somehow a buffer was bound twice.");
-            GL_CALL(glUniformBlockBinding(this->programId, uniformBlockIndex, d.bindingPoint));
+            setBlockBinding(this->programId, d.type, uniformBlockIndex, d.bindingPoint);
         } else if (d.nameInShader != Shaders::LIGHT_UNIFORM_BLOCK_NAME && d.nameInShader != Shaders::MATERIAL_UNIFORM_BLOCK_NAME) {
             // If the buffer isn't found, remind the user, Don't warn for known system buffers
             lostBuffers.push_front(d);
@@ -418,6 +418,13 @@ GLenum ShaderCore::getResourceBlock(GLenum bufferType) {
     fprintf(stderr, "Buffer type was unexpected.\n");
     return GL_INVALID_ENUM;
 }
+void ShaderCore::setBlockBinding(const GLuint programId, const GLenum bufferType, const GLuint blockIndex, const GLuint bufferBindingPoint) {
+    if (bufferType == GL_SHADER_STORAGE_BUFFER) {
+        GL_CALL(glShaderStorageBlockBinding(programId, blockIndex, bufferBindingPoint));
+    } else {
+        GL_CALL(glUniformBlockBinding(programId, blockIndex, bufferBindingPoint));
+    }
+}
 bool ShaderCore::addBuffer(const char *bufferNameInShader, const GLenum bufferType, const GLuint bufferBindingPoint) {  // Each buffer must have a unique binding point
     // Purge any existing buffer which matches
     removeBuffer(bufferNameInShader);
@@ -432,9 +439,9 @@ bool ShaderCore::addBuffer(const char *bufferNameInShader, const GLenum bufferTy
             // Can't use[] assignment constructor due to const elements
             BufferDetail bd = { bufferNameInShader, bufferType, bufferBindingPoint };
             // dynamicUniforms.erase(blockIndex);  // Why?
-            auto rtn = buffers.emplace(uniformBlockIndex, bd);
+            auto rtn = buffers.emplace(std::make_pair(blockType, uniformBlockIndex), bd);
             if (!rtn.second)fprintf(stderr, "%s: Buffer named: %s is already bound.\n", shaderTag.c_str(), bufferNameInShader);
-            GL_CALL(glUniformBlockBinding(this->programId, uniformBlockIndex, bufferBindingPoint));
+            setBlockBinding(this->programId, bufferType, uniformBlockIndex, bufferBindingPoint);
             return true;
         } else if (strcmp(bufferNameInShader, Shaders::LIGHT_UNIFORM_BLOCK_NAME) && strcmp(bufferNameInShader, Shaders::MATERIAL_UNIFORM_BLOCK_NAME)) {  // Don't warn for known system buffers
             fprintf(stderr, "%s: Buffer named: %s was not found.\n", shaderTag.c_str(), bufferNameInShader);
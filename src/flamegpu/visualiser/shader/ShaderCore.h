@@ -282,6 +282,11 @@ class ShaderCore : public Reloadable {
 
  private:
     static GLenum getResourceBlock(GLenum bufferType);
+    /**
+     * Binds the indexed block of the program to a buffer binding point
+     * Uniform blocks and shader storage blocks are bound with different calls
+     */
+    static void setBlockBinding(GLuint programId, GLenum bufferType, GLuint blockIndex, GLuint bufferBindingPoint);
     /**
      * Holds shaders thats have been compiled, so that they can be deleted
      * @see deleteShaders()
@@ -409,8 +414,9 @@ class ShaderCore : public Reloadable {
     };
     /**
      * Holds additional information necessary for tracking buffers
+     * Key: Block type and block index, uniform and shader storage blocks are indexed independently
      */
-    std::map<GLuint, BufferDetail> buffers;
+    std::map<std::pair<GLenum, GLuint>, BufferDetail> buffers;
     /**
      * Holds buffers that were not found within the shader
      * or went missing after a shader reload
@@ -368,6 +368,20 @@ void Shaders::_useProgramModelMatrices(const glm::mat4 *force) {
         GL_CALL(glUniformMatrix4fv(this->modelviewprojectionMatLoc, 1, GL_FALSE, glm::value_ptr(m)));
     }
 }
+namespace {
+/**
+ * Specifies the layout of the attribute for the currently bound array buffer, selecting the glVertexAttrib*Pointer() variant appropriate to its type
+ */
+void setVertexAttribPointer(const Shaders::VertexAttributeDetail &vad) {
+    if (vad.componentType == GL_FLOAT || vad.componentType == GL_HALF_FLOAT || vad.normalized) {
+        GL_CALL(glVertexAttribPointer(vad.location, vad.components, vad.componentType, vad.normalized ? GL_TRUE : GL_FALSE, vad.stride, static_cast<char *>(nullptr) + vad.offset));
+    } else if (vad.componentType == GL_DOUBLE) {
+        GL_CALL(glVertexAttribLPointer(vad.location, vad.components, vad.componentType, vad.stride, static_cast<char *>(nullptr) + vad.offset));
+    } else {
+        GL_CALL(glVertexAttribIPointer(vad.location, vad.components, vad.componentType, vad.stride, static_cast<char *>(nullptr) + vad.offset));
+    }
+}
+}  // namespace
 void Shaders::buildVAO() {
     GL_CALL(glBindVertexArray(vao));
     GLuint activeVBO = 0;
@@ -375,13 +389,7 @@ void Shaders::buildVAO() {
     if (this->positions.location >= 0 && this->positions.vbo > 0) {  // If vertex attribute location and vbo are known
         GL_CALL(glEnableVertexAttribArray(this->positions.location));
         GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, this->positions.vbo));
-        if (this->positions.componentType == GL_FLOAT || this->positions.componentType == GL_HALF_FLOAT) {
-            GL_CALL(glVertexAttribPointer(this->positions.location, this->positions.components, this->positions.componentType, GL_FALSE, this->positions.stride, static_cast<char *>(nullptr) + this->positions.offset));
-        } else if (this->positions.componentType == GL_DOUBLE) {
-            GL_CALL(glVertexAttribLPointer(this->positions.location, this->positions.components, this->positions.componentType, this->positions.stride, static_cast<char *>(nullptr) + this->positions.offset));
-        } else {
-            GL_CALL(glVertexAttribIPointer(this->positions.location, this->positions.components, this->positions.componentType, this->positions.stride, static_cast<char *>(nullptr) + this->positions.offset));
-        }
+        setVertexAttribPointer(this->positions);
         activeVBO = this->positions.vbo;
     }
 
@@ -392,13 +400,7 @@ void Shaders::buildVAO() {
             GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, this->normals.vbo));
             activeVBO = this->normals.vbo;
         }
-        if (this->normals.componentType == GL_FLOAT || this->normals.componentType == GL_HALF_FLOAT) {
-            GL_CALL(glVertexAttribPointer(this->normals.location, this->normals.components, this->positions.componentType, GL_FALSE, this->normals.stride, static_cast<char *>(nullptr) + this->normals.offset));
-        } else if (this->normals.componentType == GL_DOUBLE) {
-            GL_CALL(glVertexAttribLPointer(this->normals.location, this->normals.components, this->positions.componentType, this->normals.stride, static_cast<char *>(nullptr) + this->normals.offset));
-        } else {
-            GL_CALL(glVertexAttribIPointer(this->normals.location, this->normals.components, this->positions.componentType, this->normals.stride, static_cast<char *>(nullptr) + this->normals.offset));
-        }
+        setVertexAttribPointer(this->normals);
     }
     // Set the vertex color attributes
     if (this->colors.location >= 0 && this->colors.vbo > 0) {  // If color attribute location and vbo are known
@@ -407,13 +409,7 @@ void Shaders::buildVAO() {
             GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, this->colors.vbo));
             activeVBO = this->colors.vbo;
         }
-        if (this->colors.componentType == GL_FLOAT || this->colors.componentType == GL_HALF_FLOAT) {
-            GL_CALL(glVertexAttribPointer(this->colors.location, this->colors.components, this->colors.componentType, GL_FALSE, this->colors.stride, static_cast<char *>(nullptr) + this->colors.offset));
-        } else if (this->colors.componentType == GL_DOUBLE) {
-            GL_CALL(glVertexAttribLPointer(this->colors.location, this->colors.components, this->colors.componentType, this->colors.stride, static_cast<char *>(nullptr) + this->colors.offset));
-        } else {
-            GL_CALL(glVertexAttribIPointer(this->colors.location, this->colors.components, this->colors.componentType, this->colors.stride, static_cast<char *>(nullptr) + this->colors.offset));
-        }
+        setVertexAttribPointer(this->colors);
     }
 
     // Set the vertex texture coord attributes
@@ -423,13 +419,7 @@ void Shaders::buildVAO() {
             GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, this->texcoords.vbo));
             activeVBO = this->texcoords.vbo;
         }
-        if (this->texcoords.componentType == GL_FLOAT || this->texcoords.componentType == GL_HALF_FLOAT) {
-            GL_CALL(glVertexAttribPointer(this->texcoords.location, this->texcoords.components, this->texcoords.componentType, GL_FALSE, this->texcoords.stride, static_cast<char *>(nullptr) + this->texcoords.offset));
-        } else if (this->texcoords.componentType == GL_DOUBLE) {
-            GL_CALL(glVertexAttribLPointer(this->texcoords.location, this->texcoords.components, this->texcoords.componentType, this->texcoords.stride, static_cast<char *>(nullptr) + this->texcoords.offset));
-        } else {
-            GL_CALL(glVertexAttribIPointer(this->texcoords.location, this->texcoords.components, this->texcoords.componentType, this->texcoords.stride, static_cast<char *>(nullptr) + this->texcoords.offset));
-        }
+        setVertexAttribPointer(this->texcoords);
     }
 
     // Generics
@@ -441,13 +431,7 @@ void Shaders::buildVAO() {
                 GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, a.vbo));
                 activeVBO = a.vbo;
             }
-            if (a.componentType == GL_FLOAT || a.componentType == GL_HALF_FLOAT) {
-                GL_CALL(glVertexAttribPointer(a.location, a.components, a.componentType, GL_FALSE, a.stride, static_cast<char *>(nullptr) + a.offset));
-            } else if (a.componentType == GL_DOUBLE) {
-                GL_CALL(glVertexAttribLPointer(a.location, a.components, a.componentType, a.stride, static_cast<char *>(nullptr) + a.offset));
-            } else {
-                GL_CALL(glVertexAttribIPointer(a.location, a.components, a.componentType, a.stride, static_cast<char *>(nullptr) + a.offset));
-            }
+            setVertexAttribPointer(a);
         }
     }
     // Face vbo
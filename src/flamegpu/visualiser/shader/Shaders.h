@@ -33,6 +33,7 @@ const ShaderSet FLAT{ "resources/default.vert", "resources/material_flat.frag",
 const ShaderSet PHONG{ "resources/default.vert", "resources/material_phong.frag", "" };
 const ShaderSet COLOR{ "resources/color.vert", "resources/color.frag", "" };
 const ShaderSet COLOR_NOSHADE{ "resources/color.vert", "resources/color_noshade.frag", "" };
+const ShaderSet LINE{ "resources/line.vert", "resources/line.frag", "resources/line.geom" };
 const ShaderSet SKYBOX{ "resources/skybox.vert", "skybox.frag", "" };
 const ShaderSet INSTANCED_FLAT{ "resources/instanced_flat.vert", "resources/material_flat.frag", "" };
 const ShaderSet INSTANCED_PHONG{ "resources/instanced_default.vert", "resources/material_phong.frag", "" };
@@ -112,11 +113,13 @@ class Shaders : public ShaderCore {
             , vbo(0)
             , location(-1)
             , offset(0)
-            , stride(0) {}
+            , stride(0)
+            , normalized(false) {}
         /**
          * Underlying component type expressed as GLenum
          * e.g. Most cases will be float4/glm::vec4 which are GL_FLOAT
          * Options: GL_HALF_FLOAT, GL_FLOAT, GL_DOUBLE, GL_BYTE, GL_UNSIGNED_BYTE, GL_SHORT, GL_UNSIGNED_SHORT, GL_INT, and GL_UNSIGNED_INT
+         * The packed types GL_INT_2_10_10_10_REV and GL_UNSIGNED_INT_2_10_10_10_REV are also supported, these require 4 components and normalized
          */
         GLenum componentType;
         /**
@@ -154,6 +157,19 @@ class Shaders : public ShaderCore {
          * @note This is value is 0 unless the data is interleaved
          */
         unsigned int stride;
+        /**
+         * If true, integer components are mapped to the range [-1, 1] (signed) or [0, 1] (unsigned) and passed to float shader inputs
+         * Otherwise integer components are passed to integer shader inputs unchanged
+         */
+        bool normalized;
+        /**
+         * Returns the size of a single element of the array in bytes
+         */
+        unsigned int elementSize() const {
+            if (componentType == GL_INT_2_10_10_10_REV || componentType == GL_UNSIGNED_INT_2_10_10_10_REV)
+                return 4;
+            return components * componentSize;
+        }
     };
     /**
      * Constructs a shader object from one of the stock shader sets
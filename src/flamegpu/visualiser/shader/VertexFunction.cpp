@@ -7,8 +7,9 @@
 namespace flamegpu {
 namespace visualiser {
 
-VertexFunction::VertexFunction(const std::map<TexBufferConfig::Function, TexBufferConfig> &tex_buffers, const char *modelpathB)
-    : has_animation_lerp(tex_buffers.find(TexBufferConfig::AnimationLerp) != tex_buffers.end() && modelpathB)
+VertexFunction::VertexFunction(const std::map<TexBufferConfig::Function, TexBufferConfig> &tex_buffers, const char *modelpathB, const size_t keyframeCount)
+    : has_animation_frame(tex_buffers.find(TexBufferConfig::AnimationFrame) != tex_buffers.end() && keyframeCount >= 2)
+    , has_animation_lerp(tex_buffers.find(TexBufferConfig::AnimationLerp) != tex_buffers.end() && modelpathB && !has_animation_frame)
 { }
 
 std::string VertexFunction::getSrc() const {
@@ -20,11 +21,34 @@ std::string VertexFunction::getSrc() const {
         ss << "in vec3 _normal2;" << "\n";
         ss << "uniform samplerBuffer _animation_lerp;" << "\n";
     }
+    if (has_animation_frame) {
+        // Keyframe vertices are stored frame by frame, normals are packed as snorm 10:10:10:2
+        ss << "struct _KeyframeVertex { vec3 position; uint normal; };" << "\n";
+        ss << "layout(std430) readonly buffer _keyframes { _KeyframeVertex _keyframe_vertices[]; };" << "\n";
+        ss << "uniform uint _keyframe_count;" << "\n";
+        ss << "uniform uint _keyframe_vertex_count;" << "\n";
+        ss << "uniform samplerBuffer _animation_frame;" << "\n";
+        ss << "vec3 _unpackKeyframeNormal(uint p) {" << "\n";
+        ss << "    return max(vec3(ivec3(uvec3(p << 22, p << 12, p << 2)) >> 22) / 511.0f, vec3(-1.0f));" << "\n";
+        ss << "}" << "\n";
+        ss << "void _getKeyframes(out uint a, out uint b, out float lerp) {" << "\n";
+        ss << "    const float f = mod(texelFetch(_animation_frame, gl_InstanceID).x, float(_keyframe_count));" << "\n";
+        ss << "    const uint frame = min(uint(f), _keyframe_count - 1);" << "\n";
+        ss << "    a = frame * _keyframe_vertex_count + uint(gl_VertexID);" << "\n";
+        ss << "    b = ((frame + 1) % _keyframe_count) * _keyframe_vertex_count + uint(gl_VertexID);" << "\n";
+        ss << "    lerp = f - float(frame);" << "\n";
+        ss << "}" << "\n";
+    }
     // Begin vertex function
     ss << "vec3 getVertex() {" << "\n";
     if (has_animation_lerp) {
         ss << "    const float lerp = texelFetch(_animation_lerp, gl_InstanceID).x;" << "\n";
         ss << "    return mix(_vertex, _vertex2, lerp);" << "\n";
+    } else if (has_animation_frame) {
+        ss << "    uint a, b;" << "\n";
+        ss << "    float lerp;" << "\n";
+        ss << "    _getKeyframes(a, b, lerp);" << "\n";
+        ss << "    return mix(_keyframe_vertices[a].position, _keyframe_vertices[b].position, lerp);" << "\n";
     } else {
         ss << "    return _vertex;" << "\n";
     }
@@ -34,6 +58,11 @@ std::string VertexFunction::getSrc() const {
     if (has_animation_lerp) {
         ss << "    const float lerp = texelFetch(_animation_lerp, gl_InstanceID).x;" << "\n";
         ss << "    return mix(normalize(_normal), normalize(_normal2), lerp);" << "  // assumes the caller will normalize the return\n";
+    } else if (has_animation_frame) {
+        ss << "    uint a, b;" << "\n";
+        ss << "    float lerp;" << "\n";
+        ss << "    _getKeyframes(a, b, lerp);" << "\n";
+        ss << "    return mix(_unpackKeyframeNormal(_keyframe_vertices[a].normal), _unpackKeyframeNormal(_keyframe_vertices[b].normal), lerp);" << "  // assumes the caller will normalize the return\n";
     } else {
         ss << "    return _normal;" << "\n";
     }
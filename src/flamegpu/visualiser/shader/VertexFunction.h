@@ -17,13 +17,19 @@ namespace visualiser {
  */
 class VertexFunction {
  public:
-    explicit VertexFunction(const std::map<TexBufferConfig::Function, TexBufferConfig> &tex_buffers, const char *modelpathB);
+    /**
+     * @param tex_buffers The texture buffers provided for the agent
+     * @param modelpathB Path to the second keyframe of a 2-frame animated model, else nullptr
+     * @param keyframeCount Number of keyframes of an N-frame animated model, these take precedence over modelpathB
+     */
+    VertexFunction(const std::map<TexBufferConfig::Function, TexBufferConfig> &tex_buffers, const char *modelpathB, size_t keyframeCount = 0);
     /**
      * Returns the glsl function vec3 getVertex()
      */
     std::string getSrc() const;
 
  private:
+    bool has_animation_frame;
     bool has_animation_lerp;
 };
 
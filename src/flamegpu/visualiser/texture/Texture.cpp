@@ -7,6 +7,7 @@
 #include <cstdio>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "flamegpu/visualiser/util/StringUtils.h"
@@ -65,6 +66,12 @@ namespace {
                 return "No function sets this yet, but it is possible(not probable) it may be used in the future.";
         }
     }
+    /**
+     * DevIL holds global state (the bound image), so all calls into it are serialised
+     * This allows images to be decoded by asset loading worker threads
+     * Recursive, as loadImage() calls registerSurface()
+     */
+    std::recursive_mutex devilMutex;
 }  // namespace
 
 
@@ -314,6 +321,7 @@ std::shared_ptr<SDL_Surface> Texture::findLoadImage(const std::string &imagePath
     return image;
 }
 std::shared_ptr<SDL_Surface> Texture::loadImage(const std::string &imagePath, bool flipVertical, bool silenceErrors) {
+    std::lock_guard<std::recursive_mutex> lock(devilMutex);
     if (!IL_IS_INIT) {
         // Not documented whether it is safe to keep calling ilInit()
         // Is documented that calling ilShutdown() is unnecessary
@@ -394,6 +402,7 @@ std::shared_ptr<SDL_Surface> Texture::loadImage(const std::string &imagePath, bo
     return image;
 }
 unsigned int Texture::saveImage(void* data, unsigned int width, unsigned int height, const std::string& filepath) {
+    std::lock_guard<std::recursive_mutex> lock(devilMutex);
     if (!IL_IS_INIT) {
         // Not documented whether it is safe to keep calling ilInit()
         // Is documented that calling ilShutdown() is unnecessary
@@ -420,9 +429,11 @@ unsigned int Texture::saveImage(void* data, unsigned int width, unsigned int hei
     return save_success;
 }
 void Texture::registerSurface(const std::shared_ptr<SDL_Surface>& sdl_image, unsigned int devil_image) {
+    std::lock_guard<std::recursive_mutex> lock(devilMutex);
     registered_surfaces.emplace(sdl_image.get(), devil_image);
 }
 void Texture::freeSurface(SDL_Surface *sdl_image) {
+    std::lock_guard<std::recursive_mutex> lock(devilMutex);
     auto it = registered_surfaces.find(sdl_image);
     if (it != registered_surfaces.end()) {
         ilDeleteImage(it->second);
@@ -11,12 +11,15 @@
 
 #include "flamegpu/visualiser/util/Resources.h"
 #include "flamegpu/visualiser/util/StringUtils.h"
+#include "flamegpu/visualiser/util/ThreadPool.h"
 
 namespace flamegpu {
 namespace visualiser {
 
 const char *Texture2D::RAW_TEXTURE_FLAG = "Texture2D";
 std::unordered_map<std::string, std::weak_ptr<const Texture2D>> Texture2D::cache;
+std::unordered_map<std::string, std::shared_future<std::shared_ptr<SDL_Surface>>> Texture2D::preloaded;
+std::mutex Texture2D::preloadedMutex;
 
 /**
 * Constructors
@@ -100,7 +103,19 @@ std::shared_ptr<const Texture2D> Texture2D::load(const std::string &filePath, co
         }
         // Load using loader
         if (!rtn) {
-            auto image = loadImage(filePath, false);
+            std::shared_ptr<SDL_Surface> image;
+            {
+                std::unique_lock<std::mutex> lock(preloadedMutex);
+                auto it = preloaded.find(filePath);
+                if (it != preloaded.end()) {
+                    auto future = it->second;
+                    preloaded.erase(it);
+                    lock.unlock();
+                    image = future.get();  // Rethrows any exception from the worker
+                }
+            }
+            if (!image)
+                image = loadImage(filePath, false);
             if (image) {
                 rtn = std::shared_ptr<const Texture2D>(new Texture2D(image, filePath, options),
                  [&](Texture2D *ptr) {  // Custom deleter, which purges cache of item
@@ -115,6 +130,20 @@ std::shared_ptr<const Texture2D> Texture2D::load(const std::string &filePath, co
     }
     return rtn;
 }
+void Texture2D::preload(const std::string &filePath) {
+    if (filePath.empty() || isCached(filePath))
+        return;
+    std::lock_guard<std::mutex> lock(preloadedMutex);
+    if (preloaded.find(filePath) == preloaded.end()) {
+        preloaded.emplace(filePath, ThreadPool::get().submit([filePath]() {
+            return loadImage(filePath, false);
+        }).share());
+    }
+}
+void Texture2D::clearPreloaded() {
+    std::lock_guard<std::mutex> lock(preloadedMutex);
+    preloaded.clear();
+}
 bool Texture2D::isCached(const std::string &filePath) {
     auto a = cache.find(filePath);
     if (a != cache.end()) {
@@ -1,7 +1,9 @@
 #ifndef SRC_FLAMEGPU_VISUALISER_TEXTURE_TEXTURE2D_H_
 #define SRC_FLAMEGPU_VISUALISER_TEXTURE_TEXTURE2D_H_
 
+#include <future>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <locale>
 #include <string>
@@ -48,6 +50,17 @@ class Texture2D : public Texture, public RenderTarget {
      * @param options Bitmask of filtering/wrapping opetions
      */
     static std::shared_ptr<Texture2D> make(const glm::uvec2 &dimensions, const Texture::Format &format, const uint64_t &options);
+    /**
+     * Begins decoding the specified image file on the asset loading thread pool
+     * A subsequent call to load() with the same path will consume the decoded image, rather than loading it again
+     * @param filePath The path to the image to be loaded
+     * @note This does not require a GL context, so may be called before the context is available
+     */
+    static void preload(const std::string &filePath);
+    /**
+     * Releases any preloaded images which have not been consumed by load()
+     */
+    static void clearPreloaded();
     /**
      * @param filePath The texture to check
      * @return True if the specified texture has currently been loaded and is cached
@@ -147,6 +160,11 @@ class Texture2D : public Texture, public RenderTarget {
     * Cache for storing textures loaded from file
     */
     static std::unordered_map<std::string, std::weak_ptr<const Texture2D>> cache;
+    /**
+     * Images which have been, or are being, decoded by preload()
+     */
+    static std::unordered_map<std::string, std::shared_future<std::shared_ptr<SDL_Surface>>> preloaded;
+    static std::mutex preloadedMutex;
     /**
      * Dimensions of a face of the currently allocated texture
      */
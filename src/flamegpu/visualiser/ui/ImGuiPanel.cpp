@@ -97,6 +97,20 @@ void ImGuiPanel::drawDebugPanel() const {
         ImGui::Text("Orthographic Zoom Mod: %.3f", vis.modelConfig.orthoZoom);
     }
     ImGui::Text("MSAA: %s", (vis.msaaState ? "On" : "Off"));
+    const int swapInterval = SDL_GL_GetSwapInterval();
+    ImGui::Text("VSync: %s", swapInterval == -1 ? "Adaptive" : (swapInterval ? "On" : "Off"));
+    if (vis.frameRateLimit) {
+        ImGui::Text("Frame Rate Limit: %u fps", vis.frameRateLimit.load());
+    } else {
+        ImGui::Text("Frame Rate Limit: Off");
+    }
+    const Entity::GeometryMemory geometry = Entity::getGeometryMemory();
+    ImGui::Text("Model Geometry: %.2f MB GPU, %.2f MB Host (%.2f MB Released)",
+        geometry.device / 1048576.0, geometry.host / 1048576.0, geometry.released / 1048576.0);
+    const Entity::OptimisationStats optimisation = Entity::getOptimisationStats();
+    if (optimisation.models) {
+        ImGui::Text("Models Optimised: %u, Mean ACMR %.3f -> %.3f", optimisation.models, optimisation.acmrBefore, optimisation.acmrAfter);
+    }
     switch (vis.fpsStatus) {
         case 2:
             ImGui::Text("Display FPS: Show All");
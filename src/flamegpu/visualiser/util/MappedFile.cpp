@@ -0,0 +1,91 @@
+#include "flamegpu/visualiser/util/MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "flamegpu/visualiser/util/VisException.h"
+
+namespace flamegpu {
+namespace visualiser {
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string &path)
+    : begin(nullptr)
+    , length(0)
+    , fileHandle(INVALID_HANDLE_VALUE)
+    , mappingHandle(nullptr) {
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        THROW ResourceError("MappedFile::MappedFile(): Could not open file '%s'!\n", path.c_str());
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        CloseHandle(fileHandle);
+        THROW ResourceError("MappedFile::MappedFile(): Could not read size of file '%s'!\n", path.c_str());
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+    // Zero length files cannot be mapped
+    if (!length)
+        return;
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle) {
+        begin = static_cast<const char *>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!begin) {
+        if (mappingHandle)
+            CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        THROW ResourceError("MappedFile::MappedFile(): Could not map file '%s'!\n", path.c_str());
+    }
+}
+MappedFile::~MappedFile() {
+    if (begin)
+        UnmapViewOfFile(begin);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(fileHandle);
+}
+#else
+MappedFile::MappedFile(const std::string &path)
+    : begin(nullptr)
+    , length(0) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        THROW ResourceError("MappedFile::MappedFile(): Could not open file '%s'!\n", path.c_str());
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        THROW ResourceError("MappedFile::MappedFile(): Could not read size of file '%s'!\n", path.c_str());
+    }
+    length = static_cast<size_t>(st.st_size);
+    // Zero length files cannot be mapped
+    if (length) {
+        void *ptr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) {
+            close(fd);
+            THROW ResourceError("MappedFile::MappedFile(): Could not map file '%s'!\n", path.c_str());
+        }
+        // The file is read front to back, so ask for aggressive read-ahead
+        madvise(ptr, length, MADV_SEQUENTIAL);
+        begin = static_cast<const char *>(ptr);
+    }
+    // The mapping remains valid after the descriptor is closed
+    close(fd);
+}
+MappedFile::~MappedFile() {
+    if (begin)
+        munmap(const_cast<char *>(begin), length);
+}
+#endif
+
+}  // namespace visualiser
+}  // namespace flamegpu
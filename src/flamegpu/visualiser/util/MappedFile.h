@@ -0,0 +1,46 @@
+#ifndef SRC_FLAMEGPU_VISUALISER_UTIL_MAPPEDFILE_H_
+#define SRC_FLAMEGPU_VISUALISER_UTIL_MAPPEDFILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace flamegpu {
+namespace visualiser {
+
+/**
+ * Read-only memory mapping of a whole file
+ * The mapping is released when the object is destroyed
+ */
+class MappedFile {
+ public:
+    /**
+     * Maps the named file into memory
+     * @param path Path to the file, this is not passed via Resources::locateFile()
+     * @throws ResourceError If the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    /**
+     * Pointer to the first byte of the file, nullptr if the file is empty
+     */
+    const char *data() const { return begin; }
+    /**
+     * Length of the file in bytes
+     */
+    size_t size() const { return length; }
+
+ private:
+    const char *begin;
+    size_t length;
+#ifdef _WIN32
+    void *fileHandle;
+    void *mappingHandle;
+#endif
+};
+
+}  // namespace visualiser
+}  // namespace flamegpu
+
+#endif  // SRC_FLAMEGPU_VISUALISER_UTIL_MAPPEDFILE_H_
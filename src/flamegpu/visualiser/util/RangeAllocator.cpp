@@ -0,0 +1,108 @@
+#include "flamegpu/visualiser/util/RangeAllocator.h"
+
+#include <iterator>
+#include <utility>
+
+#include "flamegpu/visualiser/util/VisException.h"
+
+namespace flamegpu {
+namespace visualiser {
+
+RangeAllocator::RangeAllocator(const unsigned int _length)
+    : length(0)
+    , freeCount(0) {
+    grow(_length);
+}
+unsigned int RangeAllocator::allocate(const unsigned int count) {
+    if (!count)
+        return 0;
+    // Smallest free range which is large enough, ties are broken by lowest offset
+    auto it = bySize.lower_bound({ count, 0 });
+    if (it == bySize.end())
+        return INVALID;
+    const unsigned int offset = it->second;
+    const unsigned int available = it->first;
+    const auto range = byOffset.find(offset);
+    // The remainder stays on the free list
+    if (available > count)
+        updateFree(range, offset + count, available - count);
+    else
+        eraseFree(range);
+    return offset;
+}
+void RangeAllocator::release(unsigned int offset, unsigned int count) {
+    if (!count)
+        return;
+    if (offset > length || count > length - offset) {
+        THROW VisAssert("RangeAllocator::release(): Range [%u, %u) exceeds the length %u.\n", offset, offset + count, length);
+    }
+    // Validate against both neighbours before modifying anything, so that a failed release leaves the allocator unchanged
+    auto next = byOffset.lower_bound(offset);
+    const bool hasPrev = next != byOffset.begin();
+    auto prev = hasPrev ? std::prev(next) : byOffset.end();
+    if ((next != byOffset.end() && next->first < offset + count) || (hasPrev && prev->first + prev->second > offset)) {
+        THROW VisAssert("RangeAllocator::release(): Range [%u, %u) overlaps a free range.\n", offset, offset + count);
+    }
+    // Coalesce with the free neighbours, extending an existing range where possible rather than inserting a new one
+    const bool mergeNext = next != byOffset.end() && next->first == offset + count;
+    const bool mergePrev = hasPrev && prev->first + prev->second == offset;
+    if (mergePrev) {
+        count += prev->second;
+        if (mergeNext) {
+            count += next->second;
+            eraseFree(next);
+        }
+        updateFree(prev, prev->first, count);
+    } else if (mergeNext) {
+        updateFree(next, offset, count + next->second);
+    } else {
+        insertFree(offset, count);
+    }
+}
+void RangeAllocator::grow(const unsigned int newLength) {
+    if (newLength < length) {
+        THROW VisAssert("RangeAllocator::grow(): New length (%u) must not be less than the current length (%u).\n", newLength, length);
+    }
+    const unsigned int oldLength = length;
+    length = newLength;
+    release(oldLength, newLength - oldLength);
+}
+void RangeAllocator::reset(const unsigned int _length, const unsigned int used) {
+    if (used > _length) {
+        THROW VisAssert("RangeAllocator::reset(): Used elements (%u) exceed the length (%u).\n", used, _length);
+    }
+    byOffset.clear();
+    bySize.clear();
+    freeCount = 0;
+    length = _length;
+    release(used, _length - used);
+}
+void RangeAllocator::insertFree(const unsigned int offset, const unsigned int count) {
+    byOffset.emplace(offset, count);
+    bySize.emplace(count, offset);
+    freeCount += count;
+}
+void RangeAllocator::updateFree(const std::map<unsigned int, unsigned int>::iterator it, const unsigned int offset, const unsigned int count) {
+    // Nodes are extracted and reinserted, rather than erased and reallocated
+    auto sizeNode = bySize.extract({ it->second, it->first });
+    sizeNode.value() = { count, offset };
+    bySize.insert(std::move(sizeNode));
+    freeCount = freeCount - it->second + count;
+    if (offset == it->first) {
+        it->second = count;
+    } else {
+        const auto hint = std::next(it);
+        auto offsetNode = byOffset.extract(it);
+        offsetNode.key() = offset;
+        offsetNode.mapped() = count;
+        byOffset.insert(hint, std::move(offsetNode));
+    }
+}
+void RangeAllocator::eraseFree(const std::map<unsigned int, unsigned int>::iterator it) {
+    bySize.erase({ it->second, it->first });
+    freeCount -= it->second;
+    byOffset.erase(it);
+}
+
+}  // namespace visualiser
+}  // namespace flamegpu
@@ -0,0 +1,92 @@
+#ifndef SRC_FLAMEGPU_VISUALISER_UTIL_RANGEALLOCATOR_H_
+#define SRC_FLAMEGPU_VISUALISER_UTIL_RANGEALLOCATOR_H_
+
+#include <climits>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace flamegpu {
+namespace visualiser {
+
+/**
+ * Allocator of contiguous ranges of elements within a buffer of fixed length, it does not own any storage itself
+ * Free ranges are indexed by size, so allocation takes the best (smallest sufficient) fit in O(log n)
+ * Released ranges are coalesced with their free neighbours, so fragmentation does not accumulate
+ */
+class RangeAllocator {
+ public:
+    /**
+     * Returned by allocate() if no free range is large enough
+     */
+    static const unsigned int INVALID = UINT_MAX;
+    /**
+     * @param length The number of elements managed, initially all free
+     */
+    explicit RangeAllocator(unsigned int length = 0);
+    /**
+     * Allocates a contiguous range
+     * @param count The number of elements required
+     * @return The offset of the range, or INVALID if no free range is large enough
+     * @note Allocations of 0 elements always succeed, and return 0
+     */
+    unsigned int allocate(unsigned int count);
+    /**
+     * Releases a range previously returned by allocate()
+     * @param offset The offset of the range
+     * @param count The number of elements in the range
+     * @throws VisAssert If the range is out of bounds, or overlaps a free range
+     */
+    void release(unsigned int offset, unsigned int count);
+    /**
+     * Extends the number of elements managed, the additional elements are free
+     * @param newLength The new number of elements, must not be less than the current length
+     */
+    void grow(unsigned int newLength);
+    /**
+     * Discards all ranges, such that [0, used) is allocated and [used, length) is free
+     * This is used after the buffer has been compacted
+     */
+    void reset(unsigned int length, unsigned int used);
+    /**
+     * @return The number of elements managed
+     */
+    unsigned int getLength() const { return length; }
+    /**
+     * @return The total number of free elements
+     */
+    unsigned int getFreeCount() const { return freeCount; }
+    /**
+     * @return The size of the largest free range
+     */
+    unsigned int getLargestFree() const { return bySize.empty() ? 0 : bySize.rbegin()->first; }
+    /**
+     * @return The number of distinct free ranges
+     */
+    size_t getFreeRangeCount() const { return byOffset.size(); }
+
+ private:
+    void insertFree(unsigned int offset, unsigned int count);
+    /**
+     * Moves and/or resizes an existing free range, reusing its nodes
+     * The range must not move past another free range, so its position in byOffset is unchanged
+     */
+    void updateFree(std::map<unsigned int, unsigned int>::iterator it, unsigned int offset, unsigned int count);
+    void eraseFree(std::map<unsigned int, unsigned int>::iterator it);
+    unsigned int length;
+    unsigned int freeCount;
+    /**
+     * Free ranges {offset: count}, used to find neighbours when coalescing
+     */
+    std::map<unsigned int, unsigned int> byOffset;
+    /**
+     * Free ranges {count, offset}, ordered by size, used to find the best fit
+     */
+    std::set<std::pair<unsigned int, unsigned int>> bySize;
+};
+
+}  // namespace visualiser
+}  // namespace flamegpu
+
+#endif  // SRC_FLAMEGPU_VISUALISER_UTIL_RANGEALLOCATOR_H_
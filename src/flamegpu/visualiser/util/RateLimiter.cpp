@@ -0,0 +1,45 @@
+#include "flamegpu/visualiser/util/RateLimiter.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace flamegpu {
+namespace visualiser {
+
+const RateLimiter::clock::duration RateLimiter::SPIN_THRESHOLD = std::chrono::milliseconds(2);
+const RateLimiter::clock::duration RateLimiter::MAX_LAG = std::chrono::milliseconds(20);
+
+RateLimiter::RateLimiter(const double _rate)
+    : rate(0)
+    , period(clock::duration::zero()) {
+    setRate(_rate);
+}
+void RateLimiter::setRate(const double _rate) {
+    rate = _rate > 0 ? _rate : 0;
+    period = rate > 0 ? std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / rate)) : clock::duration::zero();
+    next = clock::time_point();
+}
+RateLimiter::clock::time_point RateLimiter::wait() {
+    clock::time_point now = clock::now();
+    if (period == clock::duration::zero())
+        return now;
+    if (next > now) {
+        // Sleep for the bulk of the wait
+        if (next - now > SPIN_THRESHOLD)
+            std::this_thread::sleep_for(next - now - SPIN_THRESHOLD);
+        // Yield for the remainder, for precision
+        while ((now = clock::now()) < next)
+            std::this_thread::yield();
+        next += period;
+    } else if (next != clock::time_point() && now - next < std::max(period, MAX_LAG)) {
+        // Slightly late, keep to the schedule so the average rate is maintained
+        next += period;
+    } else {
+        // First call, or far behind, don't catch up with a burst of iterations
+        next = now + period;
+    }
+    return now;
+}
+
+}  // namespace visualiser
+}  // namespace flamegpu
@@ -0,0 +1,62 @@
+#ifndef SRC_FLAMEGPU_VISUALISER_UTIL_RATELIMITER_H_
+#define SRC_FLAMEGPU_VISUALISER_UTIL_RATELIMITER_H_
+
+#include <chrono>
+
+namespace flamegpu {
+namespace visualiser {
+
+/**
+ * Paces a loop to a fixed number of iterations per second, by blocking until each iteration is due
+ * The bulk of each wait is slept, and the remainder is spent yielding, as the scheduler may oversleep by a millisecond or more
+ * Iterations are scheduled at a fixed period, so that the average rate is kept even if individual waits are late
+ * Brief lateness is recovered by returning immediately until back on schedule, longer stalls (e.g. pausing) restart the schedule
+ */
+class RateLimiter {
+ public:
+    typedef std::chrono::steady_clock clock;
+    /**
+     * @param rate Iterations per second, 0 is treated as unlimited
+     */
+    explicit RateLimiter(double rate = 0);
+    /**
+     * Changes the rate, the schedule restarts from the next call to wait()
+     * @param rate Iterations per second, 0 is treated as unlimited
+     */
+    void setRate(double rate);
+    /**
+     * @return The rate in iterations per second, 0 if unlimited
+     */
+    double getRate() const { return rate; }
+    /**
+     * Blocks until the next iteration is due
+     * If the caller has fallen more than max(period, MAX_LAG) behind schedule, the schedule is restarted rather than catching up
+     * @return The time at which the wait ended
+     */
+    clock::time_point wait();
+
+ private:
+    /**
+     * Waits shorter than this are spent yielding, rather than sleeping
+     */
+    static const clock::duration SPIN_THRESHOLD;
+    /**
+     * Lateness which is recovered by catching up, rather than restarting the schedule
+     * This allows high rates to absorb scheduler hiccups of a few periods
+     */
+    static const clock::duration MAX_LAG;
+    double rate;
+    /**
+     * Duration of each iteration, zero if unlimited
+     */
+    clock::duration period;
+    /**
+     * Time at which the next iteration is due, unset until the first call to wait()
+     */
+    clock::time_point next;
+};
+
+}  // namespace visualiser
+}  // namespace flamegpu
+
+#endif  // SRC_FLAMEGPU_VISUALISER_UTIL_RATELIMITER_H_
@@ -3,6 +3,7 @@
 
 #include <cstdio>
 #include <filesystem>
+#include <mutex>
 #include <string>
 
 #include <cmrc/cmrc.hpp>
@@ -14,8 +15,8 @@ namespace visualiser {
 
 namespace {
     std::filesystem::path getTMP() {
-        static std::filesystem::path result;
-        if (result.empty()) {
+        // Function-local static initialisation is thread-safe, as resources may be located by asset loading worker threads
+        static const std::filesystem::path result = []() {
             std::filesystem::path tmp =  std::getenv("FLAMEGPU2_TMP_DIR") ? std::getenv("FLAMEGPU2_TMP_DIR") : std::filesystem::temp_directory_path();
             // Create the $tmp/flamegpu/vis folder hierarchy
             if (!std::filesystem::exists(tmp) && !std::filesystem::create_directories(tmp)) {
@@ -31,10 +32,15 @@ namespace {
             if (!std::filesystem::exists(tmp)) {
                 std::filesystem::create_directories(tmp);
             }
-            result = tmp;
-        }
+            return tmp;
+        }();
         return result;
     }
+    /**
+     * Serialises extraction of embedded resources to the temp dir
+     * Prevents a partially written file being returned to a concurrent caller
+     */
+    std::mutex extractMutex;
     inline uint64_t hash_larson64(const char* s,
         uint64_t seed = 0) {
         uint64_t hash = seed;
@@ -61,6 +67,7 @@ std::string Resources::locateFile(const std::string &_path) {
     temp_dir_path /= t_filename;
     // See if file exists in temp dir, use that
     {
+        std::lock_guard<std::mutex> lock(extractMutex);
         if (std::filesystem::exists(temp_dir_path)) {
             return temp_dir_path.string();
         } else {
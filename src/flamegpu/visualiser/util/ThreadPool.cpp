@@ -0,0 +1,98 @@
+#include "flamegpu/visualiser/util/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace flamegpu {
+namespace visualiser {
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : stopping(false) {
+    if (!threadCount) {
+        // hardware_concurrency() may return 0 if unknown
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&ThreadPool::worker, this);
+    }
+}
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        stopping = true;
+    }
+    tasksCondition.notify_all();
+    for (auto &t : threads) {
+        t.join();
+    }
+}
+void ThreadPool::worker() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(tasksMutex);
+            tasksCondition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            // Queued tasks are completed before exiting, so that no future is left without a result
+            if (tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
+void ThreadPool::parallelFor(const size_t count, const std::function<void(size_t)> &body) {
+    if (!count)
+        return;
+    // Shared with the helper tasks, which may outlive this call if they begin after all iterations have been claimed
+    struct State {
+        std::function<void(size_t)> body;
+        size_t count = 0;
+        std::atomic<size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t completed = 0;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+    state->body = body;
+    state->count = count;
+    const auto run = [](State &st) {
+        for (size_t i = st.next++; i < st.count; i = st.next++) {
+            std::exception_ptr error;
+            try {
+                st.body(i);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(st.mutex);
+            if (error && !st.error)
+                st.error = error;
+            if (++st.completed == st.count)
+                st.condition.notify_all();
+        }
+    };
+    const size_t helpers = std::min(count - 1, threads.size());
+    if (helpers) {
+        {
+            std::lock_guard<std::mutex> lock(tasksMutex);
+            for (size_t i = 0; i < helpers; ++i)
+                tasks.emplace([state, run]() { run(*state); });
+        }
+        tasksCondition.notify_all();
+    }
+    run(*state);
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&state]() { return state->completed == state->count; });
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
+ThreadPool &ThreadPool::get() {
+    static ThreadPool pool;
+    return pool;
+}
+
+}  // namespace visualiser
+}  // namespace flamegpu
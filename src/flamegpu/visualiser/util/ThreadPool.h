@@ -0,0 +1,90 @@
+#ifndef SRC_FLAMEGPU_VISUALISER_UTIL_THREADPOOL_H_
+#define SRC_FLAMEGPU_VISUALISER_UTIL_THREADPOOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace flamegpu {
+namespace visualiser {
+
+/**
+ * Fixed size pool of worker threads, used to perform CPU-side work (e.g. decoding asset files) off the render thread
+ * Tasks must not make any OpenGL calls, as the worker threads never hold the GL context
+ */
+class ThreadPool {
+ public:
+    /**
+     * Creates the worker threads
+     * @param threadCount The number of worker threads, if 0 std::thread::hardware_concurrency() is used
+     */
+    explicit ThreadPool(unsigned int threadCount = 0);
+    /**
+     * Completes any queued tasks, then joins the worker threads
+     */
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    /**
+     * Queue a task for execution on a worker thread
+     * @param task Callable object, taking no arguments
+     * @return A future which returns the result of the task (or rethrows any exception thrown by it)
+     */
+    template<typename F>
+    std::future<std::invoke_result_t<std::decay_t<F>>> submit(F &&task);
+    /**
+     * Executes body(i) for each i in [0, count), on the calling thread and any idle worker threads
+     * The calling thread takes part in the work, and never waits on an iteration which has not begun,
+     * so this may be safely called from within a task (e.g. by a preload)
+     * @param count The number of iterations
+     * @param body Callable object, taking the iteration index
+     * @throws Rethrows the first exception thrown by body, once all started iterations have completed
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)> &body);
+    /**
+     * @return The number of worker threads
+     */
+    unsigned int size() const { return static_cast<unsigned int>(threads.size()); }
+    /**
+     * Returns the process-wide pool used for asset loading
+     * This is lazily created on first use
+     */
+    static ThreadPool &get();
+
+ private:
+    /**
+     * Loop executed by each worker thread, until the pool is destroyed
+     */
+    void worker();
+    std::vector<std::thread> threads;
+    std::queue<std::function<void()>> tasks;
+    std::mutex tasksMutex;
+    std::condition_variable tasksCondition;
+    bool stopping;
+};
+
+template<typename F>
+std::future<std::invoke_result_t<std::decay_t<F>>> ThreadPool::submit(F &&task) {
+    typedef std::invoke_result_t<std::decay_t<F>> R;
+    // std::function requires a copyable target, so the packaged_task is held by shared_ptr
+    auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+    std::future<R> rtn = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        tasks.emplace([packaged]() { (*packaged)(); });
+    }
+    tasksCondition.notify_one();
+    return rtn;
+}
+
+}  // namespace visualiser
+}  // namespace flamegpu
+
+#endif  // SRC_FLAMEGPU_VISUALISER_UTIL_THREADPOOL_H_
@@ -1,5 +1,14 @@
 #include "flamegpu/visualiser/util/fonts.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+
 #include "flamegpu/visualiser/util/VisException.h"
+#include "flamegpu/visualiser/util/Resources.h"
 
 // Linux implementation
 #if defined(__GNUC__) || defined(__clang__)
@@ -57,26 +66,35 @@ std::string fontQueryString(std::initializer_list<const char *> fontNames, const
     query += genericFontName(generic);
     return query;
 }
+/**
+ * Process-wide fontconfig configuration, loaded on first use
+ * FcInitLoadConfigAndFonts() scans every installed font, so this is only performed once
+ * @see releaseFontConfig()
+ */
+FcConfig *fontConfig = nullptr;
 /**
  * Find a single font from a string
  * @param comma separated list of fontNames to search for.
  * @return string of path to font file, or empty string if un found
+ * @note The caller must hold the font cache mutex, as this lazily initialises fontConfig
  */
 std::string fontSearch(const std::string commaSeparatedfonts) {
     std::string fontpath = "";
 
-    // Initialise fontconfig
-    FcConfig* config = FcInitLoadConfigAndFonts();
+    // Initialise fontconfig (only on the first search)
+    if (!fontConfig) {
+        fontConfig = FcInitLoadConfigAndFonts();
+    }
 
     // Construct a pattern searching for the desired font
     FcPattern* pat = FcNameParse((const FcChar8*)(commaSeparatedfonts.c_str()));
 
     // Apply fontconfig substitution.
-    FcConfigSubstitute(config, pat, FcMatchPattern);
+    FcConfigSubstitute(fontConfig, pat, FcMatchPattern);
     FcDefaultSubstitute(pat);
     // Apply the fontconfig matching
     FcResult res;
-    FcPattern* font = FcFontMatch(config, pat, &res);
+    FcPattern* font = FcFontMatch(fontConfig, pat, &res);
 
     // If we have a result
     if (font) {
@@ -90,24 +108,17 @@ std::string fontSearch(const std::string commaSeparatedfonts) {
     // Tidy up.
     FcPatternDestroy(pat);
 
-    // Destroy the FcConfig - this will force a re-initialisation on subsequent calls to fontSearch, but prevent leakage
-    FcConfigDestroy(config);
-    config = nullptr;
-
     // Return the path to the desired font.
     return fontpath;
 }
-}  // Anonymous namespace
-
 /**
  * Find a font from an ordered list of desired fonts, or use a fallback font
- * @param fontnames a list of fontnames as constant character arrays
+ * @param fontNames a list of fontnames as constant character arrays
  * @param generic enum specifying a fallback font type in case the target font could not be found.
- * @return path to font to use, or empty string if nothing found (if no system fonts installed)
- * 
- * @note this does not use a list of std::strings as this complicated initialisation.
+ * @return path to font to use
+ * @note The caller must hold the font cache mutex
  */
-std::string findFont(std::initializer_list<const char *> fontNames, const GenericFontFamily generic) {
+std::string resolveFont(std::initializer_list<const char *> fontNames, const GenericFontFamily generic) {
     // Construct the fontName search
     std::string query = fontQueryString(fontNames, generic);
 
@@ -121,7 +132,19 @@ std::string findFont(std::initializer_list<const char *> fontNames, const Generi
     // Return the path to the font.
     return fontpath;
 }
-
+/**
+ * Release the platform specific font search state
+ * @note The caller must hold the font cache mutex
+ */
+void releasePlatformFontConfig() {
+    if (fontConfig) {
+        FcConfigDestroy(fontConfig);
+        fontConfig = nullptr;
+    }
+    // Fully clean up font config
+    FcFini();
+}
+}  // Anonymous namespace
 
 }  // namespace fonts
 
@@ -329,17 +352,14 @@ std::string genericFontName(GenericFontFamily generic) {
     * @todo - this should probably actually just be a selected font which meets some properties, rather than a specific named value.
     */
 const char* FALLBACK_FONTNAME = "Arial";
-}  // Anonymous namespace
 
 /**
  * Find a font from an ordered list of desired fonts, or use a fallback font
  * @param fontNames a list of fontnames as constant character arrays
  * @param generic enum specifying a fallback font type in case the target font could not be found.
- * @return path to font to use, or empty string if nothing found (if no system fonts installed)
- * 
- * @note this does not use a list of std::strings as this complicated initialisation.
+ * @return path to font to use
  */
-std::string findFont(std::initializer_list<const char *> fontNames, const GenericFontFamily generic) {
+std::string resolveFont(std::initializer_list<const char *> fontNames, const GenericFontFamily generic) {
     // For each font in the list, search for it. Return if found.
     for (auto _fontName : fontNames) {
         std::string fontName(_fontName);
@@ -363,6 +383,12 @@ std::string findFont(std::initializer_list<const char *> fontNames, const Generi
     // Otherwise we need to bail out  without any fonts.
     THROW FontLoadingError("Windows Font Loading Error at %s::%u", __FILE__, __LINE__);
 }
+/**
+ * Release the platform specific font search state
+ * DirectWrite objects are not retained between searches, so there is nothing to do
+ */
+void releasePlatformFontConfig() { }
+}  // Anonymous namespace
 
 }  // namespace fonts
 }  // namespace visualiser
@@ -370,4 +396,106 @@ std::string findFont(std::initializer_list<const char *> fontNames, const Generi
 
 #endif
 
+// Platform independent font resolution cache
+
+namespace flamegpu {
+namespace visualiser {
+namespace fonts {
+
+namespace {
+/**
+ * Name of the file within the visualisation temp directory used to persist resolved font paths
+ */
+const char *FONT_CACHE_FILENAME = "font_cache.txt";
+/**
+ * Guards the font cache and the platform font search state
+ */
+std::mutex fontCacheMutex;
+/**
+ * Memoised font paths, keyed by fontCacheKey()
+ */
+std::map<std::string, std::string> fontCache;
+/**
+ * Set once the persistent cache file has been read into fontCache (if enabled)
+ */
+bool fontCacheLoaded = false;
+/**
+ * Persistence of resolved font paths is opt-in, as newly installed fonts are not detected whilst an entry exists
+ * @return true if the environment variable FLAMEGPU2_FONT_CACHE is set to a value other than 0
+ */
+bool persistentCacheEnabled() {
+    const char *env = std::getenv("FLAMEGPU2_FONT_CACHE");
+    return env && env[0] != '\0' && std::string(env) != "0";
+}
+/**
+ * Construct the key used to memoise a font search
+ * @param fontNames a list of font names
+ * @param generic the generic font family
+ * @return a std::string containing the tab separated font names, followed by the generic family id
+ */
+std::string fontCacheKey(std::initializer_list<const char *> fontNames, const GenericFontFamily generic) {
+    std::string key;
+    for (auto fontName : fontNames) {
+        if (fontName && fontName[0] != '\0') {
+            key.append(fontName).append("\t");
+        }
+    }
+    return key.append(std::to_string(static_cast<int>(generic)));
+}
+/**
+ * Read previously resolved font paths from the persistent cache file
+ * Entries are stored as a key line followed by a path line, entries whose font file no longer exists are skipped
+ */
+void loadPersistentCache() {
+    std::ifstream in(Resources::toTempDir(FONT_CACHE_FILENAME));
+    std::string key, path;
+    while (std::getline(in, key) && std::getline(in, path)) {
+        std::error_code ec;
+        if (!path.empty() && std::filesystem::exists(path, ec)) {
+            fontCache.emplace(key, path);
+        }
+    }
+}
+/**
+ * Append a resolved font path to the persistent cache file
+ * Failure to write is silently ignored, the cache only affects performance
+ */
+void savePersistentCache(const std::string &key, const std::string &path) {
+    std::ofstream out(Resources::toTempDir(FONT_CACHE_FILENAME), std::ios::app);
+    if (out) {
+        out << key << "\n" << path << "\n";
+    }
+}
+}  // Anonymous namespace
+
+std::string findFont(std::initializer_list<const char *> fontNames, const GenericFontFamily generic) {
+    std::lock_guard<std::mutex> lock(fontCacheMutex);
+    const bool persist = persistentCacheEnabled();
+    if (persist && !fontCacheLoaded) {
+        loadPersistentCache();
+        fontCacheLoaded = true;
+    }
+    const std::string key = fontCacheKey(fontNames, generic);
+    const auto it = fontCache.find(key);
+    if (it != fontCache.end()) {
+        return it->second;
+    }
+    // Not previously resolved, perform the (expensive) platform search
+    const std::string fontpath = resolveFont(fontNames, generic);
+    fontCache.emplace(key, fontpath);
+    if (persist) {
+        savePersistentCache(key, fontpath);
+    }
+    return fontpath;
+}
+
+void releaseFontConfig() {
+    std::lock_guard<std::mutex> lock(fontCacheMutex);
+    releasePlatformFontConfig();
+}
+
+}  // namespace fonts
+}  // namespace visualiser
+}  // namespace flamegpu
+
 
@@ -1,6 +1,7 @@
 #ifndef SRC_FLAMEGPU_VISUALISER_UTIL_FONTS_H_
 #define SRC_FLAMEGPU_VISUALISER_UTIL_FONTS_H_
 
+#include <initializer_list>
 #include <map>
 #include <string>
 #include <vector>
@@ -22,6 +23,12 @@ enum GenericFontFamily { SANS, SERIF, CURSIVE, MONOSPACE };
  * @note this does not use a list of std::strings as this complicated initialisation.
  */
 std::string findFont(std::initializer_list<const char *> fontnames, const GenericFontFamily generic);
+/**
+ * Release the process-wide font configuration used by findFont()
+ * Previously resolved fonts remain memoised, the configuration is lazily reloaded if a new search is required
+ * @note Under Linux this also calls FcFini(), so should only be called once fontconfig is no longer in use
+ */
+void releaseFontConfig();
 
 }  // namespace fonts
 }  // namespace visualiser
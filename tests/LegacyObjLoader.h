@@ -0,0 +1,272 @@
+#ifndef TESTS_LEGACYOBJLOADER_H_
+#define TESTS_LEGACYOBJLOADER_H_
+
+#include <array>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <sparsehash/dense_hash_map>
+
+/**
+ * Reference copy of the original two pass .obj parser of Entity::loadModelFromFile()
+ * Retained so that the geometry produced by the current loader can be checked against it
+ * Only geometry is loaded, materials and the export redirection are omitted
+ * @note This reproduces the original parser's limitations (e.g. no exponents, relative indices or polygons), so is only suitable for the stock models
+ */
+struct LegacyObjModel {
+    unsigned int positionComponents = 3;
+    unsigned int colorComponents = 0;
+    unsigned int texcoordComponents = 2;
+    // Number of unique vertex/normal/texcoord triples
+    unsigned int vn_count = 0;
+    // Per unique vertex, empty if not present in the model
+    std::vector<float> positions, normals, colors, texcoords;
+    // 3 indices per face, into the per unique vertex arrays
+    std::vector<unsigned int> faces;
+    // Bounds of all positions in the file
+    std::array<float, 3> modelMin{ FLT_MAX, FLT_MAX, FLT_MAX };
+    std::array<float, 3> modelMax{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+};
+
+namespace legacy_obj {
+/**
+ * Key of the original parser's hashmap of vertex/normal/texcoord triples
+ */
+struct VN_PAIR {
+    unsigned int v, n, t;
+};
+/**
+ * The original parser's hash, retained as-is so that the reference is also representative for timing
+ */
+struct hashVN_PAIR {
+    size_t operator()(const VN_PAIR &x) const {
+        static int offset = sizeof(uint64_t) / 3;
+        return (x.t << offset * 2) & (x.n << offset) & x.v;
+    }
+};
+struct eqVN_PAIR {
+    bool operator()(const VN_PAIR &t1, const VN_PAIR &t2) const {
+        return t1.v == t2.v && t1.n == t2.n && t1.t == t2.t;
+    }
+};
+/**
+ * Reads a component in the manner of the original parser: skipping leading characters rejected by skip(), then consuming digits and '.'
+ * @return False if EOF was reached
+ */
+template<typename SkipFn>
+inline bool readComponent(FILE *file, char &c, std::string &buffer, SkipFn skip, bool allowDot = true) {
+    while ((c = static_cast<char>(fgetc(file))) != EOF) {
+        if (!skip(c))
+            break;
+    }
+    buffer.clear();
+    do {
+        if (c == EOF)
+            return false;
+        buffer.push_back(c);
+    } while (((c = static_cast<char>(fgetc(file))) >= '0' && c <= '9') || (allowDot && c == '.'));
+    return true;
+}
+inline bool skipToEndOfLine(FILE *file, char &c) {
+    while (c != '\n') {
+        if ((c = static_cast<char>(fgetc(file))) == EOF)
+            return false;
+    }
+    return true;
+}
+}  // namespace legacy_obj
+
+/**
+ * Loads the named .obj file with the original parser
+ * @param path Path to the .obj file
+ * @return False if the file could not be opened, or contained no vertices or faces
+ */
+inline bool loadLegacyObj(const std::string &path, LegacyObjModel &out) {
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file)
+        return false;
+    // First pass, count elements and detect their component counts
+    unsigned int positions_read = 0, normals_read = 0, colors_read = 0, texcoords_read = 0, faces_read = 0;
+    bool face_hasNormals = false, face_hasTexcoords = false;
+    char c;
+    while ((c = static_cast<char>(fgetc(file))) != EOF) {
+        int dotCtr = 0;
+        if (c == 'v') {
+            if ((c = static_cast<char>(fgetc(file))) == EOF)
+                break;
+            if (c == ' ' || c == 't') {
+                const bool isVertex = c == ' ';
+                while ((c = static_cast<char>(fgetc(file))) != '\n' && c != EOF) {
+                    if (c == '.')
+                        dotCtr++;
+                }
+                if (isVertex) {
+                    positions_read++;
+                    // Count the number of '.', to detect 4 component positions and colors
+                    if (dotCtr == 8) {
+                        colors_read++;
+                        out.colorComponents = 4;
+                        out.positionComponents = 4;
+                    } else if (dotCtr == 4) {
+                        out.positionComponents = 4;
+                    } else if (dotCtr == 7 || dotCtr == 6) {
+                        if (dotCtr == 7)
+                            out.positionComponents = 4;
+                        out.colorComponents = 3;
+                        colors_read++;
+                    }
+                } else {
+                    texcoords_read++;
+                    out.texcoordComponents = dotCtr;
+                }
+                if (c == EOF)
+                    break;
+                continue;
+            } else if (c == 'n') {
+                normals_read++;
+            }
+        } else if (c == 'f') {
+            faces_read++;
+            // Workout whether the format is 'v' 'v//n' or 'v/t/n'
+            while ((c = static_cast<char>(fgetc(file))) != '\n' && c != EOF) {
+                if (c == '/') {
+                    face_hasNormals = true;
+                    if ((c = static_cast<char>(fgetc(file))) != '/')
+                        face_hasTexcoords = true;
+                    break;
+                }
+            }
+        }
+        if (!legacy_obj::skipToEndOfLine(file, c))
+            break;
+    }
+    if (positions_read == 0 || faces_read == 0) {
+        fclose(file);
+        return false;
+    }
+    if (colors_read != 0 && colors_read != positions_read)
+        colors_read = 0;
+    const unsigned int colorComponents = colors_read ? out.colorComponents : 0;
+    const unsigned int faceStride = 1 + static_cast<unsigned int>(face_hasNormals) + static_cast<unsigned int>(face_hasTexcoords);
+    std::vector<float> t_vertices(positions_read * out.positionComponents);
+    std::vector<float> t_colors(colors_read * out.colorComponents);
+    std::vector<float> t_normals(normals_read * 3);
+    std::vector<float> t_texcoords(texcoords_read * out.texcoordComponents);
+    std::vector<unsigned int> t_vert_pos(faces_read * 3), t_norm_pos(faces_read * 3), t_tex_pos(faces_read * 3);
+    // Second pass, read the elements
+    clearerr(file);
+    fseek(file, 0, SEEK_SET);
+    positions_read = normals_read = colors_read = texcoords_read = faces_read = 0;
+    std::string buffer;
+    const auto isSpace = [](const char ch) { return ch == ' '; };
+    const auto isNotDigit = [](const char ch) { return ch < '0' || ch > '9'; };
+    while ((c = static_cast<char>(fgetc(file))) != EOF) {
+        if (c == 'v') {
+            if ((c = static_cast<char>(fgetc(file))) == EOF)
+                break;
+            if (c == ' ') {
+                for (unsigned int k = 0; k < out.positionComponents; ++k) {
+                    if (!legacy_obj::readComponent(file, c, buffer, isSpace))
+                        goto exit_loop;
+                    const float v = static_cast<float>(atof(buffer.c_str()));
+                    t_vertices[positions_read * out.positionComponents + k] = v;
+                    if (k < 3) {
+                        out.modelMax[k] = v > out.modelMax[k] ? v : out.modelMax[k];
+                        out.modelMin[k] = v < out.modelMin[k] ? v : out.modelMin[k];
+                    }
+                }
+                if (c != '\n' && colorComponents) {
+                    for (unsigned int k = 0; k < colorComponents; ++k) {
+                        if (!legacy_obj::readComponent(file, c, buffer, isSpace))
+                            goto exit_loop;
+                        t_colors[positions_read * colorComponents + k] = static_cast<float>(atof(buffer.c_str()));
+                    }
+                }
+                positions_read++;
+            } else if (c == 'n') {
+                for (unsigned int k = 0; k < 3; ++k) {
+                    if (!legacy_obj::readComponent(file, c, buffer, isSpace))
+                        goto exit_loop;
+                    t_normals[normals_read * 3 + k] = static_cast<float>(atof(buffer.c_str()));
+                }
+                normals_read++;
+            } else if (c == 't') {
+                for (unsigned int k = 0; k < out.texcoordComponents; ++k) {
+                    if (!legacy_obj::readComponent(file, c, buffer, isNotDigit))
+                        goto exit_loop;
+                    t_texcoords[texcoords_read * out.texcoordComponents + k] = static_cast<float>(atof(buffer.c_str()));
+                }
+                texcoords_read++;
+            }
+        } else if (c == 'f') {
+            for (unsigned int k = 0; k < faceStride * 3; ++k) {
+                if (!legacy_obj::readComponent(file, c, buffer, isNotDigit, false))
+                    goto exit_loop;
+                // Decrease value by 1, obj is 1-index, our arrays are 0-index
+                const unsigned int index = static_cast<unsigned int>(std::strtoul(buffer.c_str(), nullptr, 0)) - 1;
+                const unsigned int corner = faces_read * 3 + k / faceStride;
+                switch (k % faceStride) {
+                case 0:
+                    t_vert_pos[corner] = index;
+                    break;
+                case 1:
+                    if (face_hasTexcoords) {
+                        t_tex_pos[corner] = index;
+                        break;
+                    }
+                    [[fallthrough]];
+                case 2:
+                    t_norm_pos[corner] = index;
+                    break;
+                }
+            }
+            faces_read++;
+        }
+        if (!legacy_obj::skipToEndOfLine(file, c))
+            break;
+    }
+exit_loop:
+    fclose(file);
+    // Count the unique vertex/normal/texcoord triples, then assign each an id in order of first use
+    google::dense_hash_map<legacy_obj::VN_PAIR, unsigned int, legacy_obj::hashVN_PAIR, legacy_obj::eqVN_PAIR> vn_pairs;
+    vn_pairs.set_empty_key({ UINT_MAX, UINT_MAX, UINT_MAX });
+    vn_pairs.resize(faces_read * 3);
+    for (unsigned int i = 0; i < faces_read * 3; ++i) {
+        vn_pairs[{ t_vert_pos[i], face_hasNormals ? t_norm_pos[i] : 0, face_hasTexcoords ? t_tex_pos[i] : 0 }] = UINT_MAX;
+    }
+    out.faces.resize(faces_read * 3);
+    for (unsigned int i = 0; i < faces_read * 3; ++i) {
+        const unsigned int i_vert = t_vert_pos[i];
+        const unsigned int i_norm = face_hasNormals ? t_norm_pos[i] : 0;
+        const unsigned int i_tex = face_hasTexcoords ? t_tex_pos[i] : 0;
+        unsigned int &id = vn_pairs[{ i_vert, i_norm, i_tex }];
+        if (id == UINT_MAX) {
+            id = out.vn_count++;
+            for (unsigned int k = 0; k < out.positionComponents; ++k)
+                out.positions.push_back(t_vertices[i_vert * out.positionComponents + k]);
+            if (face_hasNormals) {
+                const float *n = &t_normals[i_norm * 3];
+                const float len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                for (unsigned int k = 0; k < 3; ++k)
+                    out.normals.push_back(n[k] / len);
+            }
+            for (unsigned int k = 0; k < colorComponents; ++k)
+                out.colors.push_back(t_colors[i_vert * colorComponents + k]);
+            if (face_hasTexcoords) {
+                for (unsigned int k = 0; k < out.texcoordComponents; ++k)
+                    out.texcoords.push_back(t_texcoords[i_tex * out.texcoordComponents + k]);
+            }
+        }
+        out.faces[i] = id;
+    }
+    out.colorComponents = colorComponents;
+    return true;
+}
+
+#endif  // TESTS_LEGACYOBJLOADER_H_
@@ -0,0 +1,28 @@
+#ifndef TESTS_MODELEXPORT_H_
+#define TESTS_MODELEXPORT_H_
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#include "flamegpu/visualiser/util/Resources.h"
+
+/**
+ * Returns the path of the binary export which Entity::ModelData writes after parsing an .obj model, and imports on subsequent loads
+ * This mirrors Entity::ModelData::loadModelFromFile(), test_model_export checks that a parse writes its export here
+ * @param modelPath Path to the .obj model, as passed to Entity::ModelData
+ */
+inline std::string modelExportPath(const std::string &modelPath) {
+    // Entity::OBJ_TYPE is replaced with Entity::EXPORT_TYPE, and the result redirected to the temp dir
+    const std::string objType = ".obj";
+    return flamegpu::visualiser::Resources::toTempDir(modelPath.substr(0, modelPath.length() - objType.length()) + ".obj.sdl_export");
+}
+/**
+ * Removes the binary export cached by a previous load of the model, so that the next load parses the .obj
+ */
+inline void removeModelExport(const std::string &modelPath) {
+    std::error_code ec;
+    std::filesystem::remove(modelExportPath(modelPath), ec);
+}
+
+#endif  // TESTS_MODELEXPORT_H_
@@ -0,0 +1,75 @@
+/**
+ * Micro-benchmark of the .obj loader, for each stock .obj model
+ * Times the original parser, the current parser (including writing its binary export) and importing that export
+ */
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "check.h"
+#include "LegacyObjLoader.h"
+#include "ModelExport.h"
+#include "flamegpu/visualiser/config/Stock.h"
+#include "flamegpu/visualiser/Entity.h"
+#include "flamegpu/visualiser/util/Resources.h"
+
+using flamegpu::visualiser::Entity;
+using flamegpu::visualiser::Resources;
+namespace Models = flamegpu::visualiser::Stock::Models;
+
+namespace {
+
+const unsigned int ITERATIONS = 50;
+const char *const STOCK_OBJ_MODELS[] = {
+    // SPHERE and ICOSPHERE are now generated by PrimitiveMesh, the .obj models they replaced remain embedded resources
+    "resources/sphere.obj",
+    "resources/icosphere.obj",
+    Models::CUBE_SMOOTH.modelPath,
+    Models::TEAPOT.modelPath,
+    Models::STUNTPLANE.modelPath,
+    Models::PYRAMID.modelPath,
+    Models::ARROWHEAD.modelPath,
+    Models::PEDESTRIAN.modelPathA,
+    Models::PEDESTRIAN.modelPathB,
+};
+
+/**
+ * @return Mean duration of fn() in microseconds
+ */
+template<typename Fn>
+double meanMicroseconds(Fn fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < ITERATIONS; ++i)
+        fn();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+}
+
+}  // namespace
+
+int main() {
+    Entity::setOptimiseModels(false);
+    printf("Mean of %u loads (us)\n", ITERATIONS);
+    printf("%-28s %10s %10s %10s %10s %8s\n", "Model", "Faces", "Original", "Parse", "Import", "Speedup");
+    for (const char *modelPath : STOCK_OBJ_MODELS) {
+        const std::string filePath = Resources::locateFile(modelPath);
+        unsigned int faces = 0;
+        const double legacyTime = meanMicroseconds([&]() {
+            LegacyObjModel legacy;
+            CHECK(loadLegacyObj(filePath, legacy));
+            faces = static_cast<unsigned int>(legacy.faces.size() / 3);
+        });
+        const double parseTime = meanMicroseconds([&]() {
+            removeModelExport(modelPath);
+            const Entity::ModelData data(modelPath);
+            CHECK(data.faces.count == faces);
+        });
+        // The final parse left an export behind
+        const double importTime = meanMicroseconds([&]() {
+            const Entity::ModelData data(modelPath);
+            CHECK(data.faces.count == faces);
+        });
+        removeModelExport(modelPath);
+        printf("%-28s %10u %10.1f %10.1f %10.1f %7.2fx\n", modelPath, faces, legacyTime, parseTime, importTime, legacyTime / parseTime);
+    }
+    return CHECK_RESULT();
+}
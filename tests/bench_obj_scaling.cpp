@@ -0,0 +1,121 @@
+/**
+ * Scaling benchmark of the .obj loader, over generated grid meshes of increasing face count
+ * Parse time per face should remain roughly constant, i.e. load time should scale linearly with face count
+ * The original parser deduplicated vertices with a degenerate hash, so is only timed for the smaller meshes
+ * Timings are only reported, as they depend on the machine and its load, only the loaded geometry is checked
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#include "check.h"
+#include "LegacyObjLoader.h"
+#include "ModelExport.h"
+#include "flamegpu/visualiser/Entity.h"
+#include "flamegpu/visualiser/util/Resources.h"
+
+using flamegpu::visualiser::Entity;
+using flamegpu::visualiser::Resources;
+
+namespace {
+
+const unsigned int ITERATIONS = 3;
+// Each grid of N*N quads has 2*N*N faces
+const unsigned int GRID_SIZES[] = { 32, 64, 128, 256, 512 };
+// Meshes larger than this are not loaded with the original parser
+const unsigned int LEGACY_MAX_FACES = 40000;
+// Meshes smaller than this are dominated by fixed overheads, so are excluded from the reported spread of parse time per face
+const unsigned int SPREAD_MIN_FACES = 8192;
+
+/**
+ * Writes a flat N*N grid of quads, each split into two triangles, with a unique normal and texcoord per vertex
+ * @return False if the file could not be written
+ */
+bool writeGrid(const std::string &path, const unsigned int n) {
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+    const unsigned int verts = n + 1;
+    for (unsigned int y = 0; y < verts; ++y) {
+        for (unsigned int x = 0; x < verts; ++x) {
+            const float u = static_cast<float>(x) / n, v = static_cast<float>(y) / n;
+            fprintf(file, "v %f %f %f\n", u, 0.1f * u * v, v);
+            fprintf(file, "vn %f %f %f\n", 0.1f * v, 1.0f, 0.1f * u);
+            fprintf(file, "vt %f %f\n", u, v);
+        }
+    }
+    for (unsigned int y = 0; y < n; ++y) {
+        for (unsigned int x = 0; x < n; ++x) {
+            // obj is 1-indexed
+            const unsigned int a = y * verts + x + 1, b = a + 1, c = a + verts, d = c + 1;
+            fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, c, c, c, b, b, b);
+            fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", b, b, b, c, c, c, d, d, d);
+        }
+    }
+    return fclose(file) == 0;
+}
+/**
+ * @return Fastest duration of fn() in microseconds, which is less sensitive to interruptions than the mean
+ */
+template<typename Fn>
+double minMicroseconds(Fn fn) {
+    double best = 0;
+    for (unsigned int i = 0; i < ITERATIONS; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const double t = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        best = i ? std::min(best, t) : t;
+    }
+    return best;
+}
+
+}  // namespace
+
+int main() {
+    Entity::setOptimiseModels(false);
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    double minPerFace = 0, maxPerFace = 0;
+    printf("Fastest of %u loads (us)\n", ITERATIONS);
+    printf("%10s %12s %12s %12s %12s %12s\n", "Faces", "Original", "Parse", "Import", "Parse/face", "Import/face");
+    for (const unsigned int n : GRID_SIZES) {
+        const std::string modelPath = (dir / ("flamegpu_visualiser_grid_" + std::to_string(n) + ".obj")).string();
+        const unsigned int faces = 2 * n * n;
+        CHECK(writeGrid(modelPath, n));
+        double legacyTime = 0;
+        if (faces <= LEGACY_MAX_FACES) {
+            legacyTime = minMicroseconds([&]() {
+                LegacyObjModel legacy;
+                CHECK(loadLegacyObj(modelPath, legacy));
+                CHECK(legacy.faces.size() == faces * 3);
+            });
+        }
+        const double parseTime = minMicroseconds([&]() {
+            removeModelExport(modelPath);
+            const Entity::ModelData data(modelPath);
+            CHECK(data.faces.count == faces);
+            CHECK(data.vn_count == (n + 1) * (n + 1));
+        });
+        // The final parse left an export behind
+        const double importTime = minMicroseconds([&]() {
+            const Entity::ModelData data(modelPath);
+            CHECK(data.faces.count == faces);
+        });
+        removeModelExport(modelPath);
+        std::error_code ec;
+        std::filesystem::remove(modelPath, ec);
+        if (legacyTime > 0)
+            printf("%10u %12.1f %12.1f %12.1f %12.4f %12.4f\n", faces, legacyTime, parseTime, importTime, parseTime / faces, importTime / faces);
+        else
+            printf("%10u %12s %12.1f %12.1f %12.4f %12.4f\n", faces, "-", parseTime, importTime, parseTime / faces, importTime / faces);
+        if (faces >= SPREAD_MIN_FACES) {
+            const double perFace = parseTime / faces;
+            minPerFace = minPerFace > 0 ? std::min(minPerFace, perFace) : perFace;
+            maxPerFace = std::max(maxPerFace, perFace);
+        }
+    }
+    printf("Parse time per face of meshes with at least %u faces varies by %.2fx\n", SPREAD_MIN_FACES, maxPerFace / minPerFace);
+    return CHECK_RESULT();
+}
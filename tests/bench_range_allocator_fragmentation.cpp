@@ -0,0 +1,248 @@
+/**
+ * Fragmentation benchmark for Draw's vertex buffer management
+ * Named states are repeatedly replaced with states of a different size, as happens when sketches are redrawn each step
+ * The allocation policy of Draw::saveArrays() is mirrored without OpenGL, alongside the policy it replaced (an unsorted gap list, without coalescing)
+ * Each grow or compaction of the buffer copies every live state, so the policies are compared by how often they resize the buffer
+ * Grows, compactions and copies are deterministic so are checked, timings are only reported
+ */
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "check.h"
+#include "flamegpu/visualiser/util/RangeAllocator.h"
+
+using flamegpu::visualiser::RangeAllocator;
+
+namespace {
+
+const unsigned int DEFAULT_INITIAL_VBO_LENGTH = 1024;
+const float STORAGE_MUTLIPLIER = 2.0f;
+
+struct Range {
+    unsigned int offset;
+    unsigned int count;
+};
+struct Stats {
+    unsigned int grows = 0;
+    unsigned int compactions = 0;
+    // Elements moved by grows and compactions
+    uint64_t copied = 0;
+    unsigned int resizes() const { return grows + compactions; }
+};
+/**
+ * Mirrors the range management of Draw::saveArrays(), Draw::allocate() and Draw::resize()
+ */
+class Buffer {
+ public:
+    Buffer() : allocator(DEFAULT_INITIAL_VBO_LENGTH) { }
+    void save(const std::string &name, const unsigned int count) {
+        auto f = states.find(name);
+        if (f != states.end()) {
+            // Same length, so overwritten in place
+            if (f->second.count == count)
+                return;
+            allocator.release(f->second.offset, f->second.count);
+            requiredLength -= f->second.count;
+            states.erase(f);
+        }
+        const unsigned int offset = allocate(count);
+        requiredLength += count;
+        states.insert({ name, Range{ offset, count } });
+    }
+    unsigned int getLength() const { return allocator.getLength(); }
+    Stats stats;
+
+ private:
+    unsigned int allocate(const unsigned int count) {
+        unsigned int bufferPos = allocator.allocate(count);
+        if (bufferPos == RangeAllocator::INVALID) {
+            const unsigned int vboLen = allocator.getLength();
+            if (allocator.getFreeCount() >= count + vboLen / 4) {
+                resize(vboLen);
+                ++stats.compactions;
+            } else {
+                unsigned int newLen = vboLen;
+                do {
+                    newLen = static_cast<unsigned int>(newLen * STORAGE_MUTLIPLIER);
+                } while (requiredLength + count > newLen);
+                resize(newLen);
+                ++stats.grows;
+            }
+            bufferPos = allocator.allocate(count);
+        }
+        return bufferPos;
+    }
+    void resize(const unsigned int newLength) {
+        std::vector<Range*> order;
+        for (auto &a : states)
+            order.push_back(&a.second);
+        std::sort(order.begin(), order.end(), [](const Range *a, const Range *b) { return a->offset < b->offset; });
+        unsigned int _offset = 0;
+        for (Range *r : order) {
+            r->offset = _offset;
+            _offset += r->count;
+        }
+        stats.copied += _offset;
+        allocator.reset(newLength, _offset);
+    }
+    RangeAllocator allocator;
+    unsigned int requiredLength = 0;
+    std::map<std::string, Range> states;
+};
+/**
+ * Mirrors the range management of Draw::save(), Draw::_save() and Draw::resize() prior to RangeAllocator
+ */
+class LegacyBuffer {
+ public:
+    void save(const std::string &name, const unsigned int count) {
+        const unsigned int offset = allocate(count);
+        auto f = states.find(name);
+        if (f != states.end()) {
+            gaps.push_back(f->second);
+            requiredLength -= f->second.count;
+            states.erase(f);
+        }
+        requiredLength += count;
+        states.insert({ name, Range{ offset, count } });
+    }
+    unsigned int getLength() const { return vboLen; }
+    Stats stats;
+
+ private:
+    unsigned int allocate(const unsigned int count) {
+        unsigned int best = UINT_MAX;
+        unsigned int bestCt = UINT_MAX;
+        for (unsigned int i = 0; i < gaps.size(); ++i) {
+            if (gaps[i].count > count && gaps[i].count <= bestCt) {
+                best = i;
+                bestCt = gaps[i].count;
+            }
+        }
+        if (best < gaps.size()) {
+            const Range gap = gaps[best];
+            gaps.erase(gaps.begin() + best);
+            gaps.push_back({ gap.offset + count, gap.count - count });
+            return gap.offset;
+        }
+        if (vboOffset + count > vboLen) {
+            unsigned int newLen = vboLen;
+            while (requiredLength + count > newLen)
+                newLen = static_cast<unsigned int>(newLen * STORAGE_MUTLIPLIER);
+            // The old implementation always compacts when resizing, even if the length is unchanged
+            if (newLen == vboLen)
+                ++stats.compactions;
+            else
+                ++stats.grows;
+            vboLen = newLen;
+            vboOffset = 0;
+            for (auto &a : states) {
+                a.second.offset = vboOffset;
+                vboOffset += a.second.count;
+            }
+            stats.copied += vboOffset;
+            gaps.clear();
+        }
+        const unsigned int rtn = vboOffset;
+        vboOffset += count;
+        return rtn;
+    }
+    unsigned int vboLen = DEFAULT_INITIAL_VBO_LENGTH;
+    unsigned int vboOffset = 0;
+    unsigned int requiredLength = 0;
+    std::vector<Range> gaps;
+    std::map<std::string, Range> states;
+};
+/**
+ * A sequence of replacements of named states
+ */
+struct Scenario {
+    const char *name;
+    unsigned int stateCount;
+    unsigned int maxInitialVertices;
+    // Vertices added to a state each time it is replaced, if 0 states are instead replaced with a random size up to maxInitialVertices
+    unsigned int maxGrowth;
+    unsigned int warmupReplacements;
+    unsigned int replacements;
+};
+const Scenario SCENARIOS[] = {
+    // Sketches redrawn with a different number of vertices each step
+    { "Redraw", 256, 512, 0, 2000, 100000 },
+    { "Redraw many", 1024, 512, 0, 5000, 100000 },
+    // Plots whose history lengthens each step
+    { "Lengthen", 256, 64, 8, 0, 50000 },
+};
+struct Result {
+    // Accumulated after the warm-up replacements
+    Stats warmStats;
+    unsigned int maxLength = 0;
+    double ns = 0;
+};
+
+template<typename T>
+Result run(const Scenario &scenario) {
+    T buffer;
+    Result result;
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<unsigned int> stateDist(0, scenario.stateCount - 1);
+    std::uniform_int_distribution<unsigned int> sizeDist(1, scenario.maxInitialVertices / 2);
+    std::uniform_int_distribution<unsigned int> growthDist(1, std::max(1u, scenario.maxGrowth / 2));
+    std::vector<std::string> names;
+    std::vector<unsigned int> sizes;
+    for (unsigned int i = 0; i < scenario.stateCount; ++i) {
+        names.push_back("state" + std::to_string(i));
+        sizes.push_back(sizeDist(rng) * 2);
+        buffer.save(names.back(), sizes.back());
+    }
+    const auto replace = [&]() {
+        const unsigned int i = stateDist(rng);
+        sizes[i] = scenario.maxGrowth ? sizes[i] + growthDist(rng) * 2 : sizeDist(rng) * 2;
+        buffer.save(names[i], sizes[i]);
+    };
+    for (unsigned int i = 0; i < scenario.warmupReplacements; ++i)
+        replace();
+    const Stats warmStats = buffer.stats;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < scenario.replacements; ++i) {
+        replace();
+        result.maxLength = std::max(result.maxLength, buffer.getLength());
+    }
+    result.ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / scenario.replacements;
+    result.warmStats.grows = buffer.stats.grows - warmStats.grows;
+    result.warmStats.compactions = buffer.stats.compactions - warmStats.compactions;
+    result.warmStats.copied = buffer.stats.copied - warmStats.copied;
+    return result;
+}
+void print(const Scenario &scenario, const char *policy, const Result &r) {
+    printf("%-12s %-15s %10u %8u %12u %12llu %12.1f\n", scenario.name, policy, r.maxLength, r.warmStats.grows, r.warmStats.compactions,
+        static_cast<unsigned long long>(r.warmStats.copied), r.ns);
+}
+
+}  // namespace
+
+int main() {
+    printf("Statistics after warm-up\n");
+    printf("%-12s %-15s %10s %8s %12s %12s %12s\n", "Scenario", "Policy", "Max Length", "Grows", "Compactions", "Copied", "ns/Replace");
+    for (const Scenario &scenario : SCENARIOS) {
+        const Result result = run<Buffer>(scenario);
+        const Result legacy = run<LegacyBuffer>(scenario);
+        print(scenario, "RangeAllocator", result);
+        print(scenario, "Legacy", legacy);
+        // The scenario must fragment the legacy buffer, for the comparison to be meaningful
+        CHECK(legacy.warmStats.resizes() > 0);
+        CHECK(result.warmStats.resizes() < legacy.warmStats.resizes());
+        CHECK(result.warmStats.copied < legacy.warmStats.copied);
+        if (!scenario.maxGrowth) {
+            // Once warm, redraws must be satisfied from coalesced free space, rather than by resizing the buffer
+            CHECK(result.warmStats.resizes() == 0);
+        }
+    }
+    return CHECK_RESULT();
+}
@@ -0,0 +1,42 @@
+#ifndef TESTS_CHECK_H_
+#define TESTS_CHECK_H_
+
+#include <cstdio>
+
+/**
+ * Minimal assertion macros shared by the tests, so that they have no dependencies beyond the visualiser
+ * Failures are reported to stderr and counted, tests should return CHECK_RESULT() from main()
+ */
+namespace check {
+inline unsigned int &failures() {
+    static unsigned int count = 0;
+    return count;
+}
+}  // namespace check
+
+#define CHECK(cond)\
+    do {\
+        if (!(cond)) {\
+            fprintf(stderr, "%s(%d): CHECK(%s) failed.\n", __FILE__, __LINE__, #cond);\
+            ++check::failures();\
+        }\
+    } while (0)
+
+#define CHECK_THROWS(expr, exception_type)\
+    do {\
+        bool caught = false;\
+        try {\
+            expr;\
+        } catch (const exception_type &) {\
+            caught = true;\
+        }\
+        if (!caught) {\
+            fprintf(stderr, "%s(%d): CHECK_THROWS(%s, %s) failed.\n", __FILE__, __LINE__, #expr, #exception_type);\
+            ++check::failures();\
+        }\
+    } while (0)
+
+#define CHECK_RESULT()\
+    (check::failures() ? (fprintf(stderr, "%u check(s) failed.\n", check::failures()), 1) : 0)
+
+#endif  // TESTS_CHECK_H_
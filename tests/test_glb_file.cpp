@@ -0,0 +1,167 @@
+/**
+ * Tests of GLBFile against small hand-built binary glTF files
+ * A valid file must be parsed into accessors which point into its binary chunk,
+ * and malformed or unsupported files must be rejected with a ResourceError, rather than read out of bounds
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "check.h"
+#include "flamegpu/visualiser/Entity.h"
+#include "flamegpu/visualiser/model/GLBFile.h"
+#include "flamegpu/visualiser/util/VisException.h"
+
+using flamegpu::visualiser::Entity;
+using flamegpu::visualiser::GLBFile;
+using flamegpu::visualiser::ResourceError;
+
+namespace {
+
+const uint32_t GLB_MAGIC = 0x46546C67;  // "glTF"
+const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;  // "JSON"
+const uint32_t GLB_CHUNK_BIN = 0x004E4942;  // "BIN\0"
+
+/**
+ * A single triangle, with float positions and unsigned short indices
+ * Placeholders are substituted by tests, to produce malformed variants
+ */
+const char *const TRIANGLE_JSON = R"({
+"asset": { "version": "2.0" },
+"buffers": [ { "byteLength": 44 $URI } ],
+"bufferViews": [ { "buffer": 0, "byteOffset": 0, "byteLength": 36 }, { "buffer": 0, "byteOffset": 36, "byteLength": 6 } ],
+"accessors": [
+  { "bufferView": 0, "componentType": 5126, "count": $COUNT, "type": "VEC3" $SPARSE },
+  { "bufferView": 1, "componentType": 5123, "count": 3, "type": "SCALAR" } ],
+"materials": [ { "name": "red", "pbrMetallicRoughness": { "baseColorFactor": [ 1, 0, 0, 1 ], "metallicFactor": 0.5, "roughnessFactor": 0.25 } } ],
+"meshes": [ { "primitives": [ { "attributes": { "POSITION": 0 }, "indices": 1, "material": 0, "mode": $MODE } ] } ],
+"nodes": [ { "mesh": 0 } ],
+"scenes": [ { "nodes": [ 0 ] } ],
+"scene": 0
+})";
+
+std::string replace(std::string s, const std::string &from, const std::string &to) {
+    const size_t i = s.find(from);
+    if (i != std::string::npos)
+        s.replace(i, from.length(), to);
+    return s;
+}
+/**
+ * Returns the JSON of the triangle, with the named placeholder substituted and the remainder set to their valid values
+ */
+std::string triangleJson(const std::string &placeholder = "", const std::string &value = "") {
+    std::string json = replace(TRIANGLE_JSON, placeholder, value);
+    json = replace(json, "$URI", "");
+    json = replace(json, "$COUNT", "3");
+    json = replace(json, "$SPARSE", "");
+    return replace(json, "$MODE", "4");
+}
+std::vector<char> triangleBin(const uint16_t lastIndex = 2) {
+    const float positions[9] = { 0, 0, 0, 1, 0, 0, 0, 1, 0 };
+    const uint16_t indices[4] = { 0, 1, lastIndex, 0 };
+    std::vector<char> bin(sizeof(positions) + sizeof(indices));
+    memcpy(bin.data(), positions, sizeof(positions));
+    memcpy(bin.data() + sizeof(positions), indices, sizeof(indices));
+    return bin;
+}
+void appendU32(std::vector<char> &out, const uint32_t v) {
+    const char *c = reinterpret_cast<const char*>(&v);
+    out.insert(out.end(), c, c + sizeof(v));
+}
+void appendChunk(std::vector<char> &out, const uint32_t type, std::vector<char> data, const char padding) {
+    while (data.size() % 4)
+        data.push_back(padding);
+    appendU32(out, static_cast<uint32_t>(data.size()));
+    appendU32(out, type);
+    out.insert(out.end(), data.begin(), data.end());
+}
+/**
+ * Returns a GLB container of the JSON chunk (if not empty) followed by the binary chunk
+ */
+std::vector<char> buildGlb(const std::string &json, const std::vector<char> &bin, const uint32_t version = 2) {
+    std::vector<char> out;
+    appendU32(out, GLB_MAGIC);
+    appendU32(out, version);
+    appendU32(out, 0);
+    if (!json.empty())
+        appendChunk(out, GLB_CHUNK_JSON, std::vector<char>(json.begin(), json.end()), ' ');
+    appendChunk(out, GLB_CHUNK_BIN, bin, 0);
+    const uint32_t length = static_cast<uint32_t>(out.size());
+    memcpy(out.data() + 8, &length, sizeof(length));
+    return out;
+}
+void writeFile(const std::string &path, const std::vector<char> &bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), bytes.size());
+}
+
+}  // namespace
+
+int main() {
+    const std::string path = (std::filesystem::temp_directory_path() / "flamegpu_visualiser_test_glb_file.glb").string();
+
+    printf("A valid file is parsed\n");
+    writeFile(path, buildGlb(triangleJson(), triangleBin()));
+    {
+        const GLBFile glb(path);
+        CHECK(glb.primitives.size() == 1);
+        CHECK(glb.materials.size() == 1);
+        if (glb.primitives.size() == 1) {
+            const GLBFile::Primitive &p = glb.primitives[0];
+            CHECK(p.position.count == 3);
+            CHECK(p.position.components == 3);
+            CHECK(p.position.isPackedFloat());
+            CHECK(p.position.get(1, 0) == 1.0f);
+            CHECK(p.position.get(2, 1) == 1.0f);
+            CHECK(p.normal.data == nullptr);
+            CHECK(p.texcoord.data == nullptr);
+            CHECK(p.indices.count == 3);
+            CHECK(p.indices.componentSize() == 2);
+            CHECK(p.indices.getIndex(2) == 2);
+            CHECK(p.material == 0);
+        }
+        if (glb.materials.size() == 1) {
+            CHECK(glb.materials[0].name == "red");
+            CHECK(glb.materials[0].baseColor.r == 1.0f);
+            CHECK(glb.materials[0].baseColor.g == 0.0f);
+            CHECK(glb.materials[0].metallic == 0.5f);
+            CHECK(glb.materials[0].roughness == 0.25f);
+            CHECK(!glb.materials[0].blend);
+        }
+    }
+    {
+        const Entity::ModelData data(path);
+        CHECK(data.vn_count == 3);
+        CHECK(data.faces.count == 1);
+        CHECK(data.modelMax[0] == 1.0f);
+    }
+
+    const std::pair<const char*, std::vector<char>> malformed[] = {
+        { "an incorrect magic number", [] { std::vector<char> g = buildGlb(triangleJson(), triangleBin()); g[0] = 0; return g; }() },
+        { "glTF version 1", buildGlb(triangleJson(), triangleBin(), 1) },
+        { "a truncated chunk", [] { std::vector<char> g = buildGlb(triangleJson(), triangleBin()); g.resize(g.size() - 8); return g; }() },
+        { "no JSON chunk", buildGlb("", triangleBin()) },
+        { "malformed JSON", buildGlb(triangleJson().substr(0, 40), triangleBin()) },
+        { "an accessor exceeding its buffer view", buildGlb(triangleJson("$COUNT", "4"), triangleBin()) },
+        { "an out of range index", buildGlb(triangleJson(), triangleBin(3)) },
+        { "an external buffer", buildGlb(triangleJson("$URI", R"(, "uri": "triangle.bin")"), triangleBin()) },
+        { "a sparse accessor", buildGlb(triangleJson("$SPARSE", R"(, "sparse": { "count": 1 })"), triangleBin()) },
+        // Lines are not supported, so no meshes remain
+        { "no triangle meshes", buildGlb(triangleJson("$MODE", "1"), triangleBin()) },
+    };
+    for (const auto &[name, bytes] : malformed) {
+        printf("A file with %s is rejected\n", name);
+        writeFile(path, bytes);
+        CHECK_THROWS(const GLBFile glb(path), ResourceError);
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return CHECK_RESULT();
+}
@@ -0,0 +1,129 @@
+/**
+ * Tests of MeshOptimiser, over a grid mesh whose triangles have been shuffled
+ * Each reordering must preserve the mesh's triangles (and their winding), while improving the targeted cost
+ */
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "check.h"
+#include "flamegpu/visualiser/model/MeshOptimiser.h"
+
+using flamegpu::visualiser::MeshOptimiser;
+
+namespace {
+
+const unsigned int GRID_SIZE = 32;
+const unsigned int VERTEX_COUNT = (GRID_SIZE + 1) * (GRID_SIZE + 1);
+
+/**
+ * Triangulated N*N grid of quads, with its triangles in random order
+ */
+std::vector<unsigned int> shuffledGrid(std::vector<float> &positions) {
+    const unsigned int verts = GRID_SIZE + 1;
+    for (unsigned int y = 0; y < verts; ++y) {
+        for (unsigned int x = 0; x < verts; ++x)
+            positions.insert(positions.end(), { static_cast<float>(x), static_cast<float>(y), 0.01f * x * y });
+    }
+    std::vector<std::vector<unsigned int>> triangles;
+    for (unsigned int y = 0; y < GRID_SIZE; ++y) {
+        for (unsigned int x = 0; x < GRID_SIZE; ++x) {
+            const unsigned int a = y * verts + x, b = a + 1, c = a + verts, d = c + 1;
+            triangles.push_back({ a, b, c });
+            triangles.push_back({ b, d, c });
+        }
+    }
+    std::mt19937 rng(12345);
+    std::shuffle(triangles.begin(), triangles.end(), rng);
+    std::vector<unsigned int> indices;
+    for (const auto &t : triangles)
+        indices.insert(indices.end(), t.begin(), t.end());
+    return indices;
+}
+/**
+ * Returns the triangles in a canonical order, each rotated to begin with its lowest index so that winding is retained
+ */
+std::vector<std::vector<unsigned int>> canonicalTriangles(const std::vector<unsigned int> &indices) {
+    std::vector<std::vector<unsigned int>> triangles;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        std::vector<unsigned int> t = { indices[i], indices[i + 1], indices[i + 2] };
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+        triangles.push_back(t);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+float acmr(const std::vector<unsigned int> &indices) {
+    return MeshOptimiser::calculateACMR(indices.data(), indices.size(), VERTEX_COUNT);
+}
+
+}  // namespace
+
+int main() {
+    printf("ACMR\n");
+    {
+        const std::vector<unsigned int> one = { 0, 1, 2 };
+        CHECK(MeshOptimiser::calculateACMR(one.data(), one.size(), 3) == 3.0f);
+        // The second triangle reuses two cached vertices
+        const std::vector<unsigned int> two = { 0, 1, 2, 2, 1, 3 };
+        CHECK(MeshOptimiser::calculateACMR(two.data(), two.size(), 4) == 2.0f);
+        // A cache of 3 vertices has evicted vertex 0 by the final triangle
+        const std::vector<unsigned int> evicted = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+        CHECK(MeshOptimiser::calculateACMR(evicted.data(), evicted.size(), 6, 3) == 3.0f);
+    }
+
+    std::vector<float> positions;
+    std::vector<unsigned int> indices = shuffledGrid(positions);
+    const auto triangles = canonicalTriangles(indices);
+    const float shuffledAcmr = acmr(indices);
+
+    printf("Vertex cache\n");
+    MeshOptimiser::optimiseVertexCache(indices.data(), indices.size(), VERTEX_COUNT);
+    const float cacheAcmr = acmr(indices);
+    printf("  ACMR %.3f -> %.3f\n", shuffledAcmr, cacheAcmr);
+    CHECK(canonicalTriangles(indices) == triangles);
+    // A regular grid approaches 0.5, shuffled it is near 3
+    CHECK(shuffledAcmr > 2.0f);
+    CHECK(cacheAcmr < 1.0f);
+
+    printf("Vertex fetch\n");
+    const std::vector<unsigned int> beforeFetch = indices;
+    const std::vector<unsigned int> remap = MeshOptimiser::optimiseVertexFetch(indices.data(), indices.size(), VERTEX_COUNT);
+    CHECK(remap.size() == VERTEX_COUNT);
+    std::vector<unsigned int> sortedRemap = remap;
+    std::sort(sortedRemap.begin(), sortedRemap.end());
+    unsigned int notPermutation = 0, wrongRemap = 0, outOfOrder = 0, next = 0;
+    for (unsigned int i = 0; i < VERTEX_COUNT; ++i) {
+        if (sortedRemap[i] != i)
+            ++notPermutation;
+    }
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (remap[beforeFetch[i]] != indices[i])
+            ++wrongRemap;
+        // Vertices are numbered in order of first use
+        if (indices[i] > next)
+            ++outOfOrder;
+        else if (indices[i] == next)
+            ++next;
+    }
+    CHECK(notPermutation == 0);
+    CHECK(wrongRemap == 0);
+    CHECK(outOfOrder == 0);
+    // Renumbering does not change the order of triangles, so neither does it change the ACMR
+    CHECK(acmr(indices) == cacheAcmr);
+
+    printf("Overdraw\n");
+    // Vertices were renumbered, so positions must be too
+    std::vector<float> remappedPositions(positions.size());
+    for (unsigned int v = 0; v < VERTEX_COUNT; ++v)
+        std::copy_n(&positions[v * 3], 3, &remappedPositions[remap[v] * 3]);
+    const auto fetchTriangles = canonicalTriangles(indices);
+    const float threshold = 1.05f;
+    MeshOptimiser::optimiseOverdraw(indices.data(), indices.size(), remappedPositions.data(), 3, VERTEX_COUNT, threshold);
+    printf("  ACMR %.3f -> %.3f\n", cacheAcmr, acmr(indices));
+    CHECK(canonicalTriangles(indices) == fetchTriangles);
+    // Only complete clusters are held within threshold, the trailing partial cluster may exceed it, so allow a margin
+    CHECK(acmr(indices) <= cacheAcmr * threshold + 0.05f);
+    return CHECK_RESULT();
+}
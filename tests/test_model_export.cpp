@@ -0,0 +1,142 @@
+/**
+ * Validation of the binary exports which Entity::ModelData writes after parsing an .obj model
+ * An export must only be imported if it is intact, and matches its source model and the current loader
+ * Otherwise it must be rejected, the source parsed instead, and the export regenerated
+ */
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "check.h"
+#include "ModelExport.h"
+#include "flamegpu/visualiser/Entity.h"
+#include "flamegpu/visualiser/util/VisException.h"
+
+using flamegpu::visualiser::Entity;
+using flamegpu::visualiser::ResourceError;
+
+namespace {
+
+// Layout of the start of Entity::ExportHeader
+const size_t FILE_TYPE_FLAG_OFFSET = 0;
+const size_t VERSION_FLAG_OFFSET = 1;
+const size_t LOADER_VERSION_OFFSET = 4;
+const unsigned char FILE_TYPE_VERSION = 2;
+
+/**
+ * Writes a quad of two triangles, with positions, texcoords and normals
+ * @param right x coordinate of the quad's right edge, so that tests can change the source with or without changing its size
+ */
+void writeQuad(const std::string &path, const char *right) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << "v 0.0 0.0 0.0\nv " << right << " 0.0 0.0\nv " << right << " 1.0 0.0\nv 0.0 1.0 0.0\n";
+    file << "vt 0.0 0.0\nvt 1.0 0.0\nvt 1.0 1.0\nvt 0.0 1.0\n";
+    file << "vn 0.0 0.0 1.0\n";
+    file << "f 1/1/1 2/2/1 3/3/1\nf 1/1/1 3/3/1 4/4/1\n";
+}
+std::vector<char> readFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+void writeFile(const std::string &path, const std::vector<char> &bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), bytes.size());
+}
+/**
+ * Loads the model, and checks whether it was imported, and that its geometry matches the source
+ * @param imported True if the load is expected to import the export, rather than parse the source
+ * @param right The x coordinate of the quad's right edge in the source
+ */
+void checkLoad(const std::string &modelPath, const bool imported, const float right) {
+    const Entity::ModelData data(modelPath);
+    CHECK(static_cast<bool>(data.mapping) == imported);
+    CHECK(data.vn_count == 4);
+    CHECK(data.faces.count == 2);
+    CHECK(data.modelMax[0] == right);
+}
+
+}  // namespace
+
+int main() {
+    // Exports record whether they were optimised, so those written with the other setting are rejected
+    Entity::setOptimiseModels(false);
+    const std::string modelPath = (std::filesystem::temp_directory_path() / "flamegpu_visualiser_test_model_export.obj").string();
+    const std::string exportPath = modelExportPath(modelPath);
+    removeModelExport(modelPath);
+    writeQuad(modelPath, "1.0");
+    printf("Parsing a model writes an export, which subsequent loads import\n");
+    checkLoad(modelPath, false, 1.0f);
+    // This also ensures that ModelExport.h agrees with Entity on where exports are written
+    CHECK(std::filesystem::exists(exportPath));
+    checkLoad(modelPath, true, 1.0f);
+    const std::vector<char> validExport = readFile(exportPath);
+    CHECK(validExport.size() > LOADER_VERSION_OFFSET);
+    if (validExport.size() <= LOADER_VERSION_OFFSET)
+        return CHECK_RESULT();
+    CHECK(validExport[VERSION_FLAG_OFFSET] == FILE_TYPE_VERSION);
+
+    printf("Exports of a modified source are rejected and regenerated\n");
+    // Same size, so only the content hash can detect the change
+    writeQuad(modelPath, "2.0");
+    checkLoad(modelPath, false, 2.0f);
+    checkLoad(modelPath, true, 2.0f);
+    writeQuad(modelPath, "3.25");
+    checkLoad(modelPath, false, 3.25f);
+    checkLoad(modelPath, true, 3.25f);
+    // Restore the source of validExport
+    writeQuad(modelPath, "1.0");
+    checkLoad(modelPath, false, 1.0f);
+    CHECK(readFile(exportPath) == validExport);
+
+    const std::pair<const char*, std::function<void(std::vector<char>&)>> corruptions[] = {
+        { "incorrect file type flag", [](std::vector<char> &e) { e[FILE_TYPE_FLAG_OFFSET] = 0; } },
+        { "newer format version", [](std::vector<char> &e) { e[VERSION_FLAG_OFFSET] = FILE_TYPE_VERSION + 1; } },
+        // Version 1 exports do not record their source, so can not be validated against it
+        { "version 1 format", [](std::vector<char> &e) { e[VERSION_FLAG_OFFSET] = 1; } },
+        { "different loader version", [](std::vector<char> &e) { ++e[LOADER_VERSION_OFFSET]; } },
+        { "missing trailing file type flag", [](std::vector<char> &e) { e.back() = 0; } },
+        { "truncated data", [](std::vector<char> &e) { e.resize(e.size() / 2); } },
+    };
+    for (const auto &[name, corrupt] : corruptions) {
+        printf("Exports with %s are rejected and regenerated\n", name);
+        std::vector<char> bytes = validExport;
+        corrupt(bytes);
+        writeFile(exportPath, bytes);
+        checkLoad(modelPath, false, 1.0f);
+        CHECK(readFile(exportPath) == validExport);
+        checkLoad(modelPath, true, 1.0f);
+    }
+
+    printf("Exports written with a different optimisation setting are rejected and regenerated\n");
+    Entity::setOptimiseModels(true);
+    checkLoad(modelPath, false, 1.0f);
+    {
+        const Entity::ModelData data(modelPath);
+        CHECK(data.mapping);
+        CHECK(data.optimised);
+    }
+    Entity::setOptimiseModels(false);
+    checkLoad(modelPath, false, 1.0f);
+    CHECK(readFile(exportPath) == validExport);
+
+    printf("Exports loaded directly are used without a source, but must be intact\n");
+    {
+        const Entity::ModelData data(exportPath);
+        CHECK(data.mapping);
+        CHECK(data.faces.count == 2);
+    }
+    std::vector<char> truncated = validExport;
+    truncated.resize(truncated.size() / 2);
+    writeFile(exportPath, truncated);
+    CHECK_THROWS(const Entity::ModelData data(exportPath), ResourceError);
+
+    removeModelExport(modelPath);
+    std::error_code ec;
+    std::filesystem::remove(modelPath, ec);
+    return CHECK_RESULT();
+}
@@ -0,0 +1,121 @@
+/**
+ * Conformance of the .obj loader against the original parser, for each stock .obj model
+ * Both the parsed model, and the binary export written by parsing, are compared
+ * Vertices are compared per face corner, so that the comparison does not depend on the order in which unique vertices are numbered
+ */
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "LegacyObjLoader.h"
+#include "ModelExport.h"
+#include "flamegpu/visualiser/config/Stock.h"
+#include "flamegpu/visualiser/Entity.h"
+#include "flamegpu/visualiser/util/Resources.h"
+
+using flamegpu::visualiser::Entity;
+using flamegpu::visualiser::Resources;
+namespace Models = flamegpu::visualiser::Stock::Models;
+
+namespace {
+
+const float TOLERANCE = 1e-5f;
+const char *const STOCK_OBJ_MODELS[] = {
+    // SPHERE and ICOSPHERE are now generated by PrimitiveMesh, the .obj models they replaced remain embedded resources
+    "resources/sphere.obj",
+    "resources/icosphere.obj",
+    Models::CUBE_SMOOTH.modelPath,
+    Models::TEAPOT.modelPath,
+    Models::STUNTPLANE.modelPath,
+    Models::PYRAMID.modelPath,
+    Models::ARROWHEAD.modelPath,
+    Models::PEDESTRIAN.modelPathA,
+    Models::PEDESTRIAN.modelPathB,
+};
+
+bool approxEqual(const float a, const float b) {
+    return std::fabs(a - b) <= TOLERANCE * std::fmax(1.0f, std::fabs(b));
+}
+/**
+ * Compares the attribute of the vertex at each face corner
+ * @return The number of mismatched components
+ */
+unsigned int compareAttribute(const Entity::ModelData &data, const flamegpu::visualiser::Shaders::VertexAttributeDetail &attr, const LegacyObjModel &legacy, const std::vector<float> &legacyAttr, const unsigned int legacyComponents) {
+    const unsigned int *faces = static_cast<const unsigned int*>(data.faces.data);
+    const float *values = static_cast<const float*>(attr.data);
+    unsigned int mismatches = 0;
+    for (size_t i = 0; i < legacy.faces.size(); ++i) {
+        for (unsigned int k = 0; k < legacyComponents; ++k) {
+            if (!approxEqual(values[faces[i] * attr.components + k], legacyAttr[legacy.faces[i] * legacyComponents + k]))
+                ++mismatches;
+        }
+    }
+    return mismatches;
+}
+void compare(const char *label, const Entity::ModelData &data, const LegacyObjModel &legacy) {
+    printf("%s %s: %u vertices, %u faces\n", data.modelPath.c_str(), label, data.vn_count, data.faces.count);
+    CHECK(data.vn_count == legacy.vn_count);
+    CHECK(data.faces.count * data.faces.components == legacy.faces.size());
+    CHECK(data.positions.count == legacy.vn_count);
+    CHECK(data.positions.components == legacy.positionComponents);
+    CHECK((data.normals.count != 0) == !legacy.normals.empty());
+    CHECK((data.texcoords.count != 0) == !legacy.texcoords.empty());
+    CHECK((data.colors.count != 0) == !legacy.colors.empty());
+    if (data.vn_count != legacy.vn_count || data.faces.count * data.faces.components != legacy.faces.size())
+        return;
+    // Face indices must be in range before attributes can be compared
+    const unsigned int *faces = static_cast<const unsigned int*>(data.faces.data);
+    unsigned int outOfRange = 0;
+    for (size_t i = 0; i < legacy.faces.size(); ++i) {
+        if (faces[i] >= data.vn_count)
+            ++outOfRange;
+    }
+    CHECK(outOfRange == 0);
+    if (outOfRange)
+        return;
+    CHECK(compareAttribute(data, data.positions, legacy, legacy.positions, legacy.positionComponents) == 0);
+    if (data.normals.count && !legacy.normals.empty()) {
+        CHECK(data.normals.components == 3);
+        CHECK(compareAttribute(data, data.normals, legacy, legacy.normals, 3) == 0);
+    }
+    if (data.texcoords.count && !legacy.texcoords.empty()) {
+        CHECK(data.texcoords.components == legacy.texcoordComponents);
+        CHECK(compareAttribute(data, data.texcoords, legacy, legacy.texcoords, legacy.texcoordComponents) == 0);
+    }
+    if (data.colors.count && !legacy.colors.empty()) {
+        CHECK(data.colors.components == legacy.colorComponents);
+        CHECK(compareAttribute(data, data.colors, legacy, legacy.colors, legacy.colorComponents) == 0);
+    }
+    for (int k = 0; k < 3; ++k) {
+        CHECK(approxEqual(data.modelMin[k], legacy.modelMin[k]));
+        CHECK(approxEqual(data.modelMax[k], legacy.modelMax[k]));
+    }
+}
+
+}  // namespace
+
+int main() {
+    // Optimisation reorders faces, so corners could no longer be compared one to one
+    Entity::setOptimiseModels(false);
+    for (const char *modelPath : STOCK_OBJ_MODELS) {
+        LegacyObjModel legacy;
+        const bool legacyLoaded = loadLegacyObj(Resources::locateFile(modelPath), legacy);
+        CHECK(legacyLoaded);
+        if (!legacyLoaded)
+            continue;
+        removeModelExport(modelPath);
+        {
+            const Entity::ModelData parsed(modelPath);
+            compare("(parsed)", parsed, legacy);
+        }
+        {
+            // Parsing wrote an export, which this load should import
+            const Entity::ModelData imported(modelPath);
+            compare("(imported)", imported, legacy);
+        }
+        removeModelExport(modelPath);
+    }
+    return CHECK_RESULT();
+}
@@ -0,0 +1,151 @@
+/**
+ * Tests of the shapes generated by PrimitiveMesh, and of the model paths which name them
+ * Each shape is checked for its expected vertex and face counts, in range indices, unit normals,
+ * counter-clockwise winding (relative to its normals) and its [-1, 1] bounds
+ */
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include "check.h"
+#include "flamegpu/visualiser/config/Stock.h"
+#include "flamegpu/visualiser/Entity.h"
+#include "flamegpu/visualiser/model/PrimitiveMesh.h"
+#include "flamegpu/visualiser/util/VisException.h"
+
+using flamegpu::visualiser::Entity;
+using flamegpu::visualiser::PrimitiveMesh;
+using flamegpu::visualiser::ResourceError;
+namespace Models = flamegpu::visualiser::Stock::Models;
+
+namespace {
+
+const float TOLERANCE = 1e-5f;
+
+struct Expected {
+    const char *name;
+    PrimitiveMesh::Shape shape;
+    unsigned int detailA;
+    unsigned int detailB;
+    unsigned int vertices;
+    unsigned int faces;
+};
+const unsigned int D = PrimitiveMesh::DEFAULT_DETAIL;
+const Expected SHAPES[] = {
+    // Sphere: (stacks + 1) * (slices + 1) vertices, 2 * slices * (stacks - 1) faces
+    { "sphere", PrimitiveMesh::Sphere, D, D, 17 * 33, 2 * 32 * 15 },
+    { "sphere 8:4", PrimitiveMesh::Sphere, 8, 4, 5 * 9, 2 * 8 * 3 },
+    // Clamped to 3:2
+    { "sphere 1:1", PrimitiveMesh::Sphere, 1, 1, 3 * 4, 2 * 3 * 1 },
+    // Icosphere: 10 * 4^n + 2 vertices, 20 * 4^n faces
+    { "icosphere", PrimitiveMesh::Icosphere, D, D, 42, 80 },
+    { "icosphere 0", PrimitiveMesh::Icosphere, 0, D, 12, 20 },
+    { "icosphere 3", PrimitiveMesh::Icosphere, 3, D, 642, 1280 },
+    { "cube", PrimitiveMesh::Cube, D, D, 24, 12 },
+    // Cylinder: 4n + 4 vertices, 4n faces
+    { "cylinder", PrimitiveMesh::Cylinder, D, D, 132, 128 },
+    { "cylinder 6", PrimitiveMesh::Cylinder, 6, D, 28, 24 },
+    // Cone: 3n + 3 vertices, 2n faces
+    { "cone", PrimitiveMesh::Cone, D, D, 99, 64 },
+    // Arrow: 7n + 5 vertices, 6n faces
+    { "arrow", PrimitiveMesh::Arrow, D, D, 117, 96 },
+    // Clamped to 3
+    { "arrow 1", PrimitiveMesh::Arrow, 1, D, 26, 18 },
+    { "quad", PrimitiveMesh::Quad, D, D, 4, 2 },
+    // Disc: n + 1 vertices, n faces
+    { "disc", PrimitiveMesh::Disc, D, D, 33, 32 },
+};
+
+void checkMesh(const char *name, const PrimitiveMesh &mesh, const unsigned int vertices, const unsigned int faces) {
+    printf("%s: %u vertices, %u faces\n", name, mesh.vertexCount(), static_cast<unsigned int>(mesh.indices.size() / 3));
+    CHECK(mesh.vertexCount() == vertices);
+    CHECK(mesh.indices.size() == faces * 3);
+    CHECK(mesh.normals.size() == mesh.positions.size());
+    CHECK(mesh.texcoords.empty() || mesh.texcoords.size() == vertices * 2);
+    unsigned int outOfRange = 0, outOfBounds = 0, nonUnitNormals = 0, reversed = 0;
+    for (const unsigned int i : mesh.indices) {
+        if (i >= mesh.vertexCount())
+            ++outOfRange;
+    }
+    CHECK(outOfRange == 0);
+    if (outOfRange)
+        return;
+    for (unsigned int v = 0; v < mesh.vertexCount(); ++v) {
+        const float *p = &mesh.positions[v * 3], *n = &mesh.normals[v * 3];
+        for (unsigned int k = 0; k < 3; ++k) {
+            if (std::fabs(p[k]) > 1.0f + TOLERANCE)
+                ++outOfBounds;
+        }
+        if (std::fabs(std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) - 1.0f) > TOLERANCE)
+            ++nonUnitNormals;
+    }
+    // Front faces are counter-clockwise, so each face's geometric normal must agree with its vertex normals
+    for (size_t f = 0; f < mesh.indices.size(); f += 3) {
+        const float *a = &mesh.positions[mesh.indices[f] * 3];
+        const float *b = &mesh.positions[mesh.indices[f + 1] * 3];
+        const float *c = &mesh.positions[mesh.indices[f + 2] * 3];
+        const float ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        const float ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        const float cross[3] = { ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0] };
+        float dot = 0;
+        for (unsigned int corner = 0; corner < 3; ++corner) {
+            const float *n = &mesh.normals[mesh.indices[f + corner] * 3];
+            dot += cross[0] * n[0] + cross[1] * n[1] + cross[2] * n[2];
+        }
+        if (dot <= 0)
+            ++reversed;
+    }
+    CHECK(outOfBounds == 0);
+    CHECK(nonUnitNormals == 0);
+    CHECK(reversed == 0);
+}
+
+}  // namespace
+
+int main() {
+    for (const Expected &e : SHAPES) {
+        checkMesh(e.name, PrimitiveMesh(e.shape, e.detailA, e.detailB), e.vertices, e.faces);
+    }
+    // Stock models which replaced .obj models keep their tessellation
+    checkMesh(Models::SPHERE.modelPath, PrimitiveMesh(Models::SPHERE.modelPath), 17 * 33, 960);
+    checkMesh(Models::ICOSPHERE.modelPath, PrimitiveMesh(Models::ICOSPHERE.modelPath), 42, 80);
+    checkMesh(Models::CUBE.modelPath, PrimitiveMesh(Models::CUBE.modelPath), 24, 12);
+    // Only the icosphere shares vertices between faces, so has no texture mapping
+    CHECK(PrimitiveMesh(PrimitiveMesh::Icosphere).texcoords.empty());
+    CHECK(!PrimitiveMesh(PrimitiveMesh::Sphere).texcoords.empty());
+
+    printf("Model paths\n");
+    CHECK(PrimitiveMesh::isPrimitivePath("primitive:cube"));
+    CHECK(!PrimitiveMesh::isPrimitivePath("resources/cube.obj"));
+    CHECK(!PrimitiveMesh::isPrimitivePath("primitive"));
+    CHECK(PrimitiveMesh("primitive:sphere:8").vertexCount() == PrimitiveMesh(PrimitiveMesh::Sphere, 8).vertexCount());
+    CHECK(PrimitiveMesh("primitive:sphere:8:4").vertexCount() == 5 * 9);
+    CHECK_THROWS(PrimitiveMesh("resources/cube.obj"), ResourceError);
+    CHECK_THROWS(PrimitiveMesh("primitive:"), ResourceError);
+    CHECK_THROWS(PrimitiveMesh("primitive:dodecahedron"), ResourceError);
+    CHECK_THROWS(PrimitiveMesh("primitive:sphere:8:4:2"), ResourceError);
+    CHECK_THROWS(PrimitiveMesh("primitive:sphere:"), ResourceError);
+    CHECK_THROWS(PrimitiveMesh("primitive:sphere:eight"), ResourceError);
+    CHECK_THROWS(PrimitiveMesh("primitive:sphere:8x"), ResourceError);
+    CHECK_THROWS(PrimitiveMesh("primitive:sphere:-8"), ResourceError);
+
+    printf("Entity::ModelData\n");
+    {
+        const Entity::ModelData data(Models::CUBE.modelPath);
+        CHECK(data.vn_count == 24);
+        CHECK(data.faces.count == 12);
+        CHECK(data.normals.count == 24);
+        CHECK(data.texcoords.count == 24);
+        for (int k = 0; k < 3; ++k) {
+            CHECK(data.modelMin[k] == -1.0f);
+            CHECK(data.modelMax[k] == 1.0f);
+        }
+    }
+    {
+        const Entity::ModelData data(Models::ICOSPHERE.modelPath);
+        CHECK(data.vn_count == 42);
+        CHECK(data.faces.count == 80);
+        CHECK(data.texcoords.count == 0);
+    }
+    return CHECK_RESULT();
+}
@@ -0,0 +1,263 @@
+/**
+ * Tests for RangeAllocator, which manages the ranges of Draw's vertex buffers
+ */
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "check.h"
+#include "flamegpu/visualiser/util/RangeAllocator.h"
+#include "flamegpu/visualiser/util/VisException.h"
+
+using flamegpu::visualiser::RangeAllocator;
+using flamegpu::visualiser::VisAssert;
+
+namespace {
+
+void testConstruct() {
+    RangeAllocator a(100);
+    CHECK(a.getLength() == 100);
+    CHECK(a.getFreeCount() == 100);
+    CHECK(a.getFreeRangeCount() == 1);
+    CHECK(a.getLargestFree() == 100);
+    // Empty allocations always succeed, without consuming space
+    CHECK(a.allocate(0) == 0);
+    CHECK(a.getFreeCount() == 100);
+    CHECK(a.allocate(101) == RangeAllocator::INVALID);
+    RangeAllocator empty;
+    CHECK(empty.getLength() == 0);
+    CHECK(empty.getFreeRangeCount() == 0);
+    CHECK(empty.allocate(1) == RangeAllocator::INVALID);
+}
+void testBestFit() {
+    RangeAllocator a(100);
+    CHECK(a.allocate(10) == 0);
+    CHECK(a.allocate(20) == 10);
+    CHECK(a.allocate(5) == 30);
+    CHECK(a.allocate(30) == 35);
+    CHECK(a.allocate(5) == 65);
+    // Free ranges: [10, 30), [35, 65), [70, 100)
+    a.release(10, 20);
+    a.release(35, 30);
+    CHECK(a.getFreeRangeCount() == 3);
+    CHECK(a.getFreeCount() == 80);
+    // The smallest sufficient range is used, rather than the first or largest
+    CHECK(a.allocate(15) == 10);
+    CHECK(a.getFreeCount() == 65);
+    // Equal sized ranges are taken lowest offset first
+    CHECK(a.allocate(30) == 35);
+    CHECK(a.allocate(30) == 70);
+    // Only the 5 element remainder of [10, 30) is left
+    CHECK(a.getFreeRangeCount() == 1);
+    CHECK(a.getLargestFree() == 5);
+    CHECK(a.allocate(6) == RangeAllocator::INVALID);
+    CHECK(a.allocate(5) == 25);
+    CHECK(a.getFreeCount() == 0);
+    CHECK(a.getFreeRangeCount() == 0);
+}
+void testCoalesce() {
+    // With the previous free range
+    {
+        RangeAllocator a(30);
+        a.allocate(10);
+        a.allocate(10);
+        a.allocate(10);
+        a.release(0, 10);
+        a.release(10, 10);
+        CHECK(a.getFreeRangeCount() == 1);
+        CHECK(a.getLargestFree() == 20);
+        CHECK(a.allocate(20) == 0);
+    }
+    // With the next free range
+    {
+        RangeAllocator a(30);
+        a.allocate(10);
+        a.allocate(10);
+        a.allocate(10);
+        a.release(20, 10);
+        a.release(10, 10);
+        CHECK(a.getFreeRangeCount() == 1);
+        CHECK(a.getLargestFree() == 20);
+        CHECK(a.allocate(20) == 10);
+    }
+    // With both, filling the gap between them
+    {
+        RangeAllocator a(30);
+        a.allocate(10);
+        a.allocate(10);
+        a.allocate(10);
+        a.release(0, 10);
+        a.release(20, 10);
+        CHECK(a.getFreeRangeCount() == 2);
+        a.release(10, 10);
+        CHECK(a.getFreeRangeCount() == 1);
+        CHECK(a.getLargestFree() == 30);
+        CHECK(a.getFreeCount() == 30);
+    }
+    // Non adjacent ranges are not merged
+    {
+        RangeAllocator a(30);
+        a.allocate(10);
+        a.allocate(10);
+        a.allocate(10);
+        a.release(0, 5);
+        a.release(25, 5);
+        CHECK(a.getFreeRangeCount() == 2);
+        CHECK(a.getLargestFree() == 5);
+    }
+}
+void testReleaseAsserts() {
+    RangeAllocator a(30);
+    a.allocate(10);
+    a.allocate(10);
+    a.release(0, 10);
+    // Free ranges: [0, 10), [20, 30)
+    // Out of bounds
+    CHECK_THROWS(a.release(25, 10), VisAssert);
+    CHECK_THROWS(a.release(31, 1), VisAssert);
+    CHECK_THROWS(a.release(10, UINT_MAX), VisAssert);
+    // Double release
+    CHECK_THROWS(a.release(0, 10), VisAssert);
+    // Overlapping the end of the previous free range
+    CHECK_THROWS(a.release(5, 10), VisAssert);
+    // Overlapping the start of the next free range
+    CHECK_THROWS(a.release(15, 10), VisAssert);
+    // Enclosing a free range
+    CHECK_THROWS(a.release(0, 30), VisAssert);
+    // Adjacent to the next free range, but overlapping the previous
+    CHECK_THROWS(a.release(5, 15), VisAssert);
+    // Failed releases leave the allocator unchanged
+    CHECK(a.getFreeCount() == 20);
+    CHECK(a.getFreeRangeCount() == 2);
+    a.release(10, 10);
+    CHECK(a.getFreeCount() == 30);
+    CHECK(a.getFreeRangeCount() == 1);
+}
+void testGrow() {
+    // Growing a full allocator appends a free range
+    {
+        RangeAllocator a(10);
+        CHECK(a.allocate(10) == 0);
+        a.grow(20);
+        CHECK(a.getLength() == 20);
+        CHECK(a.getFreeCount() == 10);
+        CHECK(a.allocate(10) == 10);
+    }
+    // The appended range is coalesced with a trailing free range
+    {
+        RangeAllocator a(10);
+        CHECK(a.allocate(5) == 0);
+        a.grow(20);
+        CHECK(a.getFreeRangeCount() == 1);
+        CHECK(a.getLargestFree() == 15);
+        // Growing to the same length is a no-op
+        a.grow(20);
+        CHECK(a.getFreeCount() == 15);
+        CHECK_THROWS(a.grow(19), VisAssert);
+        CHECK(a.getLength() == 20);
+    }
+}
+void testReset() {
+    RangeAllocator a(50);
+    a.allocate(10);
+    a.allocate(10);
+    a.allocate(10);
+    a.release(10, 10);
+    CHECK(a.getFreeRangeCount() == 2);
+    // After compaction, the used elements are packed at the start
+    a.reset(50, 20);
+    CHECK(a.getLength() == 50);
+    CHECK(a.getFreeCount() == 30);
+    CHECK(a.getFreeRangeCount() == 1);
+    CHECK(a.allocate(30) == 20);
+    // Reset may also change the length
+    a.reset(100, 100);
+    CHECK(a.getLength() == 100);
+    CHECK(a.getFreeCount() == 0);
+    CHECK(a.getFreeRangeCount() == 0);
+    a.reset(100, 0);
+    CHECK(a.getFreeCount() == 100);
+    CHECK_THROWS(a.reset(10, 20), VisAssert);
+}
+/**
+ * Maximal runs of free elements, as (offset, count), in order of offset
+ */
+std::vector<std::pair<unsigned int, unsigned int>> freeRuns(const std::vector<bool> &used) {
+    std::vector<std::pair<unsigned int, unsigned int>> runs;
+    for (unsigned int i = 0; i < used.size(); ++i) {
+        if (used[i])
+            continue;
+        if (!runs.empty() && runs.back().first + runs.back().second == i)
+            ++runs.back().second;
+        else
+            runs.push_back({ i, 1 });
+    }
+    return runs;
+}
+void testRandomised() {
+    // Random allocations and releases, checked against a reference bitmap of used elements
+    const unsigned int LENGTH = 2048;
+    RangeAllocator a(LENGTH);
+    std::vector<bool> used(LENGTH, false);
+    std::vector<std::pair<unsigned int, unsigned int>> live;
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<unsigned int> countDist(1, 64);
+    unsigned int wrongOffset = 0, overlaps = 0, wrongState = 0;
+    for (unsigned int step = 0; step < 20000; ++step) {
+        if (live.empty() || rng() % 2) {
+            const unsigned int count = countDist(rng);
+            // Best fit: the smallest sufficient run, the lowest offset of those
+            unsigned int expected = RangeAllocator::INVALID, expectedCount = UINT_MAX;
+            for (const auto &run : freeRuns(used)) {
+                if (run.second >= count && run.second < expectedCount) {
+                    expected = run.first;
+                    expectedCount = run.second;
+                }
+            }
+            const unsigned int offset = a.allocate(count);
+            if (offset != expected)
+                ++wrongOffset;
+            if (offset != RangeAllocator::INVALID) {
+                for (unsigned int i = offset; i < std::min(offset + count, LENGTH); ++i) {
+                    if (used[i])
+                        ++overlaps;
+                    used[i] = true;
+                }
+                live.push_back({ offset, count });
+            }
+        } else {
+            const size_t i = rng() % live.size();
+            a.release(live[i].first, live[i].second);
+            std::fill_n(used.begin() + live[i].first, live[i].second, false);
+            live[i] = live.back();
+            live.pop_back();
+        }
+        // Free space is fully coalesced, so free ranges correspond to the maximal runs
+        const auto runs = freeRuns(used);
+        unsigned int freeCount = 0, largest = 0;
+        for (const auto &run : runs) {
+            freeCount += run.second;
+            largest = std::max(largest, run.second);
+        }
+        if (a.getFreeCount() != freeCount || a.getFreeRangeCount() != runs.size() || a.getLargestFree() != largest)
+            ++wrongState;
+    }
+    CHECK(wrongOffset == 0);
+    CHECK(overlaps == 0);
+    CHECK(wrongState == 0);
+}
+
+}  // namespace
+
+int main() {
+    testConstruct();
+    testBestFit();
+    testCoalesce();
+    testReleaseAsserts();
+    testGrow();
+    testReset();
+    testRandomised();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,100 @@
+/**
+ * Tests of RateLimiter's pacing
+ * Sleeps may overrun on a loaded machine, so timing checks only bound how fast the limiter may run, and are generous
+ * when bounding how slow it may run
+ */
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "check.h"
+#include "flamegpu/visualiser/util/RateLimiter.h"
+
+using flamegpu::visualiser::RateLimiter;
+
+namespace {
+
+/**
+ * @return Seconds taken by count calls to wait(), after the first which starts the schedule
+ */
+double timeWaits(RateLimiter &limiter, const unsigned int count) {
+    const RateLimiter::clock::time_point start = limiter.wait();
+    RateLimiter::clock::time_point end = start;
+    for (unsigned int i = 0; i < count; ++i)
+        end = limiter.wait();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+}  // namespace
+
+int main() {
+    printf("Rates\n");
+    RateLimiter limiter;
+    CHECK(limiter.getRate() == 0);
+    limiter.setRate(60);
+    CHECK(limiter.getRate() == 60);
+    limiter.setRate(-1);
+    CHECK(limiter.getRate() == 0);
+    CHECK(RateLimiter(30).getRate() == 30);
+
+    printf("Unlimited waits return immediately\n");
+    {
+        RateLimiter unlimited(0);
+        const double seconds = timeWaits(unlimited, 100000);
+        printf("  100000 waits: %.4fs\n", seconds);
+        CHECK(seconds < 1.0);
+    }
+
+    printf("The average rate is held\n");
+    for (const double rate : { 200.0, 1000.0 }) {
+        RateLimiter paced(rate);
+        const unsigned int count = static_cast<unsigned int>(rate / 2);
+        const double seconds = timeWaits(paced, count);
+        printf("  %.0f/s: %u waits in %.4fs (expected %.4fs)\n", rate, count, seconds, count / rate);
+        // Waits never end early, each is scheduled exactly one period after the previous
+        CHECK(seconds >= count / rate);
+        CHECK(seconds < 2 * count / rate);
+    }
+
+    printf("Brief lateness is caught up\n");
+    {
+        // 10ms period, 20ms lag allowance
+        RateLimiter paced(100);
+        const RateLimiter::clock::time_point start = paced.wait();
+        // Due at start + 10ms, so the next wait is 5ms late, and should keep to the schedule
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+        paced.wait();
+        const RateLimiter::clock::time_point end = paced.wait();
+        const double seconds = std::chrono::duration<double>(end - start).count();
+        printf("  2 waits with a 5ms stall: %.4fs\n", seconds);
+        // Back on schedule, the second wait ends at start + 20ms rather than 25ms
+        CHECK(seconds >= 0.02);
+        if (seconds >= 0.025)
+            printf("  warning: the schedule was not caught up, likely due to machine load\n");
+    }
+
+    printf("Long stalls restart the schedule\n");
+    {
+        RateLimiter paced(100);
+        const RateLimiter::clock::time_point start = paced.wait();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // Far behind, so this returns immediately and restarts the schedule, rather than bursting to catch up
+        const RateLimiter::clock::time_point restart = paced.wait();
+        const RateLimiter::clock::time_point end = paced.wait();
+        const double gap = std::chrono::duration<double>(end - restart).count();
+        printf("  after a 100ms stall, the next wait took %.4fs\n", gap);
+        CHECK(std::chrono::duration<double>(restart - start).count() >= 0.1);
+        CHECK(gap >= 0.01);
+    }
+
+    printf("Changing the rate restarts the schedule\n");
+    {
+        RateLimiter paced(1000);
+        timeWaits(paced, 10);
+        paced.setRate(50);
+        const double seconds = timeWaits(paced, 5);
+        printf("  5 waits at 50/s: %.4fs\n", seconds);
+        CHECK(seconds >= 5 / 50.0);
+    }
+    return CHECK_RESULT();
+}
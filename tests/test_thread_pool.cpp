@@ -0,0 +1,106 @@
+/**
+ * Tests of ThreadPool's task submission and parallelFor()
+ * parallelFor() may be called from within a task on the same pool (as by preloads parsing large models),
+ * so nested use is checked with more tasks than workers, which would deadlock if callers waited on queued iterations
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "check.h"
+#include "flamegpu/visualiser/util/ThreadPool.h"
+
+using flamegpu::visualiser::ThreadPool;
+
+namespace {
+
+const size_t ITERATIONS = 10000;
+
+/**
+ * Waits for the future, failing immediately if it appears to have deadlocked, as the pool could not then be destroyed
+ */
+template<typename T>
+void waitOrExit(const std::future<T> &f) {
+    if (f.wait_for(std::chrono::seconds(60)) != std::future_status::ready) {
+        fprintf(stderr, "Timed out waiting for a task, the pool has deadlocked.\n");
+        std::_Exit(EXIT_FAILURE);
+    }
+}
+/**
+ * @return The number of indices in [0, ITERATIONS) which were not visited exactly once
+ */
+unsigned int miscounted(const std::vector<std::atomic<unsigned int>> &visits) {
+    unsigned int rtn = 0;
+    for (const auto &v : visits) {
+        if (v != 1)
+            ++rtn;
+    }
+    return rtn;
+}
+
+}  // namespace
+
+int main() {
+    ThreadPool pool(4);
+    CHECK(pool.size() == 4);
+    CHECK(&ThreadPool::get() == &ThreadPool::get());
+    CHECK(ThreadPool::get().size() >= 1);
+
+    printf("Submitted tasks return their result, or rethrow their exception\n");
+    {
+        std::future<int> result = pool.submit([]() { return 42; });
+        waitOrExit(result);
+        CHECK(result.get() == 42);
+        std::future<void> error = pool.submit([]() { throw std::runtime_error("task"); });
+        waitOrExit(error);
+        CHECK_THROWS(error.get(), std::runtime_error);
+    }
+
+    printf("parallelFor() visits each index once\n");
+    {
+        std::vector<std::atomic<unsigned int>> visits(ITERATIONS);
+        pool.parallelFor(ITERATIONS, [&visits](const size_t i) { ++visits[i]; });
+        CHECK(miscounted(visits) == 0);
+        bool called = false;
+        pool.parallelFor(0, [&called](size_t) { called = true; });
+        CHECK(!called);
+        // A single iteration runs on the calling thread
+        pool.parallelFor(1, [&called](size_t) { called = true; });
+        CHECK(called);
+    }
+
+    printf("parallelFor() rethrows an exception once all iterations have completed\n");
+    {
+        std::vector<std::atomic<unsigned int>> visits(ITERATIONS);
+        CHECK_THROWS(pool.parallelFor(ITERATIONS, [&visits](const size_t i) {
+            ++visits[i];
+            if (i == 7)
+                throw std::runtime_error("iteration");
+        }), std::runtime_error);
+        CHECK(miscounted(visits) == 0);
+    }
+
+    printf("parallelFor() may be called from tasks on the same pool\n");
+    {
+        const unsigned int TASKS = 16;
+        std::vector<std::vector<std::atomic<unsigned int>>> visits;
+        for (unsigned int t = 0; t < TASKS; ++t)
+            visits.emplace_back(ITERATIONS);
+        std::vector<std::future<void>> tasks;
+        for (unsigned int t = 0; t < TASKS; ++t) {
+            tasks.push_back(pool.submit([&pool, &v = visits[t]]() {
+                pool.parallelFor(ITERATIONS, [&v](const size_t i) { ++v[i]; });
+            }));
+        }
+        for (unsigned int t = 0; t < TASKS; ++t) {
+            waitOrExit(tasks[t]);
+            tasks[t].get();
+            CHECK(miscounted(visits[t]) == 0);
+        }
+    }
+    return CHECK_RESULT();
+}